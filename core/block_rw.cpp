@@ -506,58 +506,107 @@ namespace beam
 
 	bool RecoveryInfo::IParser::Context::ProceedShielded()
 	{
-		TxoID nOuts = 0;
+		// The records are read in portions, so that the parser may recognize all the outputs of a portion at once
+		const size_t nPortion = 1024;
 
-		while (true)
+		struct Record
 		{
-			Height h;
-			m_Der & h;
+			Height m_Height;
+			uint8_t m_Flags;
+			ShieldedTxo m_Txo;
+			Merkle::Hash m_hvMsg;
+			ECC::Point m_SpendPk;
+			uint64_t m_Pos;
+		};
 
-			if (MaxHeight == h)
-				break;
+		std::vector<Record> vRecs(nPortion); // reused
+		size_t nRecs = 0;
 
-			uint8_t nFlags = 0;
-			m_Der & nFlags;
+		std::vector<const ShieldedTxo*> vOuts;
+		vOuts.reserve(nPortion);
 
-			Merkle::Hash hv;
+		TxoID nOuts = 0;
+
+		for (bool bEnd = false; !bEnd; )
+		{
+			nRecs = 0;
+			vOuts.clear();
 
-			if (Flags::Output & nFlags)
+			while (nRecs < nPortion)
 			{
-				ShieldedTxo txo;
-				m_Der & txo;
-				m_Der & hv;
+				Height h;
+				m_Der & h;
+
+				if (MaxHeight == h)
+				{
+					bEnd = true;
+					break;
+				}
 
-				assert(!txo.m_pAsset); // the asset proof itself is omitted.
-				if (Flags::HadAsset & nFlags)
-					txo.m_pAsset.reset(new Asset::Proof);
+				Record& r = vRecs[nRecs++];
+				r.m_Height = h;
 
-				ShieldedTxo::DescriptionOutp dOutp;
-				dOutp.m_Commitment = txo.m_Commitment;
-				dOutp.m_SerialPub = txo.m_Ticket.m_SerialPub;
-				dOutp.m_ID = nOuts++;
-				dOutp.m_Height = h;
+				r.m_Flags = 0;
+				m_Der & r.m_Flags;
 
-				if (!m_Parser.OnShieldedOut(dOutp, txo, hv))
-					return false;
+				if (Flags::Output & r.m_Flags)
+				{
+					r.m_Txo.m_pAsset.reset();
+					m_Der & r.m_Txo;
+					m_Der & r.m_hvMsg;
 
-				dOutp.get_Hash(hv);
+					assert(!r.m_Txo.m_pAsset); // the asset proof itself is omitted.
+					if (Flags::HadAsset & r.m_Flags)
+						r.m_Txo.m_pAsset.reset(new Asset::Proof);
+				}
+				else
+					m_Der & r.m_SpendPk;
+
+				r.m_Pos = m_Total - m_Stream.get_Remaining();
 			}
-			else
+
+			for (size_t i = 0; i < nRecs; i++)
+				if (Flags::Output & vRecs[i].m_Flags)
+					vOuts.push_back(&vRecs[i].m_Txo);
+
+			if (!vOuts.empty())
+				m_Parser.OnShieldedOutBatch(&vOuts.front(), static_cast<uint32_t>(vOuts.size()));
+
+			for (size_t i = 0; i < nRecs; i++)
 			{
-				ShieldedTxo::DescriptionInp dInp;
-				m_Der & dInp.m_SpendPk;
-				dInp.m_Height = h;
+				const Record& r = vRecs[i];
+				Merkle::Hash hv;
 
-				if (!m_Parser.OnShieldedIn(dInp))
-					return false;
+				if (Flags::Output & r.m_Flags)
+				{
+					ShieldedTxo::DescriptionOutp dOutp;
+					dOutp.m_Commitment = r.m_Txo.m_Commitment;
+					dOutp.m_SerialPub = r.m_Txo.m_Ticket.m_SerialPub;
+					dOutp.m_ID = nOuts++;
+					dOutp.m_Height = r.m_Height;
 
-				dInp.get_Hash(hv);
-			}
+					if (!m_Parser.OnShieldedOut(dOutp, r.m_Txo, r.m_hvMsg))
+						return false;
 
-			m_Shielded.Append(hv);
+					dOutp.get_Hash(hv);
+				}
+				else
+				{
+					ShieldedTxo::DescriptionInp dInp;
+					dInp.m_SpendPk = r.m_SpendPk;
+					dInp.m_Height = r.m_Height;
 
-			if (!OnProgress())
-				return false;
+					if (!m_Parser.OnShieldedIn(dInp))
+						return false;
+
+					dInp.get_Hash(hv);
+				}
+
+				m_Shielded.Append(hv);
+
+				if (!m_Parser.OnProgress(r.m_Pos, m_Total))
+					return false;
+			}
 		}
 
 		return true;
@@ -613,8 +662,45 @@ namespace beam
 		return true;
 	}
 
+	void RecoveryInfo::IRecognizer::OnShieldedOutBatch(const ShieldedTxo* const* ppTxo, uint32_t nCount)
+	{
+		m_vScannedTxo.clear();
+		m_iScanned = 0;
+
+		if (m_vSh.empty())
+			return;
+
+		m_vScannedTxo.assign(ppTxo, ppTxo + nCount);
+		m_vScanned.resize(nCount);
+
+		std::vector<const ShieldedTxo::Ticket*> vTickets(nCount);
+		for (uint32_t i = 0; i < nCount; i++)
+			vTickets[i] = &ppTxo[i]->m_Ticket;
+
+		ShieldedTxo::Data::TicketParams::Scanner::Scan(&m_vScanned.front(), &vTickets.front(), nCount, &m_vSh.front(), static_cast<uint32_t>(m_vSh.size()));
+	}
+
 	bool RecoveryInfo::IRecognizer::OnShieldedOut(const ShieldedTxo::DescriptionOutp& dout, const ShieldedTxo& txo, const ECC::Hash::Value& hvMsg)
 	{
+		if ((m_iScanned < m_vScannedTxo.size()) && (&txo == m_vScannedTxo[m_iScanned]))
+		{
+			// already scanned
+			const auto& res = m_vScanned[m_iScanned++];
+			if (res.m_iViewer >= m_vSh.size())
+				return true;
+
+			ShieldedTxo::DataParams pars;
+			pars.m_Ticket = res.m_Params;
+
+			ECC::Oracle oracle;
+			oracle << hvMsg;
+
+			if (pars.m_Output.Recover(txo, pars.m_Ticket.m_SharedSecret, oracle))
+				return OnShieldedOutRecognized(dout, pars, res.m_iViewer);
+
+			return true;
+		}
+
 		for (Key::Index nIdx = 0; nIdx < static_cast<Key::Index>(m_vSh.size()); nIdx++)
 		{
 			ShieldedTxo::DataParams pars;
@@ -14,6 +14,7 @@
 
 #pragma once
 #include "block_crypt.h"
+#include "shielded.h"
 #include "radixtree.h"
 
 namespace beam
@@ -64,6 +65,9 @@ namespace beam
 			virtual bool OnShieldedIn(const ShieldedTxo::DescriptionInp&) { return true; }
 			virtual bool OnAsset(Asset::Full&) { return true; }
 
+			// Optional. Called for a portion of shielded outputs before they're passed to OnShieldedOut() one by one, in the same order
+			virtual void OnShieldedOutBatch(const ShieldedTxo* const*, uint32_t nCount) {}
+
 			bool Proceed(const char*);
 
 			struct Context;
@@ -79,11 +83,18 @@ namespace beam
 
 			virtual bool OnUtxo(Height, const Output&) override;
 			virtual bool OnShieldedOut(const ShieldedTxo::DescriptionOutp&, const ShieldedTxo&, const ECC::Hash::Value& hvMsg) override;
+			virtual void OnShieldedOutBatch(const ShieldedTxo* const*, uint32_t nCount) override;
 			virtual bool OnAsset(Asset::Full&) override;
 
 			virtual bool OnUtxoRecognized(Height, const Output&, CoinID&) { return true; }
 			virtual bool OnShieldedOutRecognized(const ShieldedTxo::DescriptionOutp&, const ShieldedTxo::DataParams&, Key::Index) { return true; }
 			virtual bool OnAssetRecognized(Asset::Full&) { return true; }
+
+		private:
+			// tickets of the current portion, recognized at once
+			std::vector<const ShieldedTxo*> m_vScannedTxo;
+			std::vector<ShieldedTxo::Data::TicketParams::Scanner::Result> m_vScanned;
+			size_t m_iScanned = 0;
 		};
 	};
 
@@ -86,8 +86,6 @@ namespace beam
 		// Inputs
 		r.Reset();
 
-		ECC::Point::Native pt;
-
 		for (const Input* pPrev = NULL; r.m_pUtxoIn; pPrev = r.m_pUtxoIn, r.NextUtxoIn())
 		{
 			if (ShouldAbort())
@@ -109,11 +107,10 @@ namespace beam
 						return false; // duplicate!
 				}
 
-				if (!pt.Import(r.m_pUtxoIn->m_Commitment))
+				if (!m_Sigma.ImportAdd(r.m_pUtxoIn->m_Commitment))
 					return false;
 
 				r.m_pUtxoIn->AddStats(m_Stats);
-				m_Sigma += pt;
 			}
 		}
 
@@ -140,8 +137,11 @@ namespace beam
 
 				if (bSigned)
 				{
+					ECC::Point::Native pt;
 					if (!r.m_pUtxoOut->IsValid(m_Height.m_Min, pt))
 						return false;
+
+					m_Sigma += pt;
 				}
 				else
 				{
@@ -149,12 +149,11 @@ namespace beam
 					if (!m_Params.m_bAllowUnsignedOutputs)
 						return false;
 
-					if (!pt.Import(r.m_pUtxoOut->m_Commitment))
+					if (!m_Sigma.ImportAdd(r.m_pUtxoOut->m_Commitment))
 						return false;
 				}
 
 				r.m_pUtxoOut->AddStats(m_Stats);
-				m_Sigma += pt;
 			}
 		}
 
@@ -479,7 +479,7 @@ namespace ECC {
         secp256k1_gej_set_infinity(this);
     }
 
-	bool Point::Native::ImportNnz(const Point& v, Storage* pS /* = nullptr */)
+	bool Point::Native::ImportNnz(secp256k1_ge& ge, const Point& v)
 	{
 		if (v.m_Y > 1)
 			return false; // should always be well-formed
@@ -488,8 +488,13 @@ namespace ECC {
 		if (!secp256k1_fe_set_b32(&nx.V, v.m_X.m_pData))
 			return false;
 
+		return secp256k1_ge_set_xo_var(&ge, &nx.V, v.m_Y) != 0;
+	}
+
+	bool Point::Native::ImportNnz(const Point& v, Storage* pS /* = nullptr */)
+	{
 		NoLeak<secp256k1_ge> ge;
-		if (!secp256k1_ge_set_xo_var(&ge.V, &nx.V, v.m_Y))
+		if (!ImportNnz(ge.V, v))
 			return false;
 
 		secp256k1_gej_set_ge(this, &ge.V);
@@ -522,6 +527,21 @@ namespace ECC {
 		return memis0(&v, sizeof(v));
 	}
 
+	bool Point::Native::ImportAdd(const Point& v)
+	{
+		NoLeak<secp256k1_ge> ge;
+		if (!ImportNnz(ge.V, v))
+			return memis0(&v, sizeof(v));
+
+		// the imported point is affine, use mixed addition
+		if (Mode::Secure == g_Mode)
+			secp256k1_gej_add_ge(this, this, &ge.V);
+		else
+			secp256k1_gej_add_ge_var(this, this, &ge.V, nullptr);
+
+		return true;
+	}
+
 	void Point::Native::ExportNnz(secp256k1_ge& ge) const
 	{
 		NoLeak<secp256k1_gej> dup;
@@ -678,6 +698,20 @@ namespace ECC {
 		secp256k1_ge_to_storage(&ge_s, &ge);
 	}
 
+	void Point::Native::BatchNormalizer::get_As(Point& v, const Point::Native& ptNormalized)
+	{
+		if (ptNormalized.infinity)
+			ZeroObject(v);
+		else
+		{
+			secp256k1_ge ge;
+			get_As(ge, ptNormalized);
+			secp256k1_fe_normalize(&ge.x);
+			secp256k1_fe_normalize(&ge.y);
+			ExportEx(v, ge);
+		}
+	}
+
 	void Point::Native::BatchNormalizer_Arr::get_At(Element& el, uint32_t iIdx)
 	{
 		el.m_pPoint = m_pPts + iIdx;
@@ -1702,8 +1736,32 @@ namespace ECC {
 
 	/////////////////////
 	// Context
+#ifdef BEAM_ECC_CONTEXT_PRECOMPUTED
+
+	// Generated at build time by ecc_context_gen. Intentionally non-const: only the signature configs (pointers) are written at startup,
+	// the rest of the pages remain file-backed and shared between processes.
+	alignas(64) uint8_t g_pContextImage[] = {
+#	include "ecc_context_image.h"
+	};
+
+	static_assert(sizeof(g_pContextImage) == sizeof(Context), "ECC context image mismatch, must be regenerated");
+
+	Context& get_ContextRW()
+	{
+		return *reinterpret_cast<Context*>(g_pContextImage);
+	}
+
+#else // BEAM_ECC_CONTEXT_PRECOMPUTED
+
 	AlignedBuf<Context> g_ContextBuf;
 
+	Context& get_ContextRW()
+	{
+		return g_ContextBuf.get();
+	}
+
+#endif // BEAM_ECC_CONTEXT_PRECOMPUTED
+
 	// Currently - auto-init in global obj c'tor
 	Initializer g_Initializer;
 
@@ -1714,12 +1772,61 @@ namespace ECC {
 	const Context& Context::get()
 	{
 		assert(g_bContextInitialized);
-		return g_ContextBuf.get();
+		return get_ContextRW();
+	}
+
+	void InitializeContextSig(Context& ctx)
+	{
+		ctx.m_Sig.m_GenG.m_pGen = &ctx.G;
+		ctx.m_Sig.m_GenG.m_pGenPrep = &ctx.m_Ipp.G_;
+		ctx.m_Sig.m_GenG.m_nBatchIdx = InnerProduct::BatchContext::s_Idx_G;
+
+		ctx.m_Sig.m_CfgG1.m_nKeys = 1;
+		ctx.m_Sig.m_CfgG1.m_nG = 1;
+		ctx.m_Sig.m_CfgG1.m_pG = &ctx.m_Sig.m_GenG;
+
+		ctx.m_Sig.m_pGenGJ[0] = ctx.m_Sig.m_GenG;
+
+		ctx.m_Sig.m_pGenGJ[1].m_pGen = &ctx.J;
+		ctx.m_Sig.m_pGenGJ[1].m_pGenPrep = &ctx.m_Ipp.J_;
+		ctx.m_Sig.m_pGenGJ[1].m_nBatchIdx = InnerProduct::BatchContext::s_Idx_J;
+
+		ctx.m_Sig.m_pGenGH[0] = ctx.m_Sig.m_GenG;
+
+		ctx.m_Sig.m_pGenGH[1].m_pGen = &ctx.H_Big;
+		ctx.m_Sig.m_pGenGH[1].m_pGenPrep = &ctx.m_Ipp.H_;
+		ctx.m_Sig.m_pGenGH[1].m_nBatchIdx = InnerProduct::BatchContext::s_Idx_H;
+
+		ctx.m_Sig.m_CfgGJ1.m_nKeys = 1;
+		ctx.m_Sig.m_CfgGJ1.m_nG = 2;
+		ctx.m_Sig.m_CfgGJ1.m_pG = ctx.m_Sig.m_pGenGJ;
+
+		ctx.m_Sig.m_CfgG2.m_nKeys = 2;
+		ctx.m_Sig.m_CfgG2.m_nG = 1;
+		ctx.m_Sig.m_CfgG2.m_pG = &ctx.m_Sig.m_GenG;
+
+		ctx.m_Sig.m_CfgGH2.m_nKeys = 2;
+		ctx.m_Sig.m_CfgGH2.m_nG = 2;
+		ctx.m_Sig.m_CfgGH2.m_pG = ctx.m_Sig.m_pGenGH;
 	}
 
+#ifdef BEAM_ECC_CONTEXT_PRECOMPUTED
+
+	void InitializeContext()
+	{
+		// all the generators are already there
+		InitializeContextSig(get_ContextRW());
+
+#ifndef NDEBUG
+		g_bContextInitialized = true;
+#endif // NDEBUG
+	}
+
+#else // BEAM_ECC_CONTEXT_PRECOMPUTED
+
 	void InitializeContext()
 	{
-		Context& ctx = g_ContextBuf.get();
+		Context& ctx = get_ContextRW();
 
 		Mode::Scope scope(Mode::Fast);
 
@@ -1817,43 +1924,15 @@ namespace ECC {
 			<< uint32_t(2) // increment this each time we change signature formula (rangeproof and etc.)
 			>> ctx.m_hvChecksum;
 
-		ctx.m_Sig.m_GenG.m_pGen = &ctx.G;
-		ctx.m_Sig.m_GenG.m_pGenPrep = &ctx.m_Ipp.G_;
-		ctx.m_Sig.m_GenG.m_nBatchIdx = InnerProduct::BatchContext::s_Idx_G;
-
-		ctx.m_Sig.m_CfgG1.m_nKeys = 1;
-		ctx.m_Sig.m_CfgG1.m_nG = 1;
-		ctx.m_Sig.m_CfgG1.m_pG = &ctx.m_Sig.m_GenG;
-
-		ctx.m_Sig.m_pGenGJ[0] = ctx.m_Sig.m_GenG;
-
-		ctx.m_Sig.m_pGenGJ[1].m_pGen = &ctx.J;
-		ctx.m_Sig.m_pGenGJ[1].m_pGenPrep = &ctx.m_Ipp.J_;
-		ctx.m_Sig.m_pGenGJ[1].m_nBatchIdx = InnerProduct::BatchContext::s_Idx_J;
-
-		ctx.m_Sig.m_pGenGH[0] = ctx.m_Sig.m_GenG;
-
-		ctx.m_Sig.m_pGenGH[1].m_pGen = &ctx.H_Big;
-		ctx.m_Sig.m_pGenGH[1].m_pGenPrep = &ctx.m_Ipp.H_;
-		ctx.m_Sig.m_pGenGH[1].m_nBatchIdx = InnerProduct::BatchContext::s_Idx_H;
-
-		ctx.m_Sig.m_CfgGJ1.m_nKeys = 1;
-		ctx.m_Sig.m_CfgGJ1.m_nG = 2;
-		ctx.m_Sig.m_CfgGJ1.m_pG = ctx.m_Sig.m_pGenGJ;
-
-		ctx.m_Sig.m_CfgG2.m_nKeys = 2;
-		ctx.m_Sig.m_CfgG2.m_nG = 1;
-		ctx.m_Sig.m_CfgG2.m_pG = &ctx.m_Sig.m_GenG;
-
-		ctx.m_Sig.m_CfgGH2.m_nKeys = 2;
-		ctx.m_Sig.m_CfgGH2.m_nG = 2;
-		ctx.m_Sig.m_CfgGH2.m_pG = ctx.m_Sig.m_pGenGH;
+		InitializeContextSig(ctx);
 
 #ifndef NDEBUG
 		g_bContextInitialized = true;
 #endif // NDEBUG
 	}
 
+#endif // BEAM_ECC_CONTEXT_PRECOMPUTED
+
 	/////////////////////
 	// Commitment
 	void Commitment::Assign(Point::Native& res, bool bSet) const
@@ -0,0 +1,64 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Build-time tool. Computes the ECC context (generator tables) and writes its binary image as a byte array initializer (bin2h format).
+// Must be built from the same sources and for the same platform as the consumer, since the image is the raw in-memory layout.
+
+#include "ecc_native.h"
+#include <stdio.h>
+#include <vector>
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <output header>\n", argv[0]);
+		return 1;
+	}
+
+	const ECC::Context& ctx = ECC::Context::get(); // initialized by the global initializer
+
+	const uint8_t* pSrc = reinterpret_cast<const uint8_t*>(&ctx);
+	std::vector<uint8_t> vImage(pSrc, pSrc + sizeof(ctx));
+
+	// signature configs consist of pointers into the context itself. They're set at runtime
+	size_t nSigOffset = reinterpret_cast<const uint8_t*>(&ctx.m_Sig) - pSrc;
+	memset(&vImage.front() + nSigOffset, 0, sizeof(ctx.m_Sig));
+
+	FILE* pF = fopen(argv[1], "w");
+	if (!pF)
+	{
+		fprintf(stderr, "Can't create %s\n", argv[1]);
+		return 1;
+	}
+
+	fprintf(pF, "// Generated by ecc_context_gen, don't edit. Context size = %u\n", static_cast<unsigned int>(vImage.size()));
+
+	for (size_t i = 0; i < vImage.size(); i++)
+		fprintf(pF, ((i + 1) % 16) ? "0x%02x, " : "0x%02x,\n", vImage[i]);
+
+	fprintf(pF, "\n");
+
+	bool bOk = !ferror(pF);
+	if (fclose(pF))
+		bOk = false;
+
+	if (!bOk)
+	{
+		fprintf(stderr, "Write error\n");
+		return 1;
+	}
+
+	return 0;
+}
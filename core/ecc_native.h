@@ -140,6 +140,7 @@ namespace ECC
 		Native(const Point&);
 
 		void ExportNnz(secp256k1_ge&) const;
+		static bool ImportNnz(secp256k1_ge&, const Point&);
 
 	public:
 		secp256k1_gej& get_Raw() { return *this; } // use with care
@@ -176,6 +177,7 @@ namespace ECC
 
 		bool ImportNnz(const Point&, Storage* = nullptr); // won't accept zero point, doesn't zero itself in case of failure
 		bool Import(const Point&, Storage* = nullptr);
+		bool ImportAdd(const Point&); // equivalent to Import + operator +=, but cheaper (mixed addition). On failure self is unspecified
 		bool Export(Point&) const; // if the point is zero - returns false and zeroes the result
 
 		static void ExportEx(Point&, const secp256k1_ge&);
@@ -200,6 +202,7 @@ namespace ECC
 
 			static void get_As(secp256k1_ge&, const Point::Native& ptNormalized);
 			static void get_As(secp256k1_ge_storage&, const Point::Native& ptNormalized);
+			static void get_As(Point&, const Point::Native& ptNormalized);
 
 		private:
 			void NormalizeInternal(secp256k1_fe&, bool bNormalize);
@@ -477,7 +480,8 @@ namespace ECC
 			static const uint32_t nLevels = nBits_ / nBitsPerLevel;
 			static_assert(nLevels * nBitsPerLevel == nBits_, "");
 
-			Point::Compact m_pPts[nLevels * nPointsPerLevel];
+			// cache-line aligned, so that each lookup (and each cmov scan in secure mode) touches the minimum number of lines
+			alignas(64) Point::Compact m_pPts[nLevels * nPointsPerLevel];
 		};
 
 		void GeneratePts(const Point::Native&, Oracle&, Point::Compact* pPts, uint32_t nLevels, Point::Compact::Converter&);
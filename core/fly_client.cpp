@@ -928,5 +928,287 @@ void FlyClient::NetworkStd::Connection::OnMsg(EventsSerif&& msg)
     m_This.m_Client.OnEventsSerif(msg.m_Value, msg.m_Height);
 }
 
+/////////////////////////////
+// FlyClientHub
+bool FlyClientHub::History::Enum(IWalker& w, const Height* pBelow)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    return m_pTarget->Enum(w, pBelow);
+}
+
+bool FlyClientHub::History::get_At(Block::SystemState::Full& s, Height h)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    return m_pTarget->get_At(s, h);
+}
+
+void FlyClientHub::History::AddStates(const Block::SystemState::Full* pS, size_t nCount)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    m_pTarget->AddStates(pS, nCount);
+}
+
+void FlyClientHub::History::DeleteFrom(Height h)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    m_pTarget->DeleteFrom(h);
+}
+
+void FlyClientHub::Subscribe(FlyClient& fc)
+{
+    assert(&fc != this);
+
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    if (m_vSubscribers.end() == std::find(m_vSubscribers.begin(), m_vSubscribers.end(), &fc))
+        m_vSubscribers.push_back(&fc);
+}
+
+void FlyClientHub::Unsubscribe(FlyClient& fc)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+
+    auto it = std::find(m_vSubscribers.begin(), m_vSubscribers.end(), &fc);
+    if (m_vSubscribers.end() != it)
+        m_vSubscribers.erase(it);
+
+    if (m_pPrimary == &fc)
+        m_pPrimary = nullptr;
+}
+
+bool FlyClientHub::IsSubscribed(FlyClient& fc)
+{
+    std::unique_lock<std::mutex> scope(m_Mutex);
+    return m_vSubscribers.end() != std::find(m_vSubscribers.begin(), m_vSubscribers.end(), &fc);
+}
+
+template <typename TFunc>
+void FlyClientHub::Notify(TFunc&& func)
+{
+    // subscribers may (un)subscribe from within the callback, the lock is not held during the callback.
+    // Safe only for the (un)subscribing on this thread, see the comment of the hub
+    std::vector<FlyClient*> v;
+    {
+        std::unique_lock<std::mutex> scope(m_Mutex);
+        v = m_vSubscribers;
+    }
+
+    for (FlyClient* pFc : v)
+    {
+        if (IsSubscribed(*pFc))
+            func(*pFc);
+    }
+}
+
+void FlyClientHub::UpdateHistory(FlyClient& fc, bool bRolledBack)
+{
+    Block::SystemState::IHistory& h = fc.get_History();
+    if (&h == &m_History)
+        return; // reads the shared one
+
+    Block::SystemState::Full sTip, sMy;
+    m_History.get_Tip(sTip);
+
+    if (bRolledBack)
+    {
+        h.DeleteFrom(sTip.m_Height + 1);
+        return;
+    }
+
+    if (!sTip.m_Height || (h.get_Tip(sMy) && (sMy == sTip)))
+        return;
+
+    if (sMy.m_Height >= sTip.m_Height)
+        h.DeleteFrom(sTip.m_Height); // was on another branch
+
+    // the tip is verified by the hub connection, the own history keeps the tip only (as if it was a single-step sync)
+    h.AddStates(&sTip, 1);
+}
+
+void FlyClientHub::SyncSubscriber(FlyClient& fc)
+{
+    Block::SystemState::Full sTip;
+    if (m_History.get_Tip(sTip) && IsSubscribed(fc))
+    {
+        UpdateHistory(fc, false);
+        fc.OnNewTip();
+    }
+}
+
+void FlyClientHub::OnNewTip()
+{
+    Notify([this](FlyClient& fc) {
+        UpdateHistory(fc, false);
+        fc.OnNewTip();
+    });
+}
+
+void FlyClientHub::OnTipUnchanged()
+{
+    Notify([](FlyClient& fc) { fc.OnTipUnchanged(); });
+}
+
+void FlyClientHub::OnRolledBack()
+{
+    Notify([this](FlyClient& fc) {
+        UpdateHistory(fc, true);
+        fc.OnRolledBack();
+    });
+}
+
+void FlyClientHub::BbsAdd(BbsChannel ch, Timestamp ts, IBbsReceiver* p)
+{
+    assert(p && m_pNet);
+    bool bSubscribe = false;
+    bool bResend = false;
+    {
+        std::unique_lock<std::mutex> scope(m_Mutex);
+
+        BbsChannelReceivers& x = m_BbsMux.m_Map[ch];
+        bool bNewChannel = x.m_v.empty();
+        bool bNewReceiver = (x.m_v.end() == std::find(x.m_v.begin(), x.m_v.end(), p));
+        if (bNewReceiver)
+            x.m_v.push_back(p);
+
+        if (bNewChannel || (ts < x.m_Time))
+        {
+            x.m_Time = ts; // the earliest wins
+            bSubscribe = true;
+
+            // the network won't fetch the earlier messages for an existing subscription, only resume from them
+            bResend = bNewReceiver && !bNewChannel;
+        }
+    }
+
+    if (bResend)
+        m_pNet->BbsSubscribe(ch, 0, nullptr);
+    if (bSubscribe)
+        m_pNet->BbsSubscribe(ch, ts, &m_BbsMux);
+}
+
+void FlyClientHub::BbsRemove(BbsChannel ch, IBbsReceiver* p)
+{
+    bool bUnsubscribe = false;
+    {
+        std::unique_lock<std::mutex> scope(m_Mutex);
+
+        auto it = m_BbsMux.m_Map.find(ch);
+        if (m_BbsMux.m_Map.end() == it)
+            return;
+
+        auto& v = it->second.m_v;
+        auto itP = std::find(v.begin(), v.end(), p);
+        if (v.end() != itP)
+            v.erase(itP);
+
+        if (v.empty())
+        {
+            m_BbsMux.m_Map.erase(it);
+            bUnsubscribe = true;
+        }
+    }
+
+    if (bUnsubscribe && m_pNet)
+        m_pNet->BbsSubscribe(ch, 0, nullptr);
+}
+
+void FlyClientHub::BbsMux::OnMsg(proto::BbsMsg&& msg)
+{
+    FlyClientHub& hub = get_ParentObj();
+
+    std::vector<IBbsReceiver*> v;
+    {
+        std::unique_lock<std::mutex> scope(hub.m_Mutex);
+        auto it = m_Map.find(msg.m_Channel);
+        if (m_Map.end() != it)
+        {
+            v = it->second.m_v;
+            it->second.m_Time = msg.m_TimePosted; // the network resumes from here, unless a receiver holds it back
+        }
+    }
+
+    for (size_t i = 0; i < v.size(); i++)
+    {
+        {
+            // receivers may be removed from within the callback
+            std::unique_lock<std::mutex> scope(hub.m_Mutex);
+            auto it = m_Map.find(msg.m_Channel);
+            if ((m_Map.end() == it) || (it->second.m_v.end() == std::find(it->second.m_v.begin(), it->second.m_v.end(), v[i])))
+                continue;
+        }
+
+        if (i + 1 == v.size())
+            v[i]->OnMsg(std::move(msg));
+        else
+        {
+            proto::BbsMsg msg2 = msg; // each receiver gets its own copy
+            v[i]->OnMsg(std::move(msg2));
+        }
+    }
+}
+
+FlyClientHub::Network::~Network()
+{
+    for (const auto& x : m_Bbs)
+        m_Hub.BbsRemove(x.first, x.second);
+}
+
+void FlyClientHub::Network::PostRequestInternal(Request& r)
+{
+    assert(m_Hub.m_pNet);
+    m_Hub.m_pNet->PostRequestInternal(r);
+}
+
+void FlyClientHub::Network::BbsSubscribe(BbsChannel ch, Timestamp ts, IBbsReceiver* p)
+{
+    auto it = m_Bbs.find(ch);
+    if (m_Bbs.end() != it)
+    {
+        if (it->second == p)
+        {
+            if (p)
+                m_Hub.BbsAdd(ch, ts, p); // maybe an earlier timestamp
+            return;
+        }
+
+        m_Hub.BbsRemove(ch, it->second);
+        m_Bbs.erase(it);
+    }
+
+    if (p)
+    {
+        m_Bbs[ch] = p;
+        m_Hub.BbsAdd(ch, ts, p);
+    }
+}
+
+void FlyClientHub::get_Kdf(Key::IKdf::Ptr& pKdf)
+{
+    if (m_pPrimary)
+        m_pPrimary->get_Kdf(pKdf);
+}
+
+void FlyClientHub::get_OwnerKdf(Key::IPKdf::Ptr& pKdf)
+{
+    if (m_pPrimary)
+        m_pPrimary->get_OwnerKdf(pKdf);
+}
+
+Block::SystemState::IHistory& FlyClientHub::get_History()
+{
+    return m_History;
+}
+
+void FlyClientHub::OnOwnedNode(const PeerID& pid, bool bUp)
+{
+    if (m_pPrimary)
+        m_pPrimary->OnOwnedNode(pid, bUp);
+}
+
+void FlyClientHub::OnEventsSerif(const ECC::Hash::Value& hv, Height h)
+{
+    if (m_pPrimary)
+        m_pPrimary->OnEventsSerif(hv, h);
+}
+
 } // namespace proto
 } // namespace beam
@@ -18,6 +18,7 @@
 #include <boost/intrusive/set.hpp>
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive_ptr.hpp>
+#include <mutex>
 
 namespace beam {
 namespace proto {
@@ -260,5 +261,104 @@ namespace proto {
 		};
 	};
 
+	// Lets several clients of the same process (wallet, laser, broadcaster, etc.) share one verified chain view.
+	// The hub is the FlyClient of the network, its connections sync the headers once for all the subscribers.
+	// The subscribers post their requests to the same network (via Network), and are notified on the tip changes.
+	// Before the notification the tip is copied to the own history of the subscriber (if it has one), so that
+	// the subscribers that keep their own history (such as the wallet db) don't lag behind.
+	// The notifications are delivered on the thread of the network. The subscribers and their BBS receivers must be
+	// (un)subscribed on that thread as well: a notification in progress isn't waited for, and may still reach
+	// a subscriber unsubscribed on another thread. The mutex only keeps the lists consistent.
+	struct FlyClientHub
+		:public FlyClient
+	{
+		// thread-safe access to the shared chain view. By default the states are kept in memory,
+		// set m_pTarget to use a persistent history (such as the one of the wallet db)
+		struct History
+			:public Block::SystemState::IHistory
+		{
+			std::mutex m_Mutex;
+			Block::SystemState::HistoryMap m_Map;
+			Block::SystemState::IHistory* m_pTarget = &m_Map;
+
+			virtual bool Enum(IWalker&, const Height* pBelow) override;
+			virtual bool get_At(Block::SystemState::Full&, Height) override;
+			virtual void AddStates(const Block::SystemState::Full*, size_t nCount) override;
+			virtual void DeleteFrom(Height) override;
+		} m_History;
+
+		// Optional. Provides the keys for the owned node login, and receives the owned node events.
+		// Should be subscribed as well to receive the tip notifications
+		FlyClient* m_pPrimary = nullptr;
+
+		void Subscribe(FlyClient&);
+		void Unsubscribe(FlyClient&);
+
+		// Brings a subscriber that joined after the hub was synced up to the current tip, and notifies it.
+		// To be called on the thread of the network
+		void SyncSubscriber(FlyClient&);
+
+		// The network the hub is the client of. Must be set before the subscribers' Network objects are used
+		INetwork::Ptr m_pNet;
+
+		// Network of a subscriber. The requests go to the shared network as-is, the BBS subscriptions of all the subscribers
+		// are merged (a channel is subscribed once, with the earliest timestamp), and the messages are delivered to all of them.
+		// Connect/Disconnect are ignored: the shared network is controlled by the owner of the hub
+		struct Network
+			:public INetwork
+		{
+			FlyClientHub& m_Hub;
+
+			Network(FlyClientHub& hub) :m_Hub(hub) {}
+			~Network();
+
+			virtual void Connect() override {}
+			virtual void Disconnect() override {}
+			virtual void PostRequestInternal(Request&) override;
+			virtual void BbsSubscribe(BbsChannel, Timestamp, IBbsReceiver*) override;
+
+		private:
+			std::map<BbsChannel, IBbsReceiver*> m_Bbs;
+		};
+
+		// FlyClient
+		virtual void OnNewTip() override;
+		virtual void OnTipUnchanged() override;
+		virtual void OnRolledBack() override;
+		virtual void get_Kdf(Key::IKdf::Ptr&) override;
+		virtual void get_OwnerKdf(Key::IPKdf::Ptr&) override;
+		virtual Block::SystemState::IHistory& get_History() override;
+		virtual void OnOwnedNode(const PeerID&, bool bUp) override;
+		virtual void OnEventsSerif(const ECC::Hash::Value&, Height) override;
+
+	private:
+		std::mutex m_Mutex; // protects the subscribers and the BBS receivers
+		std::vector<FlyClient*> m_vSubscribers;
+
+		struct BbsChannelReceivers
+		{
+			std::vector<IBbsReceiver*> m_v;
+			Timestamp m_Time = 0; // the network resumes from it
+		};
+
+		struct BbsMux
+			:public IBbsReceiver
+		{
+			std::map<BbsChannel, BbsChannelReceivers> m_Map;
+
+			virtual void OnMsg(proto::BbsMsg&&) override;
+			IMPLEMENT_GET_PARENT_OBJ(FlyClientHub, m_BbsMux)
+		} m_BbsMux;
+
+		void BbsAdd(BbsChannel, Timestamp, IBbsReceiver*);
+		void BbsRemove(BbsChannel, IBbsReceiver*);
+
+		bool IsSubscribed(FlyClient&);
+		void UpdateHistory(FlyClient&, bool bRolledBack);
+
+		template <typename TFunc>
+		void Notify(TFunc&&);
+	};
+
 } // namespace proto
 } // namespace beam
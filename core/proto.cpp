@@ -52,12 +52,17 @@ bool ProtocolPlus::VerifyMsg(const uint8_t* p, uint32_t nSize)
     if (Mode::Duplex != m_Mode)
         return true;
 
+    return VerifyHMac(m_HMac, p, nSize);
+}
+
+bool ProtocolPlus::VerifyHMac(const ECC::Hash::Mac& hmBase, const uint8_t* p, uint32_t nSize)
+{
     MacValue hmac;
 
     if (nSize < hmac.nBytes)
         return false; // could happen on (sort of) overflow attack?
 
-    ECC::Hash::Mac hm = m_HMac;
+    ECC::Hash::Mac hm = hmBase;
     hm.Write(p, nSize - hmac.nBytes);
 
     get_HMac(hm, hmac);
@@ -65,6 +70,30 @@ bool ProtocolPlus::VerifyMsg(const uint8_t* p, uint32_t nSize)
     return !memcmp(p + nSize - hmac.nBytes, hmac.m_pData, hmac.nBytes);
 }
 
+ProtocolPlus::ShardIn::ShardIn(const ProtocolPlus& src)
+    :ShardProtocol(src)
+    ,m_Enc(src.m_Enc)
+    ,m_CipherIn(src.m_CipherIn)
+    ,m_HMac(src.m_HMac)
+{
+    assert(Mode::Duplex == src.m_Mode);
+}
+
+void ProtocolPlus::ShardIn::Decrypt(uint8_t* p, uint32_t nSize)
+{
+    m_CipherIn.XCrypt(m_Enc, p, nSize);
+}
+
+uint32_t ProtocolPlus::ShardIn::get_MacSize()
+{
+    return sizeof(uint64_t);
+}
+
+bool ProtocolPlus::ShardIn::VerifyMsg(const uint8_t* p, uint32_t nSize)
+{
+    return VerifyHMac(m_HMac, p, nSize);
+}
+
 void ProtocolPlus::get_HMac(ECC::Hash::Mac& hm, MacValue& res)
 {
     ECC::Hash::Value hv;
@@ -139,6 +168,39 @@ void ProtocolPlus::Encrypt(SerializedMsg& sm, MsgSerializer& ser)
     }
 }
 
+void ProtocolPlus::EncryptShared(io::SharedBuffer& res, const io::SharedBuffer& frame)
+{
+    assert(frame.size >= MsgHeader::SIZE + MacValue::nBytes);
+
+    size_t n = frame.size - MacValue::nBytes;
+    size_t nOut = (Mode::Plaintext == m_Mode) ? n : frame.size;
+
+    auto p = io::alloc_heap(nOut);
+    uint8_t* pDst = p.first;
+    memcpy(pDst, frame.data, n);
+
+    if (Mode::Plaintext == m_Mode)
+    {
+        // no mac, fix the size
+        MsgHeader hdr(pDst);
+        hdr.size -= MacValue::nBytes;
+        hdr.write(pDst);
+    }
+    else
+    {
+        ECC::Hash::Mac hm = m_HMac;
+        hm.Write(pDst, (uint32_t) n);
+
+        MacValue hmac;
+        get_HMac(hm, hmac);
+        memcpy(pDst + n, hmac.m_pData, hmac.nBytes);
+
+        m_CipherOut.XCrypt(m_Enc, pDst, (uint32_t) nOut);
+    }
+
+    res.assign(pDst, nOut, std::move(p.second));
+}
+
 void InitCipherIV(AES::StreamCipher& c, const ECC::Hash::Value& hvSecret, const ECC::Hash::Value& hvParam)
 {
     ECC::NoLeak<ECC::Hash::Value> hvIV;
@@ -321,6 +383,8 @@ void NodeConnection::Reset()
 
 	m_RulesCfgSent = false;
     m_Connection = NULL;
+    m_pShardedConnection = NULL;
+    m_pShardTimer = NULL;
     m_pAsyncFail = NULL;
 
     m_Protocol.ResetVars();
@@ -370,7 +434,7 @@ void NodeConnection::OnConnectInternal(uint64_t tag, io::TcpStream::Ptr&& newStr
 
 void NodeConnection::OnConnectInternal2(io::TcpStream::Ptr&& newStream, io::ErrorCode status)
 {
-    assert(!m_Connection && m_ConnectPending);
+    assert(!m_Connection && !m_pShardedConnection && m_ConnectPending);
     m_ConnectPending = false;
 
     if (newStream)
@@ -419,9 +483,36 @@ void NodeConnection::OnIoErr(io::ErrorCode err)
 
 size_t NodeConnection::get_Unsent() const
 {
+	if (m_pShardedConnection)
+		return m_pShardedConnection->get_Unsent();
+
 	return m_Connection ? m_Connection->get_Unsent() : 0;
 }
 
+io::Result NodeConnection::WriteMsg(const SerializedMsg& sm)
+{
+    if (m_pShardedConnection)
+        return m_pShardedConnection->write_msg(sm);
+
+    return m_Connection->write_msg(sm);
+}
+
+io::Result NodeConnection::WriteMsg(const io::SharedBuffer& buf)
+{
+    if (m_pShardedConnection)
+        return m_pShardedConnection->write_msg(buf);
+
+    return m_Connection->write_msg(buf);
+}
+
+io::Address NodeConnection::get_PeerAddress() const
+{
+    if (m_pShardedConnection)
+        return m_pShardedConnection->peer_address();
+
+    return m_Connection ? m_Connection->peer_address() : io::Address();
+}
+
 void NodeConnection::on_protocol_error(uint64_t, ProtocolError error)
 {
     Reset();
@@ -475,7 +566,7 @@ void NodeConnection::ThrowUnexpected(const char* sz, NodeProcessingException::Ty
 
 void NodeConnection::Connect(const io::Address& addr, const boost::optional<io::Address> proxyAddr)
 {
-    assert(!m_Connection && !m_ConnectPending);
+    assert(!m_Connection && !m_pShardedConnection && !m_ConnectPending);
 
     io::Result res;
     if (proxyAddr)
@@ -500,7 +591,7 @@ void NodeConnection::Connect(const io::Address& addr, const boost::optional<io::
 
 void NodeConnection::Accept(io::TcpStream::Ptr&& newStream)
 {
-    assert(!m_Connection && !m_ConnectPending);
+    assert(!m_Connection && !m_pShardedConnection && !m_ConnectPending);
 
     newStream->enable_keepalive(Rules::get().DA.Target_s); // it should be comparable to the block rate
 
@@ -515,7 +606,7 @@ void NodeConnection::Accept(io::TcpStream::Ptr&& newStream)
 
 bool NodeConnection::IsLive() const
 {
-    return m_Connection && !m_pAsyncFail;
+    return (m_Connection || m_pShardedConnection) && !m_pAsyncFail;
 }
 
 #define THE_MACRO(code, msg) \
@@ -526,7 +617,7 @@ void NodeConnection::Send(const msg& v) \
     m_SerializeCache.clear(); \
     MsgSerializer& ser = m_Protocol.serializeNoFinalize(m_SerializeCache, uint8_t(code), v); \
     m_Protocol.Encrypt(m_SerializeCache, ser); \
-    io::Result res = m_Connection->write_msg(m_SerializeCache); \
+    io::Result res = WriteMsg(m_SerializeCache); \
     m_SerializeCache.clear(); \
 \
     TestIoResultAsync(res); \
@@ -551,6 +642,30 @@ bool NodeConnection::OnMsgInternal(uint64_t, msg##_NoInit&& v) \
 BeamNodeMsgsAll(THE_MACRO)
 #undef THE_MACRO
 
+#define THE_MACRO(code, msg) \
+void NodeConnection::SerializeShared(io::SharedBuffer& res, const msg& v) \
+{ \
+    m_Protocol.SerializeShared(res, uint8_t(code), v); \
+}
+
+BeamNodeMsgsAll(THE_MACRO)
+#undef THE_MACRO
+
+size_t NodeConnection::SendShared(const io::SharedBuffer& frame)
+{
+    if (!IsLive())
+        return 0;
+
+    io::SharedBuffer buf;
+    m_Protocol.EncryptShared(buf, frame);
+    io::Result res = WriteMsg(buf);
+
+    TestIoResultAsync(res);
+    TestNotDrown();
+
+    return buf.size;
+}
+
 void NodeConnection::TestInputMsgContext(uint8_t code)
 {
     if (!IsSecureIn())
@@ -725,7 +840,7 @@ void NodeConnection::OnMsg(Login&& msg)
 
                 Height hScheme = pFork[1].m_Height;
 
-                LOG_WARNING() << "Peer " << m_Connection->peer_address() << " incompatible with HF " << (nMyFork + 1) << ", Height=" << hScheme;
+                LOG_WARNING() << "Peer " << get_PeerAddress() << " incompatible with HF " << (nMyFork + 1) << ", Height=" << hScheme;
 
                 Height hMinScheme = get_MinPeerFork();
                 if (hMinScheme >= hScheme)
@@ -734,7 +849,7 @@ void NodeConnection::OnMsg(Login&& msg)
 
             if (i + 1 != msg.m_Cfgs.size())
             {
-                LOG_WARNING() << "Peer " << m_Connection->peer_address() << " has unknown fork: " << msg.m_Cfgs[i + 1];
+                LOG_WARNING() << "Peer " << get_PeerAddress() << " has unknown fork: " << msg.m_Cfgs[i + 1];
             }
 
 			OnLoginInternal(std::move(msg));
@@ -763,7 +878,7 @@ void NodeConnection::OnLoginInternal(Login&& msg)
     if (LoginFlags::Extension::Maximum != nExt)
     {
         bool bNewer = (nExt > LoginFlags::Extension::Maximum);
-        LOG_WARNING() << "Peer " << m_Connection->peer_address() << " uses " << (bNewer ? "newer" : "older") << " ext: " << nExt;
+        LOG_WARNING() << "Peer " << get_PeerAddress() << " uses " << (bNewer ? "newer" : "older") << " ext: " << nExt;
 
         if (nExt < LoginFlags::Extension::Minimum)
             ThrowUnexpected("Legacy", NodeProcessingException::Type::Incompatible);
@@ -778,6 +893,33 @@ void NodeConnection::OnMsg(SChannelReady&& msg)
         ThrowUnexpected();
 
     m_Protocol.m_Mode = ProtocolPlus::Mode::Duplex;
+
+    if (m_pIoShards && m_pIoShards->size() && m_Connection)
+    {
+        // Move to the I/O thread once the current data is processed. The cipher won't change anymore
+        m_pShardTimer = io::Timer::create(io::Reactor::get_Current());
+        m_pShardTimer->start(0, false, [this]() { OnShardTimer(); });
+    }
+}
+
+void NodeConnection::OnShardTimer()
+{
+    if (!m_Connection || m_pAsyncFail)
+        return;
+
+    m_pShardedConnection = ShardedConnection::create(*m_pIoShards, *m_Connection, m_Protocol, *this, std::make_unique<ProtocolPlus::ShardIn>(m_Protocol));
+    if (m_pShardedConnection)
+    {
+        m_Connection = NULL;
+        m_pShardTimer = NULL;
+    }
+    else
+    {
+        if (m_Connection->get_Unsent())
+            m_pShardTimer->start(10, false, [this]() { OnShardTimer(); }); // retry when the pending data is sent
+        else
+            m_pShardTimer = NULL; // not supported
+    }
 }
 
 void NodeConnection::ProveID(ECC::Scalar::Native& sk, uint8_t nIDType)
@@ -19,6 +19,7 @@
 #include "../utility/bridge.h"
 #include "../p2p/protocol.h"
 #include "../p2p/connection.h"
+#include "../p2p/sharded_connection.h"
 #include "../utility/io/tcpserver.h"
 #include "../utility/io/timer.h"
 #include "aes.h"
@@ -607,7 +608,41 @@ namespace proto {
         virtual uint32_t get_MacSize() override;
         virtual bool VerifyMsg(const uint8_t*, uint32_t nSize) override;
 
+        static bool VerifyHMac(const ECC::Hash::Mac&, const uint8_t*, uint32_t nSize);
+
         void Encrypt(SerializedMsg&, MsgSerializer&);
+
+        // Incoming side of the established (duplex) channel, for the I/O thread. Has its own copy of the cipher state
+        struct ShardIn
+            :public ShardProtocol
+        {
+            AES::Encoder m_Enc;
+            AES::StreamCipher m_CipherIn;
+            ECC::Hash::Mac m_HMac;
+
+            ShardIn(const ProtocolPlus&);
+
+            virtual void Decrypt(uint8_t*, uint32_t nSize) override;
+            virtual uint32_t get_MacSize() override;
+            virtual bool VerifyMsg(const uint8_t*, uint32_t nSize) override;
+        };
+
+        // Broadcast support. The frame is serialized once (with the mac placeholder), the source is not modified.
+        // Each peer makes its own copy, with its own mac and encryption
+        template <typename TMsg>
+        void SerializeShared(io::SharedBuffer& res, MsgType type, const TMsg& msg)
+        {
+            SerializedMsg sm;
+            MsgSerializer& ser = serializeNoFinalize(sm, type, msg);
+
+            MacValue hmac = Zero;
+            ser & hmac;
+            ser.finalize(sm);
+
+            res = io::normalize(sm, true);
+        }
+
+        void EncryptShared(io::SharedBuffer& res, const io::SharedBuffer& frame);
     };
 
     struct INodeMsgHandler
@@ -651,6 +686,8 @@ namespace proto {
     {
         ProtocolPlus m_Protocol;
         std::unique_ptr<Connection> m_Connection;
+        ShardedConnection::Ptr m_pShardedConnection; // replaces m_Connection once moved to the I/O thread
+        io::Timer::Ptr m_pShardTimer;
         io::AsyncEvent::Ptr m_pAsyncFail;
         bool m_ConnectPending;
 		bool m_RulesCfgSent;
@@ -660,6 +697,11 @@ namespace proto {
         void TestIoResultAsync(const io::Result& res);
         void TestInputMsgContext(uint8_t);
 
+        io::Result WriteMsg(const SerializedMsg&);
+        io::Result WriteMsg(const io::SharedBuffer&);
+        io::Address get_PeerAddress() const;
+        void OnShardTimer();
+
         static void OnConnectInternal(uint64_t tag, io::TcpStream::Ptr&& newStream, io::ErrorCode);
         void OnConnectInternal2(io::TcpStream::Ptr&& newStream, io::ErrorCode);
 
@@ -766,6 +808,10 @@ namespace proto {
 		size_t m_UnsentHiMark = 0;
 		void TestNotDrown();
 
+		// If set - the connection is moved to one of the I/O threads once the secure channel is established.
+		// Must outlive the connection
+		IoShards* m_pIoShards = nullptr;
+
         void OnIoErr(io::ErrorCode);
         void OnExc(const std::exception&);
         void OnProcessingExc(const NodeProcessingException& exception);
@@ -774,6 +820,13 @@ namespace proto {
         BeamNodeMsgsAll(THE_MACRO)
 #undef THE_MACRO
 
+        // Serialize-once broadcast
+#define THE_MACRO(code, msg) void SerializeShared(io::SharedBuffer&, const msg& v);
+        BeamNodeMsgsAll(THE_MACRO)
+#undef THE_MACRO
+
+        size_t SendShared(const io::SharedBuffer&); // returns the num of bytes sent (0 if not live)
+
         struct Server
         {
             io::TcpServer::Ptr m_pServer; // just delete it to stop listening
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include "shielded.h"
+#include "../utility/executor.h"
 
 namespace beam
 {
@@ -267,7 +268,15 @@ namespace beam
 		if (!(pt == s.m_Signature.m_NoncePub))
 			return false;
 
+		return RecoverKeys(s, v, pN);
+	}
+
+	bool ShieldedTxo::Data::TicketParams::RecoverKeys(const Ticket& s, const Viewer& v, const ECC::Scalar::Native* pN)
+	{
 		// there's a match with high probability. Reverse-engineer the keys
+		ECC::Hash::Value hv;
+		ECC::Scalar::Native k;
+
 		s.get_Hash(hv);
 		s.m_Signature.get_Challenge(k, hv);
 		k.Inv();
@@ -302,6 +311,160 @@ namespace beam
 
 	}
 
+	/////////////
+	// TicketParams::Scanner
+	struct ShieldedTxo::Data::TicketParams::Scanner::Batch
+	{
+		Result* m_pRes;
+		const Ticket* const* m_ppT;
+		const Viewer* m_pV;
+		uint32_t m_Viewers;
+
+		ECC::Point::Native::BatchNormalizer_Arr_T<s_Batch> m_Norm;
+
+		struct Slot
+		{
+			uint32_t m_iTicket;
+			uint32_t m_iViewer;
+			ECC::Hash::Value m_SharedSecret;
+			ECC::Scalar::Native m_pN[2];
+		};
+
+		Slot m_pSlot[s_Batch];
+
+		Batch()
+		{
+			m_Norm.m_Size = 0;
+		}
+
+		void Add(const ECC::Point::Native& ptSerial, const ECC::Hash::Value& hvDH, uint32_t iTicket, uint32_t iViewer)
+		{
+			if (s_Batch == m_Norm.m_Size)
+				Flush();
+
+			Slot& x = m_pSlot[m_Norm.m_Size];
+			x.m_iTicket = iTicket;
+			x.m_iViewer = iViewer;
+
+			ECC::Scalar::Native k;
+			m_pV[iViewer].m_pGen->DeriveKey(k, hvDH);
+
+			m_Norm.m_pPts[m_Norm.m_Size++] = ptSerial * k; // shared point
+		}
+
+		void Flush()
+		{
+			const uint32_t n = m_Norm.m_Size;
+			if (!n)
+				return;
+
+			m_Norm.Normalize();
+
+			TicketParams tp;
+			for (uint32_t i = 0; i < n; i++)
+			{
+				Slot& x = m_pSlot[i];
+
+				ECC::Point pt;
+				ECC::Point::Native::BatchNormalizer::get_As(pt, m_Norm.m_pPts[i]);
+				HashTxt("sp-sec") << pt >> tp.m_SharedSecret; // same as set_SharedSecret()
+				x.m_SharedSecret = tp.m_SharedSecret;
+
+				tp.get_Nonces(*m_pV[x.m_iViewer].m_pGen, x.m_pN);
+				DoubleBlindedCommitment(m_Norm.m_pPts[i], x.m_pN);
+			}
+
+			m_Norm.Normalize();
+
+			for (uint32_t i = 0; i < n; i++)
+			{
+				const Slot& x = m_pSlot[i];
+				Result& res = m_pRes[x.m_iTicket];
+				if (res.m_iViewer != m_Viewers)
+					continue; // already recognized
+
+				const Ticket& t = *m_ppT[x.m_iTicket];
+
+				ECC::Point pt;
+				ECC::Point::Native::BatchNormalizer::get_As(pt, m_Norm.m_pPts[i]);
+				if (pt != t.m_Signature.m_NoncePub)
+					continue;
+
+				res.m_Params.m_SharedSecret = x.m_SharedSecret;
+				if (res.m_Params.RecoverKeys(t, m_pV[x.m_iViewer], x.m_pN))
+					res.m_iViewer = x.m_iViewer;
+			}
+
+			m_Norm.m_Size = 0;
+		}
+	};
+
+	void ShieldedTxo::Data::TicketParams::Scanner::ScanPart(Result* pRes, const Ticket* const* ppT, uint32_t nCount, const Viewer* pV, uint32_t nViewers)
+	{
+		ECC::Mode::Scope scope(ECC::Mode::Fast);
+
+		Batch b;
+		b.m_pRes = pRes;
+		b.m_ppT = ppT;
+		b.m_pV = pV;
+		b.m_Viewers = nViewers;
+
+		for (uint32_t iTicket = 0; iTicket < nCount; iTicket++)
+		{
+			pRes[iTicket].m_iViewer = nViewers;
+
+			const Ticket& t = *ppT[iTicket];
+
+			ECC::Point::Native ptSerial;
+			if (!ptSerial.Import(t.m_SerialPub))
+				continue;
+
+			ECC::Hash::Value hvDH;
+			get_DH(hvDH, t.m_SerialPub);
+
+			for (uint32_t iViewer = 0; iViewer < nViewers; iViewer++)
+				b.Add(ptSerial, hvDH, iTicket, iViewer);
+		}
+
+		b.Flush();
+	}
+
+	void ShieldedTxo::Data::TicketParams::Scanner::Scan(Result* pRes, const Ticket* const* ppT, uint32_t nCount, const Viewer* pV, uint32_t nViewers)
+	{
+		struct MyTask
+			:public Executor::TaskSync
+		{
+			Result* m_pRes;
+			const Ticket* const* m_ppT;
+			uint32_t m_Count;
+			const Viewer* m_pV;
+			uint32_t m_Viewers;
+
+			virtual void Exec(Executor::Context& ctx) override
+			{
+				uint32_t i0, nCount;
+				ctx.get_Portion(i0, nCount, m_Count);
+
+				if (nCount)
+					ScanPart(m_pRes + i0, m_ppT + i0, nCount, m_pV, m_Viewers);
+			}
+		};
+
+		if (Executor::s_pInstance && (nCount > 1))
+		{
+			MyTask t;
+			t.m_pRes = pRes;
+			t.m_ppT = ppT;
+			t.m_Count = nCount;
+			t.m_pV = pV;
+			t.m_Viewers = nViewers;
+
+			Executor::s_pInstance->ExecAll(t);
+		}
+		else
+			ScanPart(pRes, ppT, nCount, pV, nViewers);
+	}
+
 	/////////////
 	// OutputParams
 	void ShieldedTxo::Data::OutputParams::get_Seed(ECC::uintBig& res, const ECC::Hash::Value& hvShared, const ECC::Oracle& oracle)
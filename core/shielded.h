@@ -57,7 +57,10 @@ namespace beam
 
 			void Restore(const Viewer&); // must set kG and m_IsCreatedByViewer before calling
 
+			struct Scanner;
+
 		protected:
+			bool RecoverKeys(const Ticket&, const Viewer&, const ECC::Scalar::Native* pN); // after the nonces match
 			void GenerateInternal(Ticket&, const ECC::Hash::Value& nonce, Key::IPKdf& gen, Key::IKdf* pGenPriv, Key::IPKdf& ser);
 			void set_FromkG(Key::IPKdf& gen, Key::IKdf* pGenPriv, Key::IPKdf& ser);
 			void set_SharedSecretFromKs(ECC::Point& ptSerialPub, Key::IPKdf& gen);
@@ -103,6 +106,25 @@ namespace beam
 		struct HashTxt;
 	};
 
+	// Recognizes many tickets at once, each is tested against all the viewers.
+	// The shared points and the nonce commitments are exported in batches (single inversion per batch),
+	// and the tickets are split among the Executor threads, if there's one in the scope.
+	struct ShieldedTxo::Data::TicketParams::Scanner
+	{
+		struct Result
+		{
+			uint32_t m_iViewer; // equals to the number of viewers if not recognized
+			TicketParams m_Params;
+		};
+
+		static void Scan(Result*, const Ticket* const*, uint32_t nCount, const Viewer*, uint32_t nViewers);
+
+	private:
+		static const uint32_t s_Batch = 64;
+		struct Batch;
+		static void ScanPart(Result*, const Ticket* const*, uint32_t nCount, const Viewer*, uint32_t nViewers);
+	};
+
 	struct ShieldedTxo::DataParams :public ShieldedTxo::Data::Params {};
 
 } // namespace beam
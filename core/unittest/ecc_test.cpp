@@ -330,8 +330,23 @@ void TestPoints()
 
 		p2_ = p0;
 		verify_test(p_ == p2_);
+
+		// import with mixed addition
+		p1 = -p0;
+		verify_test(p1.ImportAdd(p_));
+		verify_test(p1 == Zero);
+		verify_test(p1.ImportAdd(p_));
+		verify_test(p1 == p0);
 	}
 
+	p_.m_X = Zero;
+	p_.m_Y = 0;
+	verify_test(p1.ImportAdd(p_)); // zero point
+	verify_test(p1 == p0);
+
+	p_.m_Y = 2;
+	verify_test(!p1.ImportAdd(p_)); // ill-formed
+
     // substraction
     {
         Point::Native pointNative;
@@ -1531,6 +1546,99 @@ void TestBbs()
 	verify_test(!beam::proto::Bbs::Decrypt(p, n, privateAddr));
 }
 
+struct DummyErrorHandler
+	:public beam::IErrorHandler
+{
+	void on_protocol_error(uint64_t, beam::ProtocolError) override {}
+	void on_connection_error(uint64_t, beam::io::ErrorCode) override {}
+};
+
+void TestSharedFrame()
+{
+	using namespace beam;
+
+	DummyErrorHandler eh;
+
+	// the broadcaster has a separate channel with each peer
+	const uint32_t nPeers = 2;
+	std::unique_ptr<proto::ProtocolPlus> pOut[nPeers], pIn[nPeers];
+
+	for (uint32_t i = 0; i < nPeers; i++)
+	{
+		pOut[i] = std::make_unique<proto::ProtocolPlus>('B', 'm', 10, 100, eh, 20000);
+		pIn[i] = std::make_unique<proto::ProtocolPlus>('B', 'm', 10, 100, eh, 20000);
+
+		SetRandom(pOut[i]->m_MyNonce);
+		SetRandom(pIn[i]->m_MyNonce);
+		pOut[i]->m_RemoteNonce.FromSk(pIn[i]->m_MyNonce);
+		pIn[i]->m_RemoteNonce.FromSk(pOut[i]->m_MyNonce);
+
+		pOut[i]->InitCipher();
+		pIn[i]->InitCipher();
+		pOut[i]->m_Mode = proto::ProtocolPlus::Mode::Duplex;
+		pIn[i]->m_Mode = proto::ProtocolPlus::Mode::Duplex;
+	}
+
+	proto::NewTip msg;
+	ZeroObject(msg.m_Description);
+	msg.m_Description.m_Height = 125;
+	msg.m_Description.m_TimeStamp = 11;
+
+	io::SharedBuffer frame;
+	pOut[0]->SerializeShared(frame, proto::NewTip::s_Code, msg);
+	ByteBuffer bufOrg(frame.data, frame.data + frame.size);
+
+	ByteBuffer pEnc[nPeers];
+	for (uint32_t i = 0; i < nPeers; i++)
+	{
+		io::SharedBuffer res;
+		pOut[i]->EncryptShared(res, frame);
+		verify_test(res.size == frame.size);
+		pEnc[i].assign(res.data, res.data + res.size);
+
+		// the source frame is not modified
+		verify_test(!memcmp(frame.data, &bufOrg.front(), frame.size));
+	}
+
+	verify_test(pEnc[0] != pEnc[1]);
+
+	for (uint32_t i = 0; i < nPeers; i++)
+	{
+		uint8_t* p = &pEnc[i].front();
+		uint32_t n = (uint32_t) pEnc[i].size();
+
+		// decrypted in one go, since the cipher is a stream
+		pIn[i]->Decrypt(p, n);
+		verify_test(pIn[i]->VerifyMsg(p, n));
+
+		// everything but the mac is the original frame
+		uint32_t nMac = pIn[i]->get_MacSize();
+		verify_test(nMac == proto::ProtocolPlus::MacValue::nBytes);
+		verify_test(!memcmp(p, &bufOrg.front(), n - nMac));
+
+		// the wrong peer can't decrypt it
+		uint8_t* p2 = &pEnc[!i].front();
+		ByteBuffer buf2(p2, p2 + n);
+		proto::ProtocolPlus& inWrong = *pIn[i];
+		inWrong.InitCipher(); // reset the cipher state
+		inWrong.Decrypt(&buf2.front(), n);
+		verify_test(!inWrong.VerifyMsg(&buf2.front(), n));
+	}
+
+	// plaintext peer: no mac, the size is fixed
+	{
+		proto::ProtocolPlus pp('B', 'm', 10, 100, eh, 20000);
+		io::SharedBuffer res;
+		pp.EncryptShared(res, frame);
+		verify_test(res.size == frame.size - proto::ProtocolPlus::MacValue::nBytes);
+		verify_test(!memcmp(res.data + MsgHeader::SIZE, &bufOrg.front() + MsgHeader::SIZE, res.size - MsgHeader::SIZE));
+
+		MsgHeader hdr(res.data);
+		verify_test(hdr.size == res.size - MsgHeader::SIZE);
+		verify_test(hdr.type == proto::NewTip::s_Code);
+	}
+}
+
 void TestRatio(const beam::Difficulty& d0, const beam::Difficulty& d1, double k)
 {
 	const double tol = 1.000001;
@@ -2033,6 +2141,85 @@ void TestLelantusKeys()
 	}
 }
 
+void TestShieldedScanner()
+{
+	// batch recognition must agree with the one-by-one recognition
+	Key::IKdf::Ptr pMaster, pForeign;
+	SetRandom(pMaster);
+	SetRandom(pForeign);
+
+	const uint32_t nViewers = 3;
+	beam::ShieldedTxo::Viewer pViewer[nViewers + 1]; // the last one is foreign
+	for (uint32_t i = 0; i < nViewers; i++)
+		pViewer[i].FromOwner(*pMaster, i);
+	pViewer[nViewers].FromOwner(*pForeign, 0);
+
+	const uint32_t nCount = 150; // more than a single batch
+	std::vector<beam::ShieldedTxo::Ticket> vTickets(nCount);
+	std::vector<const beam::ShieldedTxo::Ticket*> vPtrs(nCount);
+	std::vector<uint32_t> vOwner(nCount);
+
+	for (uint32_t i = 0; i < nCount; i++)
+	{
+		vOwner[i] = i % (nViewers + 1);
+		const beam::ShieldedTxo::Viewer& v = pViewer[vOwner[i]];
+
+		Hash::Value nonce;
+		SetRandom(nonce);
+
+		beam::ShieldedTxo::Data::TicketParams tp;
+		if (1 & (i >> 2))
+			tp.Generate(vTickets[i], v, nonce);
+		else
+		{
+			beam::ShieldedTxo::PublicGen gen;
+			gen.FromViewer(v);
+			tp.Generate(vTickets[i], gen, nonce);
+		}
+
+		vPtrs[i] = &vTickets[i];
+	}
+
+	vTickets[1].m_Signature.m_NoncePub.m_X.Inc(); // spoil it
+	vOwner[1] = nViewers;
+
+	for (uint32_t iCycle = 0; iCycle < 2; iCycle++)
+	{
+		beam::ExecutorMT ex;
+		ex.set_Threads(3);
+
+		std::unique_ptr<beam::Executor::Scope> pScope;
+		if (iCycle)
+			pScope = std::make_unique<beam::Executor::Scope>(ex);
+
+		std::vector<beam::ShieldedTxo::Data::TicketParams::Scanner::Result> vRes(nCount);
+		beam::ShieldedTxo::Data::TicketParams::Scanner::Scan(&vRes.front(), &vPtrs.front(), nCount, pViewer, nViewers);
+
+		for (uint32_t i = 0; i < nCount; i++)
+		{
+			const beam::ShieldedTxo::Data::TicketParams::Scanner::Result& res = vRes[i];
+			verify_test(res.m_iViewer == vOwner[i]);
+
+			for (uint32_t iViewer = 0; iViewer < nViewers; iViewer++)
+			{
+				beam::ShieldedTxo::Data::TicketParams tp;
+				bool bRecognized = tp.Recover(vTickets[i], pViewer[iViewer]);
+				verify_test(bRecognized == (iViewer == res.m_iViewer));
+
+				if (bRecognized)
+				{
+					verify_test(tp.m_SharedSecret == res.m_Params.m_SharedSecret);
+					verify_test(tp.m_SerialPreimage == res.m_Params.m_SerialPreimage);
+					verify_test(tp.m_SpendPk == res.m_Params.m_SpendPk);
+					verify_test(tp.m_IsCreatedByViewer == res.m_Params.m_IsCreatedByViewer);
+					verify_test(tp.m_pK[0] == res.m_Params.m_pK[0]);
+					verify_test(tp.m_pK[1] == res.m_Params.m_pK[1]);
+				}
+			}
+		}
+	}
+}
+
 void TestAssetProof()
 {
 	Scalar::Native sk;
@@ -2137,6 +2324,7 @@ void TestAll()
 	TestAES();
 	TestKdf();
 	TestBbs();
+	TestSharedFrame();
 	TestDifficulty();
 	TestProtoVer();
 	TestRandom();
@@ -2147,6 +2335,7 @@ void TestAll()
 	TestLelantus(false);
 	TestLelantus(true);
 	TestLelantusKeys();
+	TestShieldedScanner();
 }
 
 
@@ -2580,6 +2769,113 @@ void RunBenchmark()
 		} while (bm.ShouldContinue());
 	}
 
+	{
+		HKdf kdf;
+		uintBig seed;
+		SetRandom(seed);
+		kdf.Generate(seed);
+
+		CoinID cid(23110, 1, Key::Type::Regular);
+
+		for (uint32_t iMode = 0; iMode < 2; iMode++)
+		{
+			// Secure mode is the default for the wallet. Fast mode is applicable only when the secret keys are not at risk (i.e. treasury generation on an isolated machine)
+			Mode::Scope scope(iMode ? Mode::Fast : Mode::Secure);
+
+			BenchmarkMeter bm(iMode ? "Output.Create.Fast" : "Output.Create");
+			bm.N = 10;
+			do
+			{
+				for (uint32_t i = 0; i < bm.N; i++)
+				{
+					beam::Output outp;
+					outp.Create(g_hFork, k1, kdf, cid, kdf);
+					cid.m_Idx++;
+				}
+
+			} while (bm.ShouldContinue());
+		}
+	}
+
+	{
+		// Shielded outputs recognition. Per a block of foreign outputs (the common case during the rescan), tested against several viewers
+		Key::IKdf::Ptr pMaster, pForeign;
+		SetRandom(pMaster);
+		SetRandom(pForeign);
+
+		const uint32_t nViewers = 4;
+		beam::ShieldedTxo::Viewer pViewer[nViewers];
+		for (uint32_t i = 0; i < nViewers; i++)
+			pViewer[i].FromOwner(*pMaster, i);
+
+		beam::ShieldedTxo::Viewer viewerForeign;
+		viewerForeign.FromOwner(*pForeign, 0);
+
+		beam::ShieldedTxo::PublicGen gen;
+		gen.FromViewer(viewerForeign);
+
+		const uint32_t nCount = 64;
+		beam::ShieldedTxo::Ticket pTicket[nCount];
+		const beam::ShieldedTxo::Ticket* ppTicket[nCount];
+
+		for (uint32_t i = 0; i < nCount; i++)
+		{
+			Hash::Value nonce;
+			SetRandom(nonce);
+
+			beam::ShieldedTxo::Data::TicketParams tp;
+			tp.Generate(pTicket[i], gen, nonce);
+			ppTicket[i] = pTicket + i;
+		}
+
+		{
+			BenchmarkMeter bm("Shielded.Recover.64x4");
+			bm.N = 1;
+			do
+			{
+				for (uint32_t i = 0; i < bm.N; i++)
+				{
+					for (uint32_t iTicket = 0; iTicket < nCount; iTicket++)
+					{
+						for (uint32_t iViewer = 0; iViewer < nViewers; iViewer++)
+						{
+							beam::ShieldedTxo::Data::TicketParams tp;
+							tp.Recover(pTicket[iTicket], pViewer[iViewer]);
+						}
+					}
+				}
+
+			} while (bm.ShouldContinue());
+		}
+
+		beam::ShieldedTxo::Data::TicketParams::Scanner::Result pRes[nCount];
+
+		{
+			BenchmarkMeter bm("Shielded.Scan.64x4");
+			bm.N = 1;
+			do
+			{
+				for (uint32_t i = 0; i < bm.N; i++)
+					beam::ShieldedTxo::Data::TicketParams::Scanner::Scan(pRes, ppTicket, nCount, pViewer, nViewers);
+
+			} while (bm.ShouldContinue());
+		}
+
+		{
+			beam::ExecutorMT ex;
+			beam::Executor::Scope scope(ex);
+
+			BenchmarkMeter bm("Shielded.Scan.MT.64x4");
+			bm.N = 1;
+			do
+			{
+				for (uint32_t i = 0; i < bm.N; i++)
+					beam::ShieldedTxo::Data::TicketParams::Scanner::Scan(pRes, ppTicket, nCount, pViewer, nViewers);
+
+			} while (bm.ShouldContinue());
+		}
+	}
+
 	{
 		AES::Encoder enc;
 		enc.Init(hv.m_pData);
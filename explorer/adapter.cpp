@@ -13,11 +13,12 @@
 // limitations under the License.
 
 #include "adapter.h"
+#include "index.h"
 #include "node/node.h"
 #include "core/serialization_adapters.h"
 #include "http/http_msg_creator.h"
-#include "http/http_json_serializer.h"
-#include "nlohmann/json.hpp"
+#include "utility/io/json_writer.h"
+#include "utility/io/timer.h"
 #include "utility/helpers.h"
 #include "utility/logger.h"
 
@@ -27,6 +28,8 @@ namespace {
 
 static const size_t PACKER_FRAGMENTS_SIZE = 4096;
 static const size_t CACHE_DEPTH = 100000;
+static const uint32_t INDEX_BATCH = 100;
+static const unsigned INDEX_RETRY_MS = 1000; // when the next block can't be indexed yet
 
 const char* hash_to_hex(char* buf, const Merkle::Hash& hash) {
     return to_hex(buf, hash.m_pData, hash.nBytes);
@@ -88,14 +91,12 @@ private:
     size_t _depth;
 };
 
-using nlohmann::json;
-
 } //namespace
 
 /// Explorer server backend, gets callback on status update and returns json messages for server
 class Adapter : public Node::IObserver, public IAdapter {
 public:
-    Adapter(Node& node) :
+    Adapter(Node& node, const std::string& indexPath) :
         _packer(PACKER_FRAGMENTS_SIZE),
 		_node(node),
         _nodeBackend(node.get_Processor()),
@@ -103,6 +104,11 @@ public:
         _nodeIsSyncing(true),
         _cache(CACHE_DEPTH)
     {
+        if (!indexPath.empty()) {
+            _index = std::make_unique<BlockIndex>(indexPath);
+            _indexTimer = io::Timer::create(io::Reactor::get_Current());
+        }
+
         init_helper_fragments();
         _hook = &node.m_Cfg.m_Observer;
         _nextHook = *_hook;
@@ -145,6 +151,7 @@ private:
         const auto& cursor = _nodeBackend.m_Cursor;
         _cache.currentHeight = cursor.m_Sid.m_Height;
         _statusDirty = true;
+        schedule_indexing();
         if (_nextHook) _nextHook->OnStateChanged();
     }
 
@@ -154,9 +161,146 @@ private:
 
         blocks.erase(blocks.lower_bound(id.m_Height), blocks.end());
 
+        if (_index) {
+            try {
+                _index->rollback(id.m_Height);
+            } catch (const std::exception& e) {
+                LOG_ERROR() << "explorer index: " << e.what();
+            }
+        }
+
         if (_nextHook) _nextHook->OnRolledBack(id);
     }
 
+    void schedule_indexing(unsigned delayMs = 0) {
+        if (_index && !_indexScheduled) {
+            _indexScheduled = true;
+            _indexTimer->start(delayMs, false, BIND_THIS_MEMFN(index_blocks));
+        }
+    }
+
+    /// Adds the blocks up to the cursor to the index, a batch per reactor cycle
+    void index_blocks() {
+        _indexScheduled = false;
+
+        Height top = _nodeBackend.m_Cursor.m_Sid.m_Height;
+        Height prevTop = 0;
+        try {
+            if (!_indexVerified) {
+                verify_index();
+                _indexVerified = true;
+            }
+
+            prevTop = _index->get_top();
+            if (prevTop >= top) {
+                return;
+            }
+
+            BlockIndex::Transaction tx(*_index);
+            for (uint32_t i = 0; (i < INDEX_BATCH) && (_index->get_top() < top); i++) {
+                if (!index_block(_index->get_top() + 1)) {
+                    break;
+                }
+            }
+            tx.commit();
+        } catch (const std::exception& e) {
+            // retried on the next state change
+            LOG_ERROR() << "explorer index: " << e.what();
+            return;
+        }
+
+        if (_index->get_top() < top) {
+            // don't spin on the reactor if the next block couldn't be indexed
+            schedule_indexing((_index->get_top() > prevTop) ? 0 : INDEX_RETRY_MS);
+        }
+    }
+
+    bool index_block(Height height) {
+        uint64_t row = 0;
+        if (!extract_row(height, row, 0)) {
+            return false;
+        }
+
+        BlockIndex::Keys keys;
+        io::SharedBuffer body;
+
+        _sm.clear();
+        if (write_json(_sm, [&](io::JsonWriter& w) { return extract_block_from_row(w, row, height, &keys); })) {
+            body = io::normalize(_sm, false);
+        } else {
+            // no body, the height is still indexed to keep the index contiguous
+            keys.hash = get_hash(row);
+        }
+        _sm.clear();
+
+        _index->add_block(keys, body);
+        return true;
+    }
+
+    Merkle::Hash get_hash(uint64_t row) {
+        Block::SystemState::Full s;
+        _nodeBackend.get_DB().get_State(row, s);
+
+        Block::SystemState::ID id;
+        s.get_ID(id);
+        return id.m_Hash;
+    }
+
+    /// The index may be ahead of the node or left from another chain, only the part matching the node is kept
+    void verify_index() {
+        _index->rollback(std::min(_index->get_top(), _nodeBackend.m_Cursor.m_Sid.m_Height));
+
+        // the heights up to the fork point match
+        Height lo = 0;
+        Height hi = _index->get_top();
+        while (lo < hi) {
+            Height mid = lo + (hi - lo + 1) / 2;
+            if (index_matches(mid)) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        if (lo < _index->get_top()) {
+            LOG_INFO() << "Explorer index rolled back to " << lo;
+            _index->rollback(lo);
+        }
+    }
+
+    bool index_matches(Height height) {
+        Merkle::Hash hash;
+        uint64_t row = 0;
+        return _index->get_hash(height, hash) && extract_row(height, row, 0) && (get_hash(row) == hash);
+    }
+
+    bool get_indexed_block(io::SerializedMsg& out, Height height) {
+        io::SharedBuffer body;
+        if (!_index || (height > _index->get_top()) || !_index->get_block(height, body)) {
+            return false;
+        }
+        out.push_back(body);
+        return true;
+    }
+
+    /// Renders the message by fn, directly into out. fn may return false if nothing is written
+    template <typename Fn> bool write_json(io::SerializedMsg& out, Fn&& fn) {
+        io::JsonWriter w(_packer.acquire_writer(out));
+
+        bool ok = true;
+        if constexpr (std::is_same_v<decltype(fn(w)), bool>) {
+            ok = fn(w);
+        } else {
+            fn(w);
+        }
+
+        if (ok) {
+            w.finalize();
+        }
+        _packer.release_writer();
+        return ok;
+    }
+
     bool get_status(io::SerializedMsg& out) override {
         if (_statusDirty) {
             const auto& cursor = _nodeBackend.m_Cursor;
@@ -166,20 +310,20 @@ private:
             char buf[80];
 
             _sm.clear();
-            if (!serialize_json_msg(
-                _sm,
-                _packer,
-                json{
-                    { "timestamp", cursor.m_Full.m_TimeStamp },
-                    { "height", _cache.currentHeight },
-                    { "low_horizon", _nodeBackend.m_Extra.m_TxoHi },
-                    { "hash", hash_to_hex(buf, cursor.m_ID.m_Hash) },
-                    { "chainwork",  uint256_to_hex(buf, cursor.m_Full.m_ChainWork) },
-                    { "peers_count", _node.get_AcessiblePeerCount() }
-                }
-            )) {
-                return false;
-            }
+            write_json(_sm, [&](io::JsonWriter& w) {
+                w.begin_object()
+                    .member("chainwork", uint256_to_hex(buf, cursor.m_Full.m_ChainWork))
+                    .member("hash", hash_to_hex(buf, cursor.m_ID.m_Hash))
+                    .member("height", _cache.currentHeight)
+                    .member("low_horizon", _nodeBackend.m_Extra.m_TxoHi)
+                    .member("peers_count", _node.get_AcessiblePeerCount())
+                    .member("broadcast_bytes_serialized", _node.m_BroadcastStats.m_BytesSerialized)
+                    .member("broadcast_bytes_sent", _node.m_BroadcastStats.m_BytesSent)
+                    .member("body_cache_size", _node.m_BodyCache.m_TotalSize)
+                    .member("body_cache_hit_rate", _node.m_BodyCache.get_HitRate())
+                    .member("timestamp", cursor.m_Full.m_TimeStamp)
+                .end_object();
+            });
 
             _cache.status = io::normalize(_sm, false);
             _statusDirty = false;
@@ -379,7 +523,8 @@ private:
     };
 
 
-    bool extract_block_from_row(json& out, uint64_t row, Height height) {
+    /// Writes the block right away, without building the json document
+    bool extract_block_from_row(io::JsonWriter& w, uint64_t row, Height height, BlockIndex::Keys* keys = 0) {
         NodeDB& db = _nodeBackend.get_DB();
 
         Block::SystemState::Full blockState;
@@ -407,7 +552,39 @@ private:
 
             assert(block.m_vInputs.size() == vOutsIn.size());
 
-            json inputs = json::array();
+            // members are sorted by name, as in the responses rendered by nlohmann::json
+            w.begin_object();
+
+            w.key("assets").begin_array();
+            Asset::Full ai;
+            for (ai.m_ID = 1; ; ai.m_ID++)
+            {
+                int ret = _nodeBackend.get_AssetAt(ai, height);
+                if (!ret)
+                    break;
+
+                if (ret > 0)
+                {
+                    w.begin_object()
+                        .member("id", ai.m_ID)
+                        .member("lock_height", ai.m_LockHeight)
+                        .member("metadata", ExtraInfo::get(ai.m_Metadata))
+                        .member("metahash", hash_to_hex(buf, ai.m_Metadata.m_Hash))
+                        .member("owner", hash_to_hex(buf, ai.m_Owner))
+                        .member("value_hi", AmountBig::get_Hi(ai.m_Value))
+                        .member("value_lo", AmountBig::get_Lo(ai.m_Value))
+                    .end_object();
+                }
+            }
+            w.end_array();
+
+            w.member("chainwork", uint256_to_hex(buf, blockState.m_ChainWork))
+                .member("difficulty", blockState.m_PoW.m_Difficulty.ToFloat())
+                .member("found", true)
+                .member("hash", hash_to_hex(buf, id.m_Hash))
+                .member("height", blockState.m_Height);
+
+            w.key("inputs").begin_array();
             for (size_t i = 0; i < block.m_vInputs.size(); i++)
             {
                 const Input& inp = *block.m_vInputs[i];
@@ -416,87 +593,64 @@ private:
 
                 Height hCreate = inp.m_Internal.m_Maturity - outp.get_MinMaturity(0);
 
-                inputs.push_back(
-                json{
-                    {"commitment", uint256_to_hex(buf, outp.m_Commitment.m_X)},
-                    {"height",   hCreate},
-                    {"extra",  ExtraInfo::get(outp, hCreate, inp.m_Internal.m_Maturity)}
-                }
-                );
+                w.begin_object()
+                    .member("commitment", uint256_to_hex(buf, outp.m_Commitment.m_X))
+                    .member("extra", ExtraInfo::get(outp, hCreate, inp.m_Internal.m_Maturity))
+                    .member("height", hCreate)
+                .end_object();
             }
+            w.end_array();
 
-            json outputs = json::array();
-            for (const auto &v : block.m_vOutputs) {
-                outputs.push_back(
-                json{
-                    {"commitment", uint256_to_hex(buf, v->m_Commitment.m_X)},
-                    {"extra",  ExtraInfo::get(*v, height, v->get_MinMaturity(height))}
-                }
-                );
-            }
-
-            json kernels = json::array();
+            w.key("kernels").begin_array();
             for (const auto &v : block.m_vKernels) {
 
                 Amount fee = 0;
                 std::string sExtra = ExtraInfo::get(*v, fee);
 
-                kernels.push_back(
-                    json{
-                        {"id", hash_to_hex(buf, v->m_Internal.m_ID)},
-                        {"minHeight", v->m_Height.m_Min},
-                        {"maxHeight", v->m_Height.m_Max},
-                        {"fee", fee},
-                        {"extra",  sExtra}
-                    }
-                );
+                w.begin_object()
+                    .member("extra", sExtra)
+                    .member("fee", fee)
+                    .member("id", hash_to_hex(buf, v->m_Internal.m_ID))
+                    .member("maxHeight", v->m_Height.m_Max)
+                    .member("minHeight", v->m_Height.m_Min)
+                .end_object();
             }
+            w.end_array();
 
-            json assets = json::array();
-            Asset::Full ai;
-            for (ai.m_ID = 1; ; ai.m_ID++)
-            {
-                int ret = _nodeBackend.get_AssetAt(ai, height);
-                if (!ret)
-                    break;
+            w.key("outputs").begin_array();
+            for (const auto &v : block.m_vOutputs) {
+                w.begin_object()
+                    .member("commitment", uint256_to_hex(buf, v->m_Commitment.m_X))
+                    .member("extra", ExtraInfo::get(*v, height, v->get_MinMaturity(height)))
+                .end_object();
+            }
+            w.end_array();
 
-                if (ret > 0)
-                {
-                    assets.push_back(
-                        json{
-                            {"id", ai.m_ID},
-                            {"metadata", ExtraInfo::get(ai.m_Metadata)},
-                            {"metahash", hash_to_hex(buf, ai.m_Metadata.m_Hash)},
-                            {"owner", hash_to_hex(buf, ai.m_Owner)},
-                            {"value_lo", AmountBig::get_Lo(ai.m_Value)},
-                            {"value_hi", AmountBig::get_Hi(ai.m_Value)},
-                            {"lock_height",  ai.m_LockHeight}
-                        }
-                    );
+            w.member("prev", hash_to_hex(buf, blockState.m_Prev))
+                .member("subsidy", Rules::get_Emission(blockState.m_Height))
+                .member("timestamp", blockState.m_TimeStamp);
+
+            w.end_object();
+
+            if (keys) {
+                keys->hash = id.m_Hash;
+
+                for (const auto &v : block.m_vKernels) {
+                    keys->kernels.push_back(v->m_Internal.m_ID);
+                }
+
+                for (const auto &v : block.m_vOutputs) {
+                    keys->commitments.push_back(v->m_Commitment.m_X);
                 }
             }
 
-            out = json{
-                {"found",      true},
-                {"timestamp",  blockState.m_TimeStamp},
-                {"height",     blockState.m_Height},
-                {"hash",       hash_to_hex(buf, id.m_Hash)},
-                {"prev",       hash_to_hex(buf, blockState.m_Prev)},
-                {"difficulty", blockState.m_PoW.m_Difficulty.ToFloat()},
-                {"chainwork",  uint256_to_hex(buf, blockState.m_ChainWork)},
-                {"subsidy",    Rules::get_Emission(blockState.m_Height)},
-                {"assets",     assets},
-                {"inputs",     inputs},
-                {"outputs",    outputs},
-                {"kernels",    kernels}
-            };
-
-            LOG_DEBUG() << out;
+            LOG_DEBUG() << "block at " << height << ": " << block.m_vInputs.size() << " inputs, "
+                << block.m_vOutputs.size() << " outputs, " << block.m_vKernels.size() << " kernels";
         }
         return ok;
     }
 
-    bool extract_block(json& out, Height height, uint64_t& row, uint64_t* prevRow) {
+    bool extract_block(io::JsonWriter& w, Height height, uint64_t& row, uint64_t* prevRow) {
         bool ok = true;
         if (row == 0) {
             ok = extract_row(height, row, prevRow);
@@ -506,11 +660,11 @@ private:
                 *prevRow = 0;
             }
         }
-        return ok && extract_block_from_row(out, row, height);
+        return ok && extract_block_from_row(w, row, height);
     }
 
     bool get_block_impl(io::SerializedMsg& out, uint64_t height, uint64_t& row, uint64_t* prevRow) {
-        if (_cache.get_block(out, height)) {
+        if (_cache.get_block(out, height) || get_indexed_block(out, height)) {
             if (prevRow && row > 0) {
                 extract_row(height, row, prevRow);
             }
@@ -525,19 +679,17 @@ private:
         io::SharedBuffer body;
         bool blockAvailable = (height <= _cache.currentHeight);
         if (blockAvailable) {
-            json j;
-            if (!extract_block(j, height, row, prevRow)) {
-                blockAvailable = false;
-            } else {
-                _sm.clear();
-                if (serialize_json_msg(_sm, _packer, j)) {
-                    body = io::normalize(_sm, false);
-                    _cache.put_block(height, body);
-                } else {
-                    return false;
-                }
-                _sm.clear();
+            // nothing is written if the block is not extracted
+            _sm.clear();
+            blockAvailable = write_json(_sm, [&](io::JsonWriter& w) {
+                return extract_block(w, height, row, prevRow);
+            });
+
+            if (blockAvailable) {
+                body = io::normalize(_sm, false);
+                _cache.put_block(height, body);
             }
+            _sm.clear();
         }
 
         if (blockAvailable) {
@@ -545,7 +697,13 @@ private:
             return true;
         }
 
-        return serialize_json_msg(out, _packer, json{ { "found", false}, {"height", height } });
+        write_json(out, [height](io::JsonWriter& w) {
+            w.begin_object()
+                .member("found", false)
+                .member("height", height)
+            .end_object();
+        });
+        return true;
     }
 
     bool get_block(io::SerializedMsg& out, uint64_t height) override {
@@ -563,9 +721,17 @@ private:
     }
 
     bool get_block_by_kernel(io::SerializedMsg& out, const ByteBuffer& key) override {
-        NodeDB& db = _nodeBackend.get_DB();
+        Height height = _index ? _index->find_kernel(key) : 0;
+        if (!height) {
+            height = _nodeBackend.get_DB().FindKernel(key);
+        }
 
-        Height height = db.FindKernel(key);
+        uint64_t row = 0;
+        return get_block_impl(out, height, row, 0);
+    }
+
+    bool get_block_by_commitment(io::SerializedMsg& out, const ByteBuffer& commitment) override {
+        Height height = _index ? _index->find_commitment(commitment) : 0;
         uint64_t row = 0;
 
         return get_block_impl(out, height, row, 0);
@@ -642,11 +808,17 @@ private:
 
     ResponseCache _cache;
 
+    // on-disk index, optional
+    std::unique_ptr<BlockIndex> _index;
+    io::Timer::Ptr _indexTimer;
+    bool _indexScheduled=false;
+    bool _indexVerified=false;
+
     io::SerializedMsg _sm;
 };
 
-IAdapter::Ptr create_adapter(Node& node) {
-    return IAdapter::Ptr(new Adapter(node));
+IAdapter::Ptr create_adapter(Node& node, const std::string& indexPath) {
+    return IAdapter::Ptr(new Adapter(node, indexPath));
 }
 
 }} //namespaces
@@ -36,11 +36,15 @@ struct IAdapter {
 
     virtual bool get_block_by_kernel(io::SerializedMsg& out, const ByteBuffer& key) = 0;
 
+    /// Block which created the output, by X of the commitment. Looked up in the index only
+    virtual bool get_block_by_commitment(io::SerializedMsg& out, const ByteBuffer& commitment) = 0;
+
     virtual bool get_blocks(io::SerializedMsg& out, uint64_t startHeight, uint64_t n) = 0;
 
     virtual bool get_peers(io::SerializedMsg& out) = 0;
 };
 
-IAdapter::Ptr create_adapter(Node& node);
+/// The rendered blocks are indexed on disk if indexPath is not empty
+IAdapter::Ptr create_adapter(Node& node, const std::string& indexPath = std::string());
 
 }} //namespaces
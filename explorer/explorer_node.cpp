@@ -22,9 +22,11 @@ using namespace std;
 #define LOG_FILES_DIR "logs"
 #define FILES_PREFIX "explorer-node"
 #define API_PORT_PARAMETER "api_port"
+#define INDEX_PATH_PARAMETER "index_path"
 
 struct Options {
     std::string nodeDbFilename;
+    std::string indexFilename;
     std::string accessControlFile;
     std::string nodeConnectTo;
     io::Address nodeListenTo;
@@ -61,7 +63,7 @@ int main(int argc, char* argv[]) {
 
         Node node;
         setup_node(node, options);
-        explorer::IAdapter::Ptr adapter = explorer::create_adapter(node);
+        explorer::IAdapter::Ptr adapter = explorer::create_adapter(node, options.indexFilename);
         node.Initialize();
         explorer::Server server(*adapter, *reactor, options.explorerListenTo, options.accessControlFile, options.whitelist);
         LOG_INFO() << "Node listens to " << options.nodeListenTo << ", explorer listens to " << options.explorerListenTo;
@@ -89,6 +91,7 @@ bool parse_cmdline(int argc, char* argv[], Options& o) {
         (cli::NODE_PEER, po::value<string>()->default_value("eu-node03.masternet.beam.mw:8100"), "peer address")
         (cli::PORT_FULL, po::value<uint16_t>()->default_value(10000), "port to start the local node on")
         (API_PORT_PARAMETER, po::value<uint16_t>()->default_value(8888), "port to start the local api server on")
+        (INDEX_PATH_PARAMETER, po::value<string>()->default_value(FILES_PREFIX "-index.db"), "path to the index of the rendered blocks, kernels and commitments, empty to disable")
         (cli::KEY_OWNER, po::value<string>()->default_value(""), "owner viewer key")
         (cli::PASS, po::value<string>()->default_value(""), "password for owner key")
         (cli::IP_WHITELIST, po::value<std::string>()->default_value(""), "IP whitelist")
@@ -125,6 +128,7 @@ bool parse_cmdline(int argc, char* argv[], Options& o) {
 
         o.logCleanupPeriod = vm[cli::LOG_CLEANUP_DAYS].as<uint32_t>() * 24 * 3600;
         o.nodeDbFilename = FILES_PREFIX ".db";
+        o.indexFilename = vm[INDEX_PATH_PARAMETER].as<string>();
         //o.accessControlFile = "api.keys";
 
         o.nodeConnectTo = vm[cli::NODE_PEER].as<string>();
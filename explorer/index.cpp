@@ -0,0 +1,272 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "index.h"
+#include "utility/logger.h"
+#include "sqlite/sqlite3.h"
+
+namespace beam { namespace explorer {
+
+namespace {
+
+// Bumped on the scheme or rendering changes, the index is rebuilt then
+static const int INDEX_VERSION = 1;
+
+enum Queries {
+    Q_TOP, Q_HASH, Q_BLOCK, Q_KERNEL_FIND, Q_COMMITMENT_FIND,
+    Q_BLOCK_ADD, Q_KERNEL_ADD, Q_COMMITMENT_ADD,
+    Q_BLOCK_DEL, Q_KERNEL_DEL, Q_COMMITMENT_DEL,
+    Q_COUNT
+};
+
+} //namespace
+
+/// Prepared statement, reset after use
+class BlockIndex::Statement {
+public:
+    Statement(BlockIndex& index, Queries q, const char* sql) :
+        _index(index),
+        _stmt(index.get_statement(q, sql))
+    {}
+
+    ~Statement() {
+        sqlite3_reset(_stmt);
+        sqlite3_clear_bindings(_stmt);
+    }
+
+    void put(int col, uint64_t n) {
+        _index.test_ret(sqlite3_bind_int64(_stmt, col + 1, (sqlite3_int64) n));
+    }
+
+    void put(int col, const void* p, size_t size) {
+        _index.test_ret(sqlite3_bind_blob(_stmt, col + 1, p, (int) size, SQLITE_STATIC));
+    }
+
+    bool step() {
+        int ret = sqlite3_step(_stmt);
+        if (ret == SQLITE_ROW) return true;
+        if (ret != SQLITE_DONE) _index.test_ret(ret);
+        return false;
+    }
+
+    uint64_t get_int(int col) {
+        return (uint64_t) sqlite3_column_int64(_stmt, col);
+    }
+
+    Blob get_blob(int col) {
+        return Blob(sqlite3_column_blob(_stmt, col), (uint32_t) sqlite3_column_bytes(_stmt, col));
+    }
+
+private:
+    BlockIndex& _index;
+    sqlite3_stmt* _stmt;
+};
+
+BlockIndex::BlockIndex(const std::string& path) :
+    _statements(Q_COUNT, nullptr)
+{
+    int ret = sqlite3_open_v2(path.c_str(), &_db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX | SQLITE_OPEN_CREATE, NULL);
+    if (ret != SQLITE_OK) {
+        sqlite3_close(_db);
+        throw std::runtime_error("cannot open explorer index " + path);
+    }
+
+    try {
+        // the index can be rebuilt from the node
+        exec("PRAGMA synchronous = NORMAL");
+        exec("PRAGMA locking_mode = EXCLUSIVE");
+
+        int version = 0;
+        {
+            sqlite3_stmt* stmt = 0;
+            test_ret(sqlite3_prepare_v2(_db, "PRAGMA user_version", -1, &stmt, 0));
+            if (sqlite3_step(stmt) == SQLITE_ROW) version = sqlite3_column_int(stmt, 0);
+            sqlite3_finalize(stmt);
+        }
+
+        if (version != INDEX_VERSION) {
+            if (version) {
+                LOG_INFO() << "Explorer index version " << version << ", rebuilding";
+            }
+            exec("DROP TABLE IF EXISTS blocks");
+            exec("DROP TABLE IF EXISTS kernels");
+            exec("DROP TABLE IF EXISTS commitments");
+        }
+
+        exec("CREATE TABLE IF NOT EXISTS blocks (height INTEGER PRIMARY KEY, hash BLOB NOT NULL, body BLOB)");
+        exec("CREATE TABLE IF NOT EXISTS kernels (id BLOB NOT NULL, height INTEGER NOT NULL)");
+        exec("CREATE INDEX IF NOT EXISTS idx_kernels_id ON kernels (id, height)");
+        exec("CREATE INDEX IF NOT EXISTS idx_kernels_height ON kernels (height)");
+        exec("CREATE TABLE IF NOT EXISTS commitments (x BLOB NOT NULL, height INTEGER NOT NULL)");
+        exec("CREATE INDEX IF NOT EXISTS idx_commitments_x ON commitments (x, height)");
+        exec("CREATE INDEX IF NOT EXISTS idx_commitments_height ON commitments (height)");
+
+        if (version != INDEX_VERSION) {
+            exec(("PRAGMA user_version = " + std::to_string(INDEX_VERSION)).c_str());
+        }
+
+        Statement s(*this, Q_TOP, "SELECT MAX(height) FROM blocks");
+        if (s.step()) _top = s.get_int(0);
+    } catch (...) {
+        close();
+        throw;
+    }
+
+    LOG_INFO() << "Explorer index " << path << ", top height " << _top;
+}
+
+BlockIndex::~BlockIndex() {
+    close();
+}
+
+void BlockIndex::close() {
+    for (auto& stmt : _statements) {
+        if (stmt) {
+            sqlite3_finalize(stmt);
+            stmt = 0;
+        }
+    }
+    if (_db) {
+        sqlite3_close(_db);
+        _db = 0;
+    }
+}
+
+void BlockIndex::exec(const char* sql) {
+    test_ret(sqlite3_exec(_db, sql, NULL, NULL, NULL));
+}
+
+void BlockIndex::test_ret(int ret) {
+    if (ret != SQLITE_OK) {
+        throw std::runtime_error(std::string("explorer index: ") + sqlite3_errmsg(_db));
+    }
+}
+
+sqlite3_stmt* BlockIndex::get_statement(size_t i, const char* sql) {
+    sqlite3_stmt*& stmt = _statements[i];
+    if (!stmt) {
+        test_ret(sqlite3_prepare_v2(_db, sql, -1, &stmt, 0));
+    }
+    return stmt;
+}
+
+bool BlockIndex::get_hash(Height h, Merkle::Hash& hash) {
+    Statement s(*this, Q_HASH, "SELECT hash FROM blocks WHERE height=?");
+    s.put(0, h);
+    if (!s.step()) return false;
+
+    Blob b = s.get_blob(0);
+    if (b.n != hash.nBytes) return false;
+    memcpy(hash.m_pData, b.p, b.n);
+    return true;
+}
+
+bool BlockIndex::get_block(Height h, io::SharedBuffer& body) {
+    Statement s(*this, Q_BLOCK, "SELECT body FROM blocks WHERE height=?");
+    s.put(0, h);
+    if (!s.step()) return false;
+
+    Blob b = s.get_blob(0);
+    if (!b.n) return false;
+    body.assign(b.p, b.n);
+    return true;
+}
+
+Height BlockIndex::find_kernel(const Blob& id) {
+    Statement s(*this, Q_KERNEL_FIND, "SELECT height FROM kernels WHERE id=? ORDER BY height DESC LIMIT 1");
+    s.put(0, id.p, id.n);
+    return s.step() ? s.get_int(0) : 0;
+}
+
+Height BlockIndex::find_commitment(const Blob& commitment) {
+    Statement s(*this, Q_COMMITMENT_FIND, "SELECT height FROM commitments WHERE x=? ORDER BY height DESC LIMIT 1");
+    s.put(0, commitment.p, commitment.n);
+    return s.step() ? s.get_int(0) : 0;
+}
+
+void BlockIndex::add_block(const Keys& keys, const io::SharedBuffer& body) {
+    Height h = _top + 1;
+
+    {
+        Statement s(*this, Q_BLOCK_ADD, "INSERT INTO blocks (height, hash, body) VALUES (?,?,?)");
+        s.put(0, h);
+        s.put(1, keys.hash.m_pData, keys.hash.nBytes);
+        if (body.size) {
+            s.put(2, body.data, body.size);
+        }
+        s.step();
+    }
+
+    for (const auto& id : keys.kernels) {
+        Statement s(*this, Q_KERNEL_ADD, "INSERT INTO kernels (id, height) VALUES (?,?)");
+        s.put(0, id.m_pData, id.nBytes);
+        s.put(1, h);
+        s.step();
+    }
+
+    for (const auto& x : keys.commitments) {
+        Statement s(*this, Q_COMMITMENT_ADD, "INSERT INTO commitments (x, height) VALUES (?,?)");
+        s.put(0, x.m_pData, x.nBytes);
+        s.put(1, h);
+        s.step();
+    }
+
+    _top = h;
+}
+
+void BlockIndex::rollback(Height h) {
+    if (h >= _top) return;
+
+    {
+        Statement s(*this, Q_BLOCK_DEL, "DELETE FROM blocks WHERE height>?");
+        s.put(0, h);
+        s.step();
+    }
+    {
+        Statement s(*this, Q_KERNEL_DEL, "DELETE FROM kernels WHERE height>?");
+        s.put(0, h);
+        s.step();
+    }
+    {
+        Statement s(*this, Q_COMMITMENT_DEL, "DELETE FROM commitments WHERE height>?");
+        s.put(0, h);
+        s.step();
+    }
+
+    _top = h;
+}
+
+BlockIndex::Transaction::Transaction(BlockIndex& index) :
+    _index(index)
+{
+    _index.exec("BEGIN");
+    _index._txTop = _index._top;
+}
+
+BlockIndex::Transaction::~Transaction() {
+    if (_committed) return;
+
+    // no throwing from here
+    if (sqlite3_exec(_index._db, "ROLLBACK", NULL, NULL, NULL) != SQLITE_OK) {
+        LOG_ERROR() << "explorer index rollback: " << sqlite3_errmsg(_index._db);
+    }
+    _index._top = _index._txTop;
+}
+
+void BlockIndex::Transaction::commit() {
+    _index.exec("COMMIT");
+    _committed = true;
+}
+
+}} //namespaces
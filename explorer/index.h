@@ -0,0 +1,94 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "core/block_crypt.h"
+#include "utility/io/buffer.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace beam { namespace explorer {
+
+/// Explorer-side on-disk index: height -> rendered block, kernel id -> height, commitment -> height.
+/// Filled in height order, rolled back together with the node. Not thread-safe
+class BlockIndex {
+public:
+    /// Keys of the block to be looked up
+    struct Keys {
+        Merkle::Hash hash;
+        std::vector<Merkle::Hash> kernels;
+
+        /// X coordinates of the created outputs
+        std::vector<ECC::uintBig> commitments;
+    };
+
+    /// Opens or creates the index, throws std::runtime_error
+    explicit BlockIndex(const std::string& path);
+    ~BlockIndex();
+
+    BlockIndex(const BlockIndex&) = delete;
+    BlockIndex& operator=(const BlockIndex&) = delete;
+
+    /// Highest indexed height, 0 if empty
+    Height get_top() const { return _top; }
+
+    bool get_hash(Height h, Merkle::Hash& hash);
+
+    /// Rendered block, false if not indexed or indexed without the body
+    bool get_block(Height h, io::SharedBuffer& body);
+
+    /// Height of the latest block with the kernel, 0 if not found
+    Height find_kernel(const Blob& id);
+
+    /// Height of the latest block which created an output with the commitment X, 0 if not found
+    Height find_commitment(const Blob& commitment);
+
+    /// Appends the block at get_top() + 1, the body may be empty if the block can't be rendered
+    void add_block(const Keys& keys, const io::SharedBuffer& body);
+
+    /// Removes the blocks above h
+    void rollback(Height h);
+
+    /// Groups the writes in one transaction, rolled back if not committed
+    class Transaction {
+    public:
+        explicit Transaction(BlockIndex& index);
+        ~Transaction();
+
+        void commit();
+
+    private:
+        BlockIndex& _index;
+        bool _committed=false;
+    };
+
+private:
+    class Statement;
+
+    void close();
+    void exec(const char* sql);
+    void test_ret(int ret);
+
+    sqlite3_stmt* get_statement(size_t i, const char* sql);
+
+    sqlite3* _db=0;
+    std::vector<sqlite3_stmt*> _statements;
+    Height _top=0;
+
+    /// Top height at the beginning of the transaction
+    Height _txTop=0;
+};
+
+}} //namespaces
@@ -15,6 +15,7 @@
 #include "server.h"
 #include "adapter.h"
 #include "utility/logger.h"
+#include "utility/hex.h"
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <fstream>
@@ -27,14 +28,39 @@ namespace {
 
 static const uint64_t SERVER_RESTART_TIMER = 1;
 static const uint64_t ACL_REFRESH_TIMER = 2;
+static const uint64_t IDLE_CHECK_TIMER = 3;
 static const unsigned SERVER_RESTART_INTERVAL = 1000;
 static const unsigned ACL_REFRESH_INTERVAL = 5555;
+static const unsigned IDLE_CHECK_INTERVAL = 5000;
+
+// Longer than the usual idle timeout of load balancers, so that they close first
+static const unsigned KEEPALIVE_TIMEOUT = 75000;
+
+// Pipelining clients which don't read the responses are disconnected
+static const size_t MAX_UNSENT_BYTES = 4 * 1024 * 1024;
 
 enum Dirs {
     DIR_STATUS, DIR_BLOCK, DIR_BLOCKS, DIR_PEERS
     // etc
 };
 
+// Commitments are rendered as X coordinates, 0x-prefixed and without leading zeroes
+bool parse_commitment(std::string_view s, ByteBuffer& x) {
+    if (s.size() > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        s.remove_prefix(2);
+    }
+    if (s.empty() || s.size() > 64) {
+        return false;
+    }
+
+    std::string padded(64 - s.size(), '0');
+    padded.append(s);
+
+    bool isValid = false;
+    x = from_hex(padded, &isValid);
+    return isValid;
+}
+
 } //namespace
 
 Server::Server(IAdapter& adapter, io::Reactor& reactor, io::Address bindAddress, const std::string& keysFileName, const std::vector<uint32_t>& whitelist) :
@@ -48,6 +74,7 @@ Server::Server(IAdapter& adapter, io::Reactor& reactor, io::Address bindAddress,
 {
     _timers.set_timer(SERVER_RESTART_TIMER, 0, BIND_THIS_MEMFN(start_server));
     _timers.set_timer(ACL_REFRESH_TIMER, ACL_REFRESH_INTERVAL, BIND_THIS_MEMFN(refresh_acl));
+    _timers.set_timer(IDLE_CHECK_TIMER, IDLE_CHECK_INTERVAL, BIND_THIS_MEMFN(close_idle_clients));
 }
 
 void Server::start_server() {
@@ -69,6 +96,20 @@ void Server::refresh_acl() {
     _timers.set_timer(ACL_REFRESH_TIMER, ACL_REFRESH_INTERVAL, BIND_THIS_MEMFN(refresh_acl));
 }
 
+void Server::close_idle_clients() {
+    uint64_t now = local_timestamp_msec();
+    for (auto it = _clients.begin(); it != _clients.end();) {
+        if (now - it->second.lastActivity > KEEPALIVE_TIMEOUT) {
+            LOG_DEBUG() << STS << "-peer " << io::Address::from_u64(it->first) << " : idle";
+            it->second.conn->shutdown();
+            it = _clients.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    _timers.set_timer(IDLE_CHECK_TIMER, IDLE_CHECK_INTERVAL, BIND_THIS_MEMFN(close_idle_clients));
+}
+
 void Server::on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode) {
     if (errorCode == 0) {
 
@@ -85,7 +126,8 @@ void Server::on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode er
 
         newStream->enable_keepalive(1);
         LOG_DEBUG() << STS << "+peer " << peer;
-        _connections[peer.u64()] = std::make_unique<HttpConnection>(
+        Client& client = _clients[peer.u64()];
+        client.conn = std::make_unique<HttpConnection>(
             peer.u64(),
             BaseConnection::inbound,
             BIND_THIS_MEMFN(on_request),
@@ -93,6 +135,7 @@ void Server::on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode er
             1024,
             std::move(newStream)
         );
+        client.lastActivity = local_timestamp_msec();
     } else {
         LOG_ERROR() << STS << io::error_str(errorCode) << ", restarting server in  " << SERVER_RESTART_INTERVAL << " msec";
         _timers.set_timer(SERVER_RESTART_TIMER, SERVER_RESTART_INTERVAL, BIND_THIS_MEMFN(start_server));
@@ -100,27 +143,29 @@ void Server::on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode er
 }
 
 bool Server::on_request(uint64_t id, const HttpMsgReader::Message& msg) {
-    auto it = _connections.find(id);
-    if (it == _connections.end()) return false;
+    auto it = _clients.find(id);
+    if (it == _clients.end()) return false;
 
     if (msg.what != HttpMsgReader::http_message || !msg.msg) {
         LOG_DEBUG() << STS << "-peer " << io::Address::from_u64(id) << " : " << msg.error_str();
-        _connections.erase(id);
+        _clients.erase(it);
         return false;
     }
 
+    Client& client = it->second;
+    client.lastActivity = local_timestamp_msec();
+    client.keepAlive = msg.msg->keep_alive() && client.conn->get_Unsent() <= MAX_UNSENT_BYTES;
+
     const std::string& path = msg.msg->get_path();
 
     static const std::map<std::string_view, int> dirs {
         { "status", DIR_STATUS }, { "block", DIR_BLOCK }, { "blocks", DIR_BLOCKS }, { "peers", DIR_PEERS}
     };
 
-    const HttpConnection::Ptr& conn = it->second;
+    bool (Server::*func)(Client&) = 0;
 
-    bool (Server::*func)(const HttpConnection::Ptr&) = 0;
-
-    if (_currentUrl.parse(path, dirs)) {
-        switch (_currentUrl.dir) {
+    if (client.url.parse(path, dirs)) {
+        switch (client.url.dir) {
             case DIR_STATUS:
                 func = &Server::send_status;
                 break;
@@ -138,113 +183,131 @@ bool Server::on_request(uint64_t id, const HttpMsgReader::Message& msg) {
         }
     }
 
-    bool keepalive = false;
+    bool ok = false;
 
     if (func) {
-        //bool validKey = _acl.check(_currentUrl.args["m"], _currentUrl.args["n"], _currentUrl.args["h"]);
-        bool validKey = _acl.check(conn->peer_address());
+        //bool validKey = _acl.check(client.url.args["m"], client.url.args["n"], client.url.args["h"]);
+        bool validKey = _acl.check(client.conn->peer_address());
         if (!validKey) {
-            send(conn, 403, "Forbidden");
+            client.keepAlive = false;
+            ok = send(client, 403, "Forbidden");
         } else {
-            keepalive = (this->*func)(conn);
+            ok = (this->*func)(client);
         }
     } else {
-        send(conn, 404, "Not Found");
+        ok = send(client, 404, "Not Found");
     }
 
-    if (!keepalive) {
-        conn->shutdown();
-        _connections.erase(it);
+    if (!ok || !client.keepAlive) {
+        client.conn->flush();
+        client.conn->shutdown();
+        _clients.erase(it);
+        return false;
     }
-    return keepalive;
+    return true;
 }
 
-bool Server::send_status(const HttpConnection::Ptr& conn) {
-    _body.clear();
-    if (!_backend.get_status(_body)) {
-        return send(conn, 500, "Internal error #1");
+bool Server::send_status(Client& client) {
+    if (!_backend.get_status(client.body)) {
+        return send(client, 500, "Internal error #1");
     }
-    return send(conn, 200, "OK");
+    return send(client, 200, "OK");
 }
 
-bool Server::send_block(const HttpConnection::Ptr &conn) {
+bool Server::send_block(Client& client) {
+    const HttpUrl& url = client.url;
+    io::SerializedMsg& body = client.body;
 
-    if (_currentUrl.has_arg("hash"))
+    if (url.has_arg("hash"))
     {
         ByteBuffer hash;
 
-        if (!_currentUrl.get_hex_arg("hash", hash) || !_backend.get_block_by_hash(_body, hash)) {
-            return send(conn, 500, "Internal error #2");
+        if (!url.get_hex_arg("hash", hash) || !_backend.get_block_by_hash(body, hash)) {
+            return send(client, 500, "Internal error #2");
         }
     }
-    else if (_currentUrl.has_arg("kernel"))
+    else if (url.has_arg("kernel"))
     {
         ByteBuffer kernel;
 
-        if (!_currentUrl.get_hex_arg("kernel", kernel) || !_backend.get_block_by_kernel(_body, kernel)) {
-            return send(conn, 500, "Internal error #2");
+        if (!url.get_hex_arg("kernel", kernel) || !_backend.get_block_by_kernel(body, kernel)) {
+            return send(client, 500, "Internal error #2");
+        }
+    }
+    else if (url.has_arg("commitment"))
+    {
+        ByteBuffer commitment;
+
+        if (!parse_commitment(url.args.at("commitment"), commitment) || !_backend.get_block_by_commitment(body, commitment)) {
+            return send(client, 500, "Internal error #2");
         }
     }
     else 
     {
-        auto height = _currentUrl.get_int_arg("height", 0);
-        if (!_backend.get_block(_body, height)) {
-            return send(conn, 500, "Internal error #2");
+        auto height = url.get_int_arg("height", 0);
+        if (!_backend.get_block(body, height)) {
+            return send(client, 500, "Internal error #2");
         }
     }
 
-    return send(conn, 200, "OK");
+    return send(client, 200, "OK");
 }
 
-bool Server::send_blocks(const HttpConnection::Ptr& conn) {
-    auto start = _currentUrl.get_int_arg("height", 0);
-    auto n = _currentUrl.get_int_arg("n", 0);
+bool Server::send_blocks(Client& client) {
+    auto start = client.url.get_int_arg("height", 0);
+    auto n = client.url.get_int_arg("n", 0);
     if (start <= 0 || n < 0) {
-        return send(conn, 400, "Bad request");
+        return send(client, 400, "Bad request");
     }
-    if (!_backend.get_blocks(_body, start, n)) {
-        return send(conn, 500, "Internal error #3");
+    if (!_backend.get_blocks(client.body, start, n)) {
+        return send(client, 500, "Internal error #3");
     }
-    return send(conn, 200, "OK");
+    return send(client, 200, "OK");
 }
 
-bool Server::send_peers(const HttpConnection::Ptr& conn) {
-    if (!_backend.get_peers(_body)) {
-        return send(conn, 500, "Internal error #3");
+bool Server::send_peers(Client& client) {
+    if (!_backend.get_peers(client.body)) {
+        return send(client, 500, "Internal error #3");
     }
-    return send(conn, 200, "OK");
+    return send(client, 200, "OK");
 }
 
-bool Server::send(const HttpConnection::Ptr& conn, int code, const char* message) {
-    assert(conn);
+// The error responses are complete as well, the connection persists after them unless the client closes it.
+// Writes are flushed by the connection after the pipelined requests of one read are served
+bool Server::send(Client& client, int code, const char* message) {
+    assert(client.conn);
 
     size_t bodySize = 0;
-    for (const auto& f : _body) { bodySize += f.size; }
+    for (const auto& f : client.body) { bodySize += f.size; }
+
+    const HeaderPair headers[] = {
+        { "Connection", client.keepAlive ? "keep-alive" : "close" }
+    };
 
     bool ok = _msgCreator.create_response(
-        _headers,
+        client.headers,
         code,
         message,
-        0, //headers,
-        0, //sizeof(headers) / sizeof(HeaderPair),
+        headers,
+        sizeof(headers) / sizeof(HeaderPair),
         1,
         "application/json",
         bodySize
     );
 
     if (ok) {
-        auto result = conn->write_msg(_headers);
+        auto result = client.conn->write_msg(client.headers, false);
         if (result && bodySize > 0) {
-            result = conn->write_msg(_body);
+            result = client.conn->write_msg(client.body, false);
         }
         if (!result) ok = false;
     } else {
         LOG_ERROR() << STS << "cannot create response";
     }
 
-    _headers.clear();
-    _body.clear();
-    return (ok && code == 200);
+    client.headers.clear();
+    client.body.clear();
+    return ok;
 }
 
 Server::IPAccessControl::IPAccessControl(const std::string &ipsFileName) :
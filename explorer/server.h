@@ -43,17 +43,31 @@ private:
         std::set<uint32_t> _ips;
     };
 
+    /// Per-connection state, requests of one connection are served in order
+    struct Client {
+        HttpConnection::Ptr conn;
+        HttpUrl url;
+        io::SerializedMsg headers;
+        io::SerializedMsg body;
+
+        /// The connection persists after the response
+        bool keepAlive=false;
+
+        uint64_t lastActivity=0;
+    };
+
     void start_server();
     void refresh_acl();
+    void close_idle_clients();
 
     void on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode);
 
     bool on_request(uint64_t id, const HttpMsgReader::Message& msg);
-    bool send_status(const HttpConnection::Ptr& conn);
-    bool send_block(const HttpConnection::Ptr& conn);
-    bool send_blocks(const HttpConnection::Ptr& conn);
-    bool send_peers(const HttpConnection::Ptr& conn);
-    bool send(const HttpConnection::Ptr& conn, int code, const char* message);
+    bool send_status(Client& client);
+    bool send_block(Client& client);
+    bool send_blocks(Client& client);
+    bool send_peers(Client& client);
+    bool send(Client& client, int code, const char* message);
 
     HttpMsgCreator _msgCreator;
     IAdapter& _backend;
@@ -61,10 +75,7 @@ private:
     io::MultipleTimers _timers;
     io::Address _bindAddress;
     io::TcpServer::Ptr _server;
-    std::map<uint64_t, HttpConnection::Ptr> _connections;
-    HttpUrl _currentUrl;
-    io::SerializedMsg _headers;
-    io::SerializedMsg _body;
+    std::map<uint64_t, Client> _clients;
     //AccessControl _acl;
     IPAccessControl _acl;
     std::vector<uint32_t> _whitelist;
@@ -15,6 +15,7 @@
 #include "explorer/adapter.h"
 #include "node/node.h"
 #include "utility/logger.h"
+#include "nlohmann/json.hpp"
 #include <future>
 #include <boost/filesystem.hpp>
 #include <wallet/core/common_utils.h>
@@ -23,9 +24,66 @@ namespace beam {
 
 struct WaitHandle {
     io::Reactor::Ptr reactor;
-    std::future<void> future;
+    std::future<bool> future;
 };
 
+bool parse_response(const io::SerializedMsg& msg, nlohmann::json& out) {
+    std::string s;
+    for (const auto& f : msg) {
+        s.append((const char*)f.data, f.size);
+    }
+
+    try {
+        out = nlohmann::json::parse(s);
+    } catch (const std::exception& e) {
+        LOG_ERROR() << "invalid response: " << e.what() << " " << s;
+        return false;
+    }
+    return true;
+}
+
+// The rendered responses are checked after the node is stopped, the blocks are kept in the db
+bool check_responses(explorer::IAdapter& adapter) {
+    using nlohmann::json;
+
+    io::SerializedMsg msg;
+    json j;
+
+    if (!adapter.get_status(msg) || !parse_response(msg, j)) {
+        return false;
+    }
+
+    Height height = j["height"];
+    LOG_INFO() << "explorer status: " << j;
+
+    msg.clear();
+    if (!adapter.get_blocks(msg, 1, height + 1) || !parse_response(msg, j) || !j.is_array() || j.size() != height + 1) {
+        return false;
+    }
+
+    // from the top, the one above is not found
+    if (j[0]["found"] != false || j[0]["height"] != height + 1) {
+        return false;
+    }
+
+    for (size_t i = 1; i < j.size(); i++) {
+        const json& block = j[i];
+        if (block["found"] != true || block["height"] != height + 1 - i || !block["kernels"].is_array()) {
+            LOG_ERROR() << "unexpected block " << block;
+            return false;
+        }
+
+        // the same from the cache
+        msg.clear();
+        json cached;
+        if (!adapter.get_block(msg, block["height"]) || !parse_response(msg, cached) || cached != block) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 struct NodeParams {
     io::Address nodeAddress;
     io::Address connectTo;
@@ -35,6 +93,8 @@ struct NodeParams {
 
 static const uint16_t NODE_PORT=20000;
 
+#define FILENAME "_xx"
+
 WaitHandle run_node(const NodeParams& params) {
     WaitHandle ret;
     io::Reactor::Ptr reactor = io::Reactor::create();
@@ -61,11 +121,13 @@ WaitHandle run_node(const NodeParams& params) {
                 LOG_INFO() << "Treasury blocks read: " << node.m_Cfg.m_Treasury.size();
             }
 
-            explorer::IAdapter::Ptr adapter = explorer::create_adapter(node);
+            explorer::IAdapter::Ptr adapter = explorer::create_adapter(node, FILENAME "_index");
 
             LOG_INFO() << "starting a node on " << node.m_Cfg.m_Listen.port() << " port...";
             node.Initialize();
             reactor->run();
+
+            return check_responses(*adapter);
         }
     );
 
@@ -73,11 +135,10 @@ WaitHandle run_node(const NodeParams& params) {
     return ret;
 }
 
-#define FILENAME "_xx"
-
 void cleanup_files() {
     boost::filesystem::remove_all(FILENAME);
     boost::filesystem::remove_all(FILENAME "_");
+    boost::filesystem::remove_all(FILENAME "_index");
 }
 
 int test_adapter(int seconds) {
@@ -97,7 +158,10 @@ int test_adapter(int seconds) {
     wait_for_termination(seconds);
 
     nodeWH.reactor->stop();
-    nodeWH.future.get();
+    if (!nodeWH.future.get()) {
+        LOG_ERROR() << "explorer responses check failed";
+        return 1;
+    }
 
     return 0;
 }
@@ -0,0 +1,147 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "explorer/index.h"
+#include "utility/logger.h"
+#include <boost/filesystem.hpp>
+#include <iostream>
+
+using namespace beam;
+using namespace beam::explorer;
+using namespace std;
+
+namespace {
+
+#define FILENAME "_index_test.db"
+
+int g_failures = 0;
+
+void check(bool cond, const char* what) {
+    if (!cond) {
+        cout << "FAILED: " << what << endl;
+        g_failures++;
+    }
+}
+
+template <typename T> T make_key(uint8_t n, uint8_t tag) {
+    T v;
+    v = Zero;
+    v.m_pData[0] = tag;
+    v.m_pData[v.nBytes - 1] = n;
+    return v;
+}
+
+BlockIndex::Keys make_keys(uint8_t h) {
+    BlockIndex::Keys keys;
+    keys.hash = make_key<Merkle::Hash>(h, 1);
+    keys.kernels.push_back(make_key<Merkle::Hash>(h, 2));
+    keys.commitments.push_back(make_key<ECC::uintBig>(h, 3));
+
+    // the same commitment is created again at the odd heights
+    if (h & 1) {
+        keys.commitments.push_back(make_key<ECC::uintBig>(0, 3));
+    }
+    return keys;
+}
+
+io::SharedBuffer make_body(uint8_t h) {
+    string s = "{\"height\":" + to_string(h) + "}";
+    return io::SharedBuffer(s.data(), s.size());
+}
+
+string to_string(const io::SharedBuffer& b) {
+    return string((const char*)b.data, b.size);
+}
+
+void test_index() {
+    boost::filesystem::remove(FILENAME);
+
+    {
+        BlockIndex index(FILENAME);
+        check(index.get_top() == 0, "empty");
+
+        BlockIndex::Transaction tx(index);
+        for (uint8_t h = 1; h <= 5; h++) {
+            // no body at 4
+            index.add_block(make_keys(h), (h == 4) ? io::SharedBuffer() : make_body(h));
+        }
+        tx.commit();
+
+        check(index.get_top() == 5, "top");
+
+        io::SharedBuffer body;
+        check(index.get_block(3, body) && to_string(body) == "{\"height\":3}", "body");
+        check(!index.get_block(4, body), "no body");
+        check(!index.get_block(6, body), "above top");
+
+        Merkle::Hash hash;
+        check(index.get_hash(4, hash) && hash == make_key<Merkle::Hash>(4, 1), "hash");
+
+        Merkle::Hash krn = make_key<Merkle::Hash>(2, 2);
+        check(index.find_kernel(krn) == 2, "kernel");
+        krn = make_key<Merkle::Hash>(9, 2);
+        check(index.find_kernel(krn) == 0, "no kernel");
+
+        ECC::uintBig x = make_key<ECC::uintBig>(0, 3);
+        check(index.find_commitment(x) == 5, "latest commitment");
+    }
+
+    // persisted
+    {
+        BlockIndex index(FILENAME);
+        check(index.get_top() == 5, "reopened top");
+
+        index.rollback(3);
+        check(index.get_top() == 3, "rolled back top");
+
+        io::SharedBuffer body;
+        check(!index.get_block(5, body), "rolled back body");
+
+        Merkle::Hash krn = make_key<Merkle::Hash>(5, 2);
+        check(index.find_kernel(krn) == 0, "rolled back kernel");
+
+        ECC::uintBig x = make_key<ECC::uintBig>(0, 3);
+        check(index.find_commitment(x) == 3, "rolled back commitment");
+
+        // not committed
+        {
+            BlockIndex::Transaction tx(index);
+            index.add_block(make_keys(4), make_body(4));
+            check(index.get_top() == 4, "added in tx");
+        }
+        check(index.get_top() == 3, "tx rolled back top");
+        check(!index.get_block(4, body), "tx rolled back body");
+
+        // appended after the rollback
+        index.add_block(make_keys(4), make_body(4));
+        check(index.get_block(4, body) && to_string(body) == "{\"height\":4}", "appended");
+    }
+
+    boost::filesystem::remove(FILENAME);
+}
+
+} //namespace
+
+int main() {
+    auto logger = Logger::create(LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG);
+
+    try {
+        test_index();
+    } catch (const exception& e) {
+        cout << "Exception: " << e.what() << endl;
+        return 1;
+    }
+
+    return g_failures;
+}
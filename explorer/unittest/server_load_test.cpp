@@ -0,0 +1,240 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "explorer/server.h"
+#include "explorer/adapter.h"
+#include "utility/io/timer.h"
+#include "utility/logger.h"
+#include <iostream>
+#include <deque>
+
+using namespace beam;
+using namespace beam::explorer;
+using namespace std;
+
+namespace {
+
+const uint16_t PORT = 8766;
+
+int g_failures = 0;
+
+void check(bool cond, const char* what) {
+    if (!cond) {
+        cout << "FAILED: " << what << endl;
+        g_failures++;
+    }
+}
+
+// Renders the requested height only, so that the server side is measured
+struct StubAdapter : IAdapter {
+    bool get_status(io::SerializedMsg& out) override {
+        return write(out, "{\"height\":100}\n");
+    }
+
+    bool get_block(io::SerializedMsg& out, uint64_t height) override {
+        return write(out, "{\"found\":true,\"height\":" + to_string(height) + "}\n");
+    }
+
+    bool get_block_by_hash(io::SerializedMsg&, const ByteBuffer&) override { return false; }
+    bool get_block_by_kernel(io::SerializedMsg&, const ByteBuffer&) override { return false; }
+    bool get_block_by_commitment(io::SerializedMsg&, const ByteBuffer&) override { return false; }
+    bool get_blocks(io::SerializedMsg&, uint64_t, uint64_t) override { return false; }
+    bool get_peers(io::SerializedMsg&) override { return false; }
+
+    static bool write(io::SerializedMsg& out, const string& s) {
+        out.push_back(io::SharedBuffer(s.data(), s.size()));
+        return true;
+    }
+};
+
+/// Requests /block?height=N over nConnections parallel connections, keeps up to depth requests in flight on each one.
+/// Without keepAlive, every request goes over a new connection
+class LoadClient {
+public:
+    LoadClient(io::Reactor& reactor, unsigned nConnections, unsigned nRequests, unsigned depth, bool keepAlive) :
+        _reactor(reactor),
+        _slots(nConnections),
+        _nRequests(nRequests),
+        _depth(keepAlive ? depth : 1),
+        _keepAlive(keepAlive)
+    {}
+
+    /// Requests per second, 0 on errors
+    double run() {
+        _started = local_timestamp_msec();
+        for (uint64_t i = 0; i < _slots.size(); i++) {
+            connect(i);
+        }
+        _reactor.run();
+        uint64_t elapsed = local_timestamp_msec() - _started;
+        if (_errors || _received != _nRequests) return 0;
+        return _received * 1000.0 / (elapsed ? elapsed : 1);
+    }
+
+    unsigned connections() const { return _nConnects; }
+
+private:
+    struct Slot {
+        HttpConnection::Ptr conn;
+
+        /// Heights of the requests in flight, in order
+        std::deque<unsigned> inFlight;
+    };
+
+    void connect(uint64_t tag) {
+        if (!_reactor.tcp_connect(io::Address::localhost().port(PORT), tag, BIND_THIS_MEMFN(on_connected), 10000, false, false)) {
+            fail("connect failed");
+        }
+    }
+
+    void on_connected(uint64_t tag, io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode) {
+        if (errorCode != 0) {
+            fail(io::error_str(errorCode));
+            return;
+        }
+
+        _nConnects++;
+        Slot& slot = _slots[tag];
+        slot.conn = std::make_unique<HttpConnection>(
+            tag,
+            BaseConnection::outbound,
+            BIND_THIS_MEMFN(on_response),
+            10000,
+            1024,
+            std::move(newStream)
+        );
+        send_requests(slot);
+    }
+
+    // Pipelined requests of one batch are written together
+    void send_requests(Slot& slot) {
+        _requests.clear();
+        while (slot.inFlight.size() < _depth && _sent < _nRequests) {
+            unsigned height = ++_sent;
+            _requests += "GET /block?height=" + to_string(height) + " HTTP/1.1\r\nHost: localhost\r\n";
+            if (!_keepAlive) _requests += "Connection: close\r\n";
+            _requests += "\r\n";
+            slot.inFlight.push_back(height);
+        }
+        if (!_requests.empty()) {
+            slot.conn->write_msg(io::SharedBuffer(_requests.data(), _requests.size()));
+        }
+    }
+
+    bool on_response(uint64_t tag, const HttpMsgReader::Message& msg) {
+        Slot& slot = _slots[tag];
+
+        if (msg.what != HttpMsgReader::http_message || !msg.msg) {
+            fail(msg.error_str());
+            slot.conn.reset();
+            return false;
+        }
+
+        size_t size = 0;
+        const void* body = msg.msg->get_body(size);
+        string expected = "{\"found\":true,\"height\":" + to_string(slot.inFlight.front()) + "}\n";
+        slot.inFlight.pop_front();
+        if (msg.msg->get_status() != 200 || string((const char*)body, size) != expected) {
+            fail("unexpected response");
+            slot.conn.reset();
+            return false;
+        }
+
+        bool done = (++_received == _nRequests);
+        if (done) {
+            _reactor.stop();
+        }
+
+        if (!_keepAlive || done) {
+            if (!_keepAlive && msg.msg->keep_alive()) {
+                fail("kept alive");
+            }
+            slot.conn.reset();
+            if (_sent < _nRequests) connect(tag);
+            return false;
+        }
+
+        send_requests(slot);
+        return true;
+    }
+
+    void fail(const string& what) {
+        cout << "client error: " << what << endl;
+        _errors++;
+        _reactor.stop();
+    }
+
+    io::Reactor& _reactor;
+    vector<Slot> _slots;
+    const unsigned _nRequests;
+    const unsigned _depth;
+    const bool _keepAlive;
+    unsigned _sent=0;
+    unsigned _received=0;
+    unsigned _nConnects=0;
+    unsigned _errors=0;
+    uint64_t _started=0;
+    string _requests;
+};
+
+// Not a strict test: prints requests/second of the three client behaviours against one server.
+// The server and the clients share the reactor, so the numbers are comparable but not absolute
+void load_test() {
+    static const unsigned N_CONNECTIONS = 8;
+    static const unsigned N_REQUESTS = 10000;
+
+    io::Reactor::Ptr reactor = io::Reactor::create();
+    io::Reactor::Scope scope(*reactor);
+
+    StubAdapter adapter;
+    Server server(adapter, *reactor, io::Address::localhost().port(PORT), "", {});
+
+    // the server starts listening on the first timer
+    io::Timer::Ptr timer = io::Timer::create(*reactor);
+    timer->start(200, false, [&reactor] { reactor->stop(); });
+    reactor->run();
+
+    static const struct {
+        const char* name;
+        unsigned depth;
+        bool keepAlive;
+    } modes[] = {
+        { "connection per request", 1, false },
+        { "keep-alive", 1, true },
+        { "keep-alive, pipelined x16", 16, true }
+    };
+
+    for (const auto& m : modes) {
+        LoadClient client(*reactor, N_CONNECTIONS, N_REQUESTS, m.depth, m.keepAlive);
+        double rps = client.run();
+        cout << m.name << ": " << (uint64_t)rps << " requests/s over " << client.connections() << " connections" << endl;
+        check(rps > 0, m.name);
+        check(m.keepAlive ? client.connections() == N_CONNECTIONS : client.connections() >= N_REQUESTS, "connections");
+    }
+}
+
+} //namespace
+
+int main() {
+    auto logger = Logger::create(LOG_LEVEL_INFO, LOG_LEVEL_INFO);
+
+    try {
+        load_test();
+    } catch (const exception& e) {
+        cout << "Exception: " << e.what() << endl;
+        return 1;
+    }
+
+    return g_failures;
+}
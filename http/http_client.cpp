@@ -21,6 +21,11 @@ namespace beam {
 static const size_t CREATOR_FRAGMENT_SIZE = 1000;
 static const size_t READER_FRAGMENT_SIZE = 8192;
 static const size_t MAX_RESPONSE_BODY_SIZE = 16*1024*1024;
+static const size_t MAX_PIPELINE_DEPTH = 8;
+static const size_t MAX_CONNECTIONS_PER_HOST = 4;
+
+// Shorter than the usual server-side idle timeouts (30 s for bitcoind)
+static const uint64_t POOL_IDLE_TIMEOUT = 20000;
 
 HttpClient::HttpClient(io::Reactor& reactor) :
     _reactor(reactor),
@@ -36,6 +41,8 @@ HttpClient::~HttpClient() {
 
 expected<uint64_t, io::ErrorCode> HttpClient::send_request(const HttpClient::Request& request) {
     if (!request.validate()) return make_unexpected(io::EC_EINVAL);
+    if (request.keepAlive_ && request.id_ == 0) return send_pooled_request(request);
+
     Ctx* ctx = 0;
     uint64_t id = 0;
     bool newConnection = false;
@@ -78,6 +85,7 @@ expected<uint64_t, io::ErrorCode> HttpClient::send_request(const HttpClient::Req
     io::Result result;
     if (ctx->conn) {
         result = ctx->conn->write_msg(ctx->unsent, true);
+        ctx->unsent.clear();
     } else if (newConnection) {
         int timeout = (request.connectTimeoutMsec_ > 0) ? int(request.connectTimeoutMsec_) : -1;
         auto tag = uint64_t(ctx);
@@ -96,6 +104,134 @@ expected<uint64_t, io::ErrorCode> HttpClient::send_request(const HttpClient::Req
     return id;
 }
 
+expected<uint64_t, io::ErrorCode> HttpClient::send_pooled_request(const HttpClient::Request& request) {
+    PooledRequest r;
+    size_t bodySize = 0;
+    for (auto& f : request.body_) bodySize += f.size;
+
+    if (!_msgCreator.create_request(
+        r.msg,
+        request.method_,
+        request.pathAndQuery_,
+        request.headers_,
+        request.numHeaders_,
+        1, //http/1.1
+        request.contentType_,
+        bodySize
+    )) {
+        return make_unexpected(io::EC_EINVAL);
+    }
+
+    if (bodySize) {
+        r.msg.insert(r.msg.end(), request.body_.begin(), request.body_.end());
+    }
+
+    r.id = ++_idCounter;
+    r.callback = request.callback_;
+    r.idempotent = request.idempotent_;
+    r.timeoutMsec = request.responseTimeoutMsec_;
+    uint64_t id = r.id;
+
+    close_idle_connections();
+
+    auto result = dispatch(request.address_, request.connectTimeoutMsec_, std::move(r));
+    if (!result) {
+        return make_unexpected(result.error());
+    }
+    return id;
+}
+
+// The request goes to the least loaded connection to the host. A new connection is opened
+// if all of them have full pipelines, the 1st request on a connection isn't pipelined
+io::Result HttpClient::dispatch(const io::Address& address, unsigned connectTimeoutMsec, PooledRequest&& request) {
+    PooledConnection* pc = 0;
+    uint64_t id = 0;
+    size_t nConnections = 0;
+    for (auto& p : _pool) {
+        PooledConnection& c = p.second;
+        if (c.address != address || c.closing) continue;
+        ++nConnections;
+        if (!pc || c.inFlight.size() < pc->inFlight.size()) {
+            pc = &c;
+            id = p.first;
+        }
+    }
+
+    if (pc) {
+        size_t depth = pc->nResponses ? MAX_PIPELINE_DEPTH : 1;
+        if (pc->inFlight.size() >= depth && nConnections < MAX_CONNECTIONS_PER_HOST) pc = 0;
+    }
+
+    if (!pc) {
+        id = ++_idCounter;
+        pc = &_pool[id];
+        pc->address = address;
+        pc->connectTimeoutMsec = connectTimeoutMsec;
+        pc->timer = io::Timer::create(_reactor);
+
+        int timeout = (connectTimeoutMsec > 0) ? int(connectTimeoutMsec) : -1;
+        auto tag = uint64_t(pc);
+        auto result = _reactor.tcp_connect(address, tag, BIND_THIS_MEMFN(on_connected), timeout);
+        if (!result) {
+            _pool.erase(id);
+            return result;
+        }
+        _pendingConnections[tag] = id;
+    } else if (pc->conn) {
+        auto result = pc->conn->write_msg(request.msg);
+        if (!result) return result;
+    }
+
+    pc->lastUsed = local_timestamp_msec();
+    request.deadline = request.timeoutMsec ? pc->lastUsed + request.timeoutMsec : 0;
+    pc->inFlight.push_back(std::move(request));
+    if (pc->inFlight.size() == 1) {
+        start_response_timer(id, *pc);
+    }
+    return io::Result();
+}
+
+void HttpClient::start_response_timer(uint64_t id, PooledConnection& pc) {
+    if (pc.inFlight.empty() || !pc.inFlight.front().deadline) {
+        pc.timer->cancel();
+        return;
+    }
+
+    uint64_t now = local_timestamp_msec();
+    uint64_t deadline = pc.inFlight.front().deadline;
+    unsigned msec = (deadline > now) ? unsigned(deadline - now) : 0;
+    pc.timer->start(msec, false, [this, id] { on_response_timeout(id); });
+}
+
+// A stalled server must not block the requests queued to it forever
+void HttpClient::on_response_timeout(uint64_t id) {
+    auto it = _pool.find(id);
+    if (it == _pool.end() || it->second.inFlight.empty()) return;
+
+    PooledRequest r = std::move(it->second.inFlight.front());
+    it->second.inFlight.pop_front();
+    LOG_WARNING() << "http request to " << it->second.address << " timed out";
+
+    // the rest might have been processed as well
+    close_pooled_connection(it, HttpMsgReader::Message(io::EC_ETIMEDOUT), Resend::Idempotent);
+
+    if (r.callback) {
+        r.callback(r.id, HttpMsgReader::Message(io::EC_ETIMEDOUT));
+    }
+}
+
+void HttpClient::close_idle_connections() {
+    uint64_t now = local_timestamp_msec();
+    for (auto it = _pool.begin(); it != _pool.end();) {
+        const PooledConnection& pc = it->second;
+        if (pc.conn && pc.inFlight.empty() && now - pc.lastUsed > POOL_IDLE_TIMEOUT) {
+            it = _pool.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
 void HttpClient::cancel_request(uint64_t id) {
     auto it = _connections.find(id);
     if (it != _connections.end()) {
@@ -105,6 +241,17 @@ void HttpClient::cancel_request(uint64_t id) {
             _pendingConnections.erase(tag);
         }
         _connections.erase(it);
+        return;
+    }
+
+    // the response to the pooled request is still read, but not passed
+    for (auto& p : _pool) {
+        for (auto& r : p.second.inFlight) {
+            if (r.id == id) {
+                r.callback = OnResponse();
+                return;
+            }
+        }
     }
 }
 
@@ -114,6 +261,34 @@ void HttpClient::on_connected(uint64_t tag, io::TcpStream::Ptr&& newStream, io::
     uint64_t id = it1->second;
     _pendingConnections.erase(it1);
 
+    auto itPool = _pool.find(id);
+    if (itPool != _pool.end()) {
+        if (errorCode != io::EC_OK) {
+            close_pooled_connection(itPool, HttpMsgReader::Message(errorCode), Resend::None);
+            return;
+        }
+
+        PooledConnection& pc = itPool->second;
+        pc.conn = std::make_unique<HttpConnection>(
+            id,
+            BaseConnection::outbound,
+            BIND_THIS_MEMFN(on_response),
+            MAX_RESPONSE_BODY_SIZE,
+            READER_FRAGMENT_SIZE,
+            std::move(newStream)
+        );
+
+        for (const auto& r : pc.inFlight) {
+            auto result = pc.conn->write_msg(r.msg, false);
+            if (!result) {
+                close_pooled_connection(itPool, HttpMsgReader::Message(result.error()), Resend::None);
+                return;
+            }
+        }
+        pc.conn->flush();
+        return;
+    }
+
     auto it2 = _connections.find(id);
     if (it2 == _connections.end()) return;
     Ctx& ctx = it2->second;
@@ -142,12 +317,17 @@ void HttpClient::on_connected(uint64_t tag, io::TcpStream::Ptr&& newStream, io::
             ctx.callback(id, HttpMsgReader::Message(result.error()));
             _connections.erase(it2);
         } else {
+            ctx.unsent.clear();
             ctx.conn = std::move(conn);
         }
     }
 }
 
 bool HttpClient::on_response(uint64_t id, const HttpMsgReader::Message& msg) {
+    if (_pool.count(id)) {
+        return on_pooled_response(id, msg);
+    }
+
     auto it = _connections.find(id);
     if (it == _connections.end()) return false;
 
@@ -160,4 +340,65 @@ bool HttpClient::on_response(uint64_t id, const HttpMsgReader::Message& msg) {
     return proceed;
 }
 
+bool HttpClient::on_pooled_response(uint64_t id, const HttpMsgReader::Message& msg) {
+    auto it = _pool.find(id);
+    PooledConnection& pc = it->second;
+
+    if (msg.what != HttpMsgReader::http_message || !msg.msg || pc.inFlight.empty()) {
+        // a reused keep-alive connection may be closed by the server at any moment
+        bool lost = pc.nResponses > 0 && msg.what == HttpMsgReader::connection_error
+            && (msg.connectionError == io::EC_EOF || msg.connectionError == io::EC_ECONNRESET);
+        close_pooled_connection(it, msg, lost ? Resend::Idempotent : Resend::None);
+        return false;
+    }
+
+    PooledRequest r = std::move(pc.inFlight.front());
+    pc.inFlight.pop_front();
+    pc.nResponses++;
+    pc.lastUsed = local_timestamp_msec();
+    pc.closing = !msg.msg->keep_alive();
+    start_response_timer(id, pc);
+
+    // the callback may send new requests, the pool is not invalidated by them
+    if (r.callback) {
+        r.callback(r.id, msg);
+    }
+
+    if (pc.closing) {
+        // the rest were not processed by the server
+        close_pooled_connection(it, HttpMsgReader::Message(io::EC_EOF), Resend::All);
+        return false;
+    }
+    return true;
+}
+
+void HttpClient::close_pooled_connection(std::map<uint64_t, PooledConnection>::iterator it, const HttpMsgReader::Message& error, Resend resend) {
+    io::Address address = it->second.address;
+    unsigned connectTimeoutMsec = it->second.connectTimeoutMsec;
+    std::deque<PooledRequest> requests = std::move(it->second.inFlight);
+
+    auto tag = uint64_t(&it->second);
+    if (_pendingConnections.erase(tag)) {
+        _reactor.cancel_tcp_connect(tag);
+    }
+    _pool.erase(it);
+
+    std::vector<PooledRequest> failed;
+    for (auto& r : requests) {
+        // resent once. The requests with side effects are resent only if they weren't processed for sure
+        bool canResend = (Resend::All == resend) || (Resend::Idempotent == resend && r.idempotent);
+        if (canResend && !r.retried) {
+            r.retried = true;
+            if (dispatch(address, connectTimeoutMsec, std::move(r))) continue;
+        }
+        failed.push_back(std::move(r));
+    }
+
+    for (auto& r : failed) {
+        if (r.callback) {
+            r.callback(r.id, error);
+        }
+    }
+}
+
 } //namespace
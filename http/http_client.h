@@ -16,6 +16,8 @@
 
 #include "http/http_connection.h"
 #include "http/http_msg_creator.h"
+#include "utility/io/timer.h"
+#include <deque>
 
 namespace beam {
 
@@ -31,8 +33,22 @@ public:
         // and the request will be sent over established connection with this id
         uint64_t id_;
 
+        // If set (and id == 0), the request goes over a pooled keep-alive connection to the address,
+        // pipelined after the requests in flight. The callback's return value is ignored then,
+        // the pool manages the connections
+        bool keepAlive_;
+
+        // For keep-alive requests: the request has no side effects and may be resent automatically
+        // if the reused connection is lost before the response. Otherwise the callback gets the error
+        bool idempotent_;
+
         io::Address address_;
         unsigned connectTimeoutMsec_;
+
+        // For keep-alive requests: the callback gets EC_ETIMEDOUT if there's no response in time
+        // (counted from the request is queued), the connection is closed then. 0 to wait forever
+        unsigned responseTimeoutMsec_;
+
         OnResponse callback_;
         const char* method_;
         const char* pathAndQuery_;
@@ -43,8 +59,11 @@ public:
 
 #define SET_PARAM(Name) Request& Name(const decltype(Request::Name ## _)& x) { Name ## _ = x; return *this; }
         SET_PARAM(id)
+        SET_PARAM(keepAlive)
+        SET_PARAM(idempotent)
         SET_PARAM(address)
         SET_PARAM(connectTimeoutMsec)
+        SET_PARAM(responseTimeoutMsec)
         SET_PARAM(callback)
         SET_PARAM(method)
         SET_PARAM(pathAndQuery)
@@ -77,7 +96,7 @@ public:
         Request() { reset(); }
 
         void reset() {
-            id(0).address(io::Address()).connectTimeoutMsec(10000).callback(OnResponse())
+            id(0).keepAlive(false).idempotent(false).address(io::Address()).connectTimeoutMsec(10000).responseTimeoutMsec(30000).callback(OnResponse())
                 .method("GET").pathAndQuery(0).headers(0).numHeaders(0).contentType("");
             body_.clear();
         }
@@ -94,14 +113,65 @@ public:
 
     ~HttpClient();
 
-    /// Sends request asynchronously, Returns connection ID (>0) or error
+    /// Sends request asynchronously, Returns connection ID (>0) or error.
+    /// For keep-alive requests the ID identifies the request, callbacks are called with it
     expected<uint64_t, io::ErrorCode> send_request(const Request& request);
 
     /// Cancels request, MUST be called if the caller goes out of scope
     void cancel_request(uint64_t id);
 
 private:
+    /// Keep-alive request waiting for the response
+    struct PooledRequest {
+        uint64_t id=0;
+        OnResponse callback;
+
+        /// Kept to be resent once if the reused connection is closed before the response
+        io::SerializedMsg msg;
+        bool idempotent=false;
+        bool retried=false;
+
+        unsigned timeoutMsec=0;
+        uint64_t deadline=0; // 0 if none
+    };
+
+    /// Keep-alive connection, responses come in the order of the requests
+    struct PooledConnection {
+        io::Address address;
+        unsigned connectTimeoutMsec=0;
+
+        /// Null while connecting
+        HttpConnection::Ptr conn;
+
+        std::deque<PooledRequest> inFlight;
+
+        /// Expires at the deadline of the 1st request in flight, the responses come in order
+        io::Timer::Ptr timer;
+
+        /// Responses received, pipelining starts after the 1st one
+        unsigned nResponses=0;
+
+        /// The server closes the connection after the current response
+        bool closing=false;
+
+        uint64_t lastUsed=0;
+    };
+
+    expected<uint64_t, io::ErrorCode> send_pooled_request(const Request& request);
+    io::Result dispatch(const io::Address& address, unsigned connectTimeoutMsec, PooledRequest&& request);
+    void close_idle_connections();
+    bool on_pooled_response(uint64_t id, const HttpMsgReader::Message& msg);
+    void start_response_timer(uint64_t id, PooledConnection& pc);
+    void on_response_timeout(uint64_t id);
+
+    enum class Resend {
+        None,
+        Idempotent, // the connection is lost, the requests in flight might have been processed
+        All // the server closed the connection, it doesn't process the rest of the pipeline
+    };
 
+    /// Removes the connection, the requests in flight are resent or get the error
+    void close_pooled_connection(std::map<uint64_t, PooledConnection>::iterator it, const HttpMsgReader::Message& error, Resend resend);
 
     void on_connected(uint64_t tag, io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode);
 
@@ -116,6 +186,7 @@ private:
     io::Reactor& _reactor;
     HttpMsgCreator _msgCreator;
     std::map<uint64_t, Ctx> _connections;
+    std::map<uint64_t, PooledConnection> _pool;
     std::map<uint64_t, uint64_t> _pendingConnections;
     uint64_t _idCounter;
 };
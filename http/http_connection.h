@@ -43,7 +43,7 @@ public:
     {
         _stream->enable_read(
             [this](io::ErrorCode what, void* data, size_t size) -> bool
-            { return _msgReader.new_data_from_stream(what, data, size); }
+            { return on_data(what, data, size); }
         );
     }
 
@@ -51,6 +51,17 @@ public:
     void change_id(uint64_t newId) override { _msgReader.change_id(newId); }
 
 private:
+    /// Responses written with flush=false from the callback go out together,
+    /// after all the pipelined messages of the chunk are processed
+    bool on_data(io::ErrorCode what, void* data, size_t size) {
+        if (!_msgReader.new_data_from_stream(what, data, size)) {
+            // the object may be deleted here
+            return false;
+        }
+        flush();
+        return true;
+    }
+
     HttpMsgReader _msgReader;
 };
 
@@ -149,6 +149,21 @@ inline bool equal_ci(const char* a, const char* b, size_t sz) {
     return true;
 }
 
+// Whether the comma-separated header value contains the token, case-insensitive
+bool has_token(const std::string& value, const char* lowerCaseToken) {
+    size_t sz = strlen(lowerCaseToken);
+    string_view s(value);
+    while (!s.empty()) {
+        string_view tail;
+        split(s, ',', tail);
+        while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+        while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+        if (s.size() == sz && equal_ci(lowerCaseToken, s.data(), sz)) return true;
+        s = tail;
+    }
+    return false;
+}
+
 struct HeadersParserStuff {
     enum State { incompleted, request_parsed, response_parsed };
 
@@ -305,6 +320,14 @@ private:
         return response_status;
     }
 
+    bool keep_alive() const override {
+        if (headers_state == incompleted) return false;
+        static const std::string connection("connection");
+        const std::string& value = get_header(connection);
+        if (has_token(value, "close")) return false;
+        return minor_http_version >= 1 || has_token(value, "keep-alive");
+    }
+
 public:
     std::vector<uint8_t> _body;
     size_t _bodyCursor=0;
@@ -56,6 +56,10 @@ public:
     virtual const std::string& get_header(const std::string& headerName) const = 0;
     virtual const void* get_body(size_t& size) const = 0;
     virtual int get_status() const = 0;
+
+    /// Whether the connection persists after the message: HTTP/1.1 unless "Connection: close",
+    /// HTTP/1.0 with "Connection: keep-alive" only
+    virtual bool keep_alive() const = 0;
 };
 
 /// Extracts individual http messages from stream, performs header/size validation
@@ -93,7 +97,8 @@ public:
     void change_id(uint64_t newStreamId) { _streamId = newStreamId; }
 
     /// Called from the stream on new data.
-    /// Calls the callback whenever a new message is exctracted or on errors
+    /// Calls the callback whenever a new message is exctracted or on errors,
+    /// pipelined messages are passed in order
     bool new_data_from_stream(io::ErrorCode connectionStatus, const void* data, size_t size);
 
     /// Resets to initial state
@@ -14,6 +14,7 @@
 
 #include "http/http_client.h"
 #include "utility/io/timer.h"
+#include "utility/io/tcpserver.h"
 #include "utility/helpers.h"
 #include "utility/logger.h"
 
@@ -109,6 +110,170 @@ namespace {
         return nErrors;
     }
 
+    // A reused keep-alive connection is lost while 2 requests are in flight:
+    // only the idempotent one is resent, the other one gets the error
+    int pooled_resend_test() {
+        int nErrors = 0;
+
+        try {
+            io::Reactor::Ptr reactor = io::Reactor::create();
+
+            static const char response[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\nok";
+
+            struct Peer {
+                io::TcpStream::Ptr stream;
+                std::string received;
+                unsigned nRequests=0;
+            };
+
+            std::map<uint64_t, Peer> peers;
+            uint64_t nConnections = 0;
+
+            io::Address address = io::Address::localhost().port(20000);
+            io::TcpServer::Ptr server = io::TcpServer::create(*reactor, address,
+                [&](io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode) {
+                    if (errorCode != io::EC_OK) return;
+                    uint64_t peerId = ++nConnections;
+                    Peer& peer = peers[peerId];
+                    peer.stream = std::move(newStream);
+                    peer.stream->enable_read([&, peerId](io::ErrorCode errorCode, void* data, size_t size) -> bool {
+                        Peer& peer = peers[peerId];
+                        if (errorCode != io::EC_OK) {
+                            peer.stream.reset();
+                            return false;
+                        }
+                        peer.received.append((const char*)data, size);
+                        for (size_t pos; (pos = peer.received.find("\r\n\r\n")) != std::string::npos; ) {
+                            peer.received.erase(0, pos + 4);
+                            if (peerId == 1 && peer.nRequests++ > 0) {
+                                // the 1st connection is dropped after the 1st response
+                                peer.stream.reset();
+                                return false;
+                            }
+                            peer.stream->write(response, sizeof(response) - 1);
+                        }
+                        return true;
+                    });
+                }
+            );
+
+            HttpClient client(*reactor);
+
+            std::map<uint64_t, bool> results; // id -> succeeded
+            auto onResponse = [&](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
+                results[id] = (msg.what == HttpMsgReader::http_message);
+                if (results.size() == 3) {
+                    reactor->stop();
+                }
+                return true;
+            };
+
+            HttpClient::Request request;
+            request.address(address).keepAlive(true).pathAndQuery("/").callback(onResponse);
+
+            uint64_t idFirst = 0, idIdempotent = 0, idOther = 0;
+
+            auto res = client.send_request(request.idempotent(true));
+            if (res) idFirst = *res;
+
+            io::Timer::Ptr timer = io::Timer::create(*reactor);
+            timer->start(100, false, [&] {
+                // the 1st response is received, the next requests are pipelined over the same connection
+                auto res = client.send_request(request.idempotent(true));
+                if (res) idIdempotent = *res;
+                res = client.send_request(request.idempotent(false));
+                if (res) idOther = *res;
+
+                timer->start(5000, false, [&] { reactor->stop(); });
+            });
+
+            reactor->run();
+
+            if (!idFirst || !idIdempotent || !idOther) ++nErrors;
+            if (!results[idFirst]) ++nErrors;
+            if (!results[idIdempotent]) ++nErrors;
+            if (results.find(idOther) == results.end() || results[idOther]) ++nErrors;
+            if (nConnections != 2) ++nErrors;
+        } catch (const std::exception& e) {
+            LOG_ERROR() << e.what();
+            nErrors = 255;
+        }
+
+        return nErrors;
+    }
+
+    // The server doesn't answer on the 1st connection: the request times out, the connection is closed
+    // and the next request goes over a new one
+    int pooled_timeout_test() {
+        int nErrors = 0;
+
+        try {
+            io::Reactor::Ptr reactor = io::Reactor::create();
+
+            static const char response[] = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: keep-alive\r\n\r\nok";
+
+            std::map<uint64_t, io::TcpStream::Ptr> peers;
+            uint64_t nConnections = 0;
+
+            io::Address address = io::Address::localhost().port(20001);
+            io::TcpServer::Ptr server = io::TcpServer::create(*reactor, address,
+                [&](io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode) {
+                    if (errorCode != io::EC_OK) return;
+                    uint64_t peerId = ++nConnections;
+                    io::TcpStream::Ptr& stream = peers[peerId];
+                    stream = std::move(newStream);
+                    stream->enable_read([&, peerId](io::ErrorCode errorCode, void*, size_t) -> bool {
+                        if (errorCode != io::EC_OK) {
+                            peers[peerId].reset();
+                            return false;
+                        }
+                        if (peerId > 1) {
+                            // the 1st connection is stalled
+                            peers[peerId]->write(response, sizeof(response) - 1);
+                        }
+                        return true;
+                    });
+                }
+            );
+
+            HttpClient client(*reactor);
+
+            std::map<uint64_t, io::ErrorCode> results; // id -> EC_OK if succeeded
+            uint64_t idStalled = 0, idNext = 0;
+
+            HttpClient::Request request;
+            request.address(address).keepAlive(true).pathAndQuery("/").responseTimeoutMsec(300);
+            request.callback([&](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
+                results[id] = (msg.what == HttpMsgReader::http_message) ? io::EC_OK : msg.connectionError;
+                if (id == idStalled) {
+                    auto res = client.send_request(request);
+                    if (res) idNext = *res;
+                } else {
+                    reactor->stop();
+                }
+                return true;
+            });
+
+            auto res = client.send_request(request);
+            if (res) idStalled = *res;
+
+            io::Timer::Ptr timer = io::Timer::create(*reactor);
+            timer->start(5000, false, [&] { reactor->stop(); });
+
+            reactor->run();
+
+            if (!idStalled || !idNext) ++nErrors;
+            if (results.find(idStalled) == results.end() || results[idStalled] != io::EC_ETIMEDOUT) ++nErrors;
+            if (results.find(idNext) == results.end() || results[idNext] != io::EC_OK) ++nErrors;
+            if (nConnections != 2) ++nErrors; // not over the stalled connection
+        } catch (const std::exception& e) {
+            LOG_ERROR() << e.what();
+            nErrors = 255;
+        }
+
+        return nErrors;
+    }
+
 } //namespace
 
 int main() {
@@ -117,6 +282,9 @@ int main() {
     logLevel = LOG_LEVEL_VERBOSE;
 #endif
     auto logger = Logger::create(logLevel, logLevel);
-    return http_client_test();
+    int nErrors = http_client_test();
+    nErrors += pooled_resend_test();
+    nErrors += pooled_timeout_test();
+    return nErrors;
 }
 
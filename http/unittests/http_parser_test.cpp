@@ -160,6 +160,48 @@ int test_multiple() {
     }
 
     LOG_DEBUG() << __FUNCTION__ << TRACE(calls) << TRACE(corrupted);
+    if (calls != 1234) ++errors;
+
+    return REPORT(errors);
+}
+
+int test_keep_alive() {
+    static const struct {
+        const char* input;
+        bool keepAlive;
+    } cases[] = {
+        { "GET / HTTP/1.1\r\n\r\n", true },
+        { "GET / HTTP/1.1\r\nConnection: close\r\n\r\n", false },
+        { "GET / HTTP/1.1\r\nconnection: Upgrade, Close\r\n\r\n", false },
+        { "GET / HTTP/1.0\r\n\r\n", false },
+        { "GET / HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", true },
+        { "GET / HTTP/1.0\r\nConnection: keep-alives\r\n\r\n", false }
+    };
+
+    int errors = 0;
+    size_t i = 0;
+
+    HttpMsgReader reader(
+        HttpMsgReader::server,
+        1,
+        [&errors, &i](uint64_t, const HttpMsgReader::Message& m) -> bool {
+            if (m.what != HttpMsgReader::http_message) {
+                ++errors;
+                return false;
+            }
+            if (m.msg->keep_alive() != cases[i].keepAlive) {
+                LOG_ERROR() << "keep-alive mismatch " << TRACE(i);
+                ++errors;
+            }
+            return true;
+        },
+        100,
+        100
+    );
+
+    for (; i < sizeof(cases) / sizeof(cases[0]); ++i) {
+        reader.new_data_from_stream(io::EC_OK, cases[i].input, strlen(cases[i].input));
+    }
 
     return REPORT(errors);
 }
@@ -243,6 +285,7 @@ int main() {
         retCode += test_bodyless_request();
         retCode += test_request_with_body();
         retCode += test_multiple();
+        retCode += test_keep_alive();
         retCode += test_query_strings();
     } catch (const exception& e) {
         LOG_ERROR() << e.what();
@@ -16,6 +16,7 @@
 #include "core/shielded.h"
 #include "utility/logger.h"
 #include "utility/executor.h"
+#include <atomic>
 
 namespace beam::wallet
 {
@@ -27,6 +28,46 @@ namespace beam::wallet
     LocalPrivateKeyKeeper2::LocalPrivateKeyKeeper2(const Key::IKdf::Ptr& pKdf)
         :m_pKdf(pKdf)
     {
+        m_Parallel.m_Stop = false;
+    }
+
+    LocalPrivateKeyKeeper2::~LocalPrivateKeyKeeper2()
+    {
+        StopParallel();
+    }
+
+    void LocalPrivateKeyKeeper2::EnableParallel(const std::shared_ptr<Executor>& pExecutor)
+    {
+        m_Parallel.m_pExecutor = pExecutor;
+    }
+
+    void LocalPrivateKeyKeeper2::StopParallel()
+    {
+        m_Parallel.m_Stop = true;
+
+        std::unique_lock<std::mutex> scope(m_Parallel.m_Mutex);
+        while (m_Parallel.m_Pending)
+            m_Parallel.m_Idle.wait(scope);
+    }
+
+    void LocalPrivateKeyKeeper2::PushParallel(Executor::TaskAsync::Ptr&& pTask)
+    {
+        {
+            std::unique_lock<std::mutex> scope(m_Parallel.m_Mutex);
+            m_Parallel.m_Pending++;
+        }
+
+        m_Parallel.m_pExecutor->Push(std::move(pTask));
+    }
+
+    void LocalPrivateKeyKeeper2::OnParallelDone()
+    {
+        // must be the last access to this object from the worker thread
+        std::unique_lock<std::mutex> scope(m_Parallel.m_Mutex);
+
+        assert(m_Parallel.m_Pending);
+        if (!--m_Parallel.m_Pending)
+            m_Parallel.m_Idle.notify_all();
     }
 
     IPrivateKeyKeeper2::Status::Type LocalPrivateKeyKeeper2::ToImage(Point::Native& res, uint32_t iGen, const Scalar::Native& sk)
@@ -109,6 +150,7 @@ namespace beam::wallet
 
         bool Aggregate(const Method::TxCommon&);
         bool Aggregate(const std::vector<CoinID>&, bool bOuts);
+        void AggregateKeys(const std::vector<CoinID>&);
         bool Aggregate(const std::vector<ShieldedInput>&);
 
         bool ValidateSend();
@@ -161,14 +203,12 @@ namespace beam::wallet
     {
         Values& vals = bOuts ? m_Outs : m_Ins;
 
-        Scalar::Native sk;
+        AggregateKeys(v);
+
         for (size_t i = 0; i < v.size(); i++)
         {
             const CoinID& cid = v[i];
 
-            CoinID::Worker(cid).Create(sk, *cid.get_ChildKdf(m_This.m_pKdf));
-            m_sk += sk;
-
             if (m_NonConventional)
                 continue; // ignore values
 
@@ -198,6 +238,64 @@ namespace beam::wallet
         return true;
     }
 
+    void LocalPrivateKeyKeeper2::Aggregation::AggregateKeys(const std::vector<CoinID>& v)
+    {
+        // Each key derivation involves a switch commitment, for large txs (payouts, consolidations) derive them in parallel.
+        // No threads are created here: the keeper pool is used if enabled, otherwise the executor of the caller thread (if any)
+        const uint32_t nParallelMin = 64;
+
+        Executor* pPool = m_This.m_Parallel.m_pExecutor.get();
+        if (!pPool)
+            pPool = Executor::s_pInstance;
+
+        if ((v.size() < nParallelMin) || !pPool)
+        {
+            Scalar::Native sk;
+            for (const auto& cid : v)
+            {
+                CoinID::Worker(cid).Create(sk, *cid.get_ChildKdf(m_This.m_pKdf));
+                m_sk += sk;
+            }
+            return;
+        }
+
+        struct MyTask
+            :public Executor::TaskSync
+        {
+            const std::vector<CoinID>* m_pV;
+            const Key::IKdf::Ptr* m_ppKdf;
+            std::vector<Scalar::Native> m_vSum; // per thread
+
+            virtual void Exec(Executor::Context& ctx) override
+            {
+                uint32_t i0, nCount;
+                ctx.get_Portion(i0, nCount, static_cast<uint32_t>(m_pV->size()));
+
+                Scalar::Native& sum = m_vSum[ctx.m_iThread];
+                sum = Zero;
+
+                Scalar::Native sk;
+                for (uint32_t i = 0; i < nCount; i++)
+                {
+                    const CoinID& cid = m_pV->at(i0 + i);
+                    CoinID::Worker(cid).Create(sk, *cid.get_ChildKdf(*m_ppKdf));
+                    sum += sk;
+                }
+            }
+        };
+
+        MyTask t;
+        t.m_pV = &v;
+        t.m_ppKdf = &m_This.m_pKdf;
+
+        ExecutorOnPool exec(*pPool); // safe on the pool threads as well
+        t.m_vSum.resize(exec.get_Threads());
+        exec.ExecAll(t);
+
+        for (const auto& sum : t.m_vSum)
+            m_sk += sum;
+    }
+
     bool LocalPrivateKeyKeeper2::Aggregation::Aggregate(const std::vector<ShieldedInput>& v)
     {
         Values& vals = m_Ins;
@@ -283,6 +381,150 @@ namespace beam::wallet
         return Status::Success;
     }
 
+    template <typename TMethod>
+    void LocalPrivateKeyKeeper2::InvokeAsyncParallel(TMethod& x, const Handler::Ptr& pHandler)
+    {
+        if (!m_Parallel.m_pExecutor)
+        {
+            PrivateKeyKeeper_AsyncNotify::InvokeAsync(x, pHandler);
+            return;
+        }
+
+        struct MyTask
+            :public Executor::TaskAsync
+        {
+            LocalPrivateKeyKeeper2* m_pThis;
+            TMethod* m_pM; // owned by the handler
+            Task::Ptr m_pFin;
+
+            virtual void Exec(Executor::Context&) override
+            {
+                Cast::Up<TaskFin>(*m_pFin).m_Status = m_pThis->m_Parallel.m_Stop ?
+                    Status::UserAbort :
+                    m_pThis->InvokeSync(*m_pM);
+
+                m_pThis->PushOut(m_pFin); // the handler is released on the caller thread only
+                m_pThis->OnParallelDone();
+            }
+        };
+
+        EnsureEvtOut(); // must be created on the caller thread
+
+        std::unique_ptr<MyTask> pTask = std::make_unique<MyTask>();
+        pTask->m_pThis = this;
+        pTask->m_pM = &x;
+        pTask->m_pFin.reset(new TaskFin);
+        pTask->m_pFin->m_pHandler = pHandler;
+
+        PushParallel(std::move(pTask));
+    }
+
+    void LocalPrivateKeyKeeper2::InvokeAsync(Method::CreateOutput& x, const Handler::Ptr& pHandler)
+    {
+        InvokeAsyncParallel(x, pHandler);
+    }
+
+    void LocalPrivateKeyKeeper2::InvokeAsync(Method::CreateInputShielded& x, const Handler::Ptr& pHandler)
+    {
+        InvokeAsyncParallel(x, pHandler);
+    }
+
+    void LocalPrivateKeyKeeper2::InvokeAsyncBatch(std::vector<Method::CreateOutput>& v, const Handler::Ptr& pHandler)
+    {
+        assert(!v.empty());
+
+        if (!m_Parallel.m_pExecutor)
+        {
+            Status::Type res = Status::Success;
+            for (size_t i = 0; (i < v.size()) && (Status::Success == res); i++)
+                res = InvokeSync(v[i]);
+
+            PushOut(res, pHandler);
+            return;
+        }
+
+        struct Batch
+        {
+            std::atomic<uint32_t> m_Pending;
+            std::atomic<Status::Type> m_Status;
+            Task::Ptr m_pFin;
+
+            // progress is reported in steps, each is posted before the task is accounted in m_Pending, hence before m_pFin.
+            // Counted and posted under the mutex, to keep the order
+            std::mutex m_MutexProgress;
+            uint32_t m_Done;
+            uint32_t m_Total;
+            uint32_t m_Step;
+        };
+
+        struct MyTask
+            :public Executor::TaskAsync
+        {
+            LocalPrivateKeyKeeper2* m_pThis;
+            std::shared_ptr<Batch> m_pBatch;
+            Method::CreateOutput* m_pM; // owned by the handler
+            uint32_t m_Count;
+
+            virtual void Exec(Executor::Context&) override
+            {
+                Batch& b = *m_pBatch;
+                for (uint32_t i = 0; (i < m_Count) && (Status::Success == b.m_Status); i++)
+                {
+                    Status::Type res = m_pThis->m_Parallel.m_Stop ?
+                        Status::UserAbort :
+                        m_pThis->InvokeSync(m_pM[i]);
+
+                    if (Status::Success != res)
+                        b.m_Status = res;
+                    else
+                    {
+                        std::unique_lock<std::mutex> scope(b.m_MutexProgress);
+                        uint32_t nDone = ++b.m_Done;
+                        if (!(nDone % b.m_Step) && (nDone < b.m_Total))
+                            m_pThis->PushProgress(nDone, b.m_Total, b.m_pFin->m_pHandler); // m_pFin is still here
+                    }
+                }
+
+                if (!--b.m_Pending)
+                {
+                    // the last one
+                    Cast::Up<TaskFin>(*b.m_pFin).m_Status = b.m_Status;
+                    m_pThis->PushOut(b.m_pFin);
+                }
+
+                m_pThis->OnParallelDone();
+            }
+        };
+
+        EnsureEvtOut(); // must be created on the caller thread
+
+        uint32_t nTotal = static_cast<uint32_t>(v.size());
+        uint32_t nTasks = std::min(nTotal, m_Parallel.m_pExecutor->get_Threads());
+
+        auto pBatch = std::make_shared<Batch>();
+        pBatch->m_Pending = nTasks;
+        pBatch->m_Status = Status::Success;
+        pBatch->m_pFin.reset(new TaskFin);
+        pBatch->m_pFin->m_pHandler = pHandler;
+        pBatch->m_Done = 0;
+        pBatch->m_Total = nTotal;
+        pBatch->m_Step = std::max(nTotal / 16, 1U);
+
+        for (uint32_t iTask = 0, i0 = 0; iTask < nTasks; iTask++)
+        {
+            uint32_t i1 = static_cast<uint32_t>(uint64_t(nTotal) * (iTask + 1) / nTasks);
+
+            std::unique_ptr<MyTask> pTask = std::make_unique<MyTask>();
+            pTask->m_pThis = this;
+            pTask->m_pBatch = pBatch;
+            pTask->m_pM = &v[i0];
+            pTask->m_Count = i1 - i0;
+
+            PushParallel(std::move(pTask));
+            i0 = i1;
+        }
+    }
+
     IPrivateKeyKeeper2::Status::Type LocalPrivateKeyKeeper2::InvokeSync(Method::CreateInputShielded& x)
     {
         assert(x.m_pKernel && x.m_pList);
@@ -315,8 +557,18 @@ namespace beam::wallet
         x.m_pKernel->UpdateMsg();
         x.get_SkOut(prover.m_Witness.V.m_R_Output, x.m_pKernel->m_Fee, *m_pKdf);
 
-        ExecutorMT exec;
-        Executor::Scope scope(exec);
+        // the proof is split across the threads: the keeper pool if enabled (this may be one of its threads),
+        // otherwise the executor of the caller thread, otherwise a temporary one
+        std::unique_ptr<Executor> pExec;
+        if (m_Parallel.m_pExecutor)
+            pExec = std::make_unique<ExecutorOnPool>(*m_Parallel.m_pExecutor);
+        else if (!Executor::s_pInstance)
+            pExec = std::make_unique<ExecutorMT>();
+
+        std::unique_ptr<Executor::Scope> pScope;
+        if (pExec)
+            pScope = std::make_unique<Executor::Scope>(*pExec);
+
         x.m_pKernel->Sign(prover, x.m_AssetID);
 
         return Status::Success;
@@ -719,6 +971,11 @@ namespace beam::wallet
     {
     }
 
+    LocalPrivateKeyKeeperStd::~LocalPrivateKeyKeeperStd()
+    {
+        StopParallel();
+    }
+
     IPrivateKeyKeeper2::Slot::Type LocalPrivateKeyKeeperStd::get_NumSlots()
     {
         return m_numSlots;
@@ -16,7 +16,9 @@
 
 #include "wallet/core/private_key_keeper.h"
 #include "wallet/core/variables_db.h"
+#include "utility/executor.h"
 #include <utility>
+#include <atomic>
 
 namespace beam::wallet
 {
@@ -34,6 +36,7 @@ namespace beam::wallet
     public:
 
         LocalPrivateKeyKeeper2(const ECC::Key::IKdf::Ptr&);
+        ~LocalPrivateKeyKeeper2();
 
 #define THE_MACRO(method) \
         virtual Status::Type InvokeSync(Method::method& m) override;
@@ -41,6 +44,18 @@ namespace beam::wallet
         KEY_KEEPER_METHODS(THE_MACRO)
 #undef THE_MACRO
 
+        using PrivateKeyKeeper_AsyncNotify::InvokeAsync;
+        void InvokeAsync(Method::CreateOutput&, const Handler::Ptr&) override;
+        void InvokeAsync(Method::CreateInputShielded&, const Handler::Ptr&) override;
+        // split across the thread pool (if enabled), single completion notification
+        void InvokeAsyncBatch(std::vector<Method::CreateOutput>&, const Handler::Ptr&) override;
+
+        // Offload the heavy stateless methods (outputs with bulletproofs, shielded inputs with the spend proof) to the thread pool,
+        // so that they don't block the caller thread, and multiple transactions are built in parallel.
+        // Methods that use nonce slots are always executed inline.
+        // Disabled by default (everything is executed inline). The pool may be shared by several keepers, only async tasks are pushed to it.
+        void EnableParallel(const std::shared_ptr<Executor>&);
+
     protected:
 
         ECC::Key::IKdf::Ptr m_pKdf;
@@ -54,6 +69,25 @@ namespace beam::wallet
         virtual bool IsTrustless() { return false; }
         virtual Status::Type ConfirmSpend(Amount, Asset::ID, const PeerID&, const TxKernel&, Amount totalFee, bool bFinal) { return Status::Success; }
 
+        // Aborts the queued jobs of this keeper and waits for those in progress. The jobs call virtual methods,
+        // hence it must be called by the most derived class d'tor (the base d'tor calls it too, as the last resort)
+        void StopParallel();
+
+    private:
+        struct Parallel
+        {
+            std::shared_ptr<Executor> m_pExecutor;
+            std::atomic<bool> m_Stop;
+            uint32_t m_Pending = 0; // pushed and not finished yet
+            std::mutex m_Mutex;
+            std::condition_variable m_Idle;
+        } m_Parallel;
+
+        void PushParallel(Executor::TaskAsync::Ptr&&);
+        void OnParallelDone();
+
+        template <typename TMethod>
+        void InvokeAsyncParallel(TMethod&, const Handler::Ptr&);
     };
 
     class LocalPrivateKeyKeeperStd
@@ -77,6 +111,7 @@ namespace beam::wallet
         } m_State;
 
         LocalPrivateKeyKeeperStd(const ECC::Key::IKdf::Ptr& pkdf, const Slot::Type numSlots = s_DefNumSlots);
+        ~LocalPrivateKeyKeeperStd();
 
     protected:
         virtual Slot::Type get_NumSlots() override;
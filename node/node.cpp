@@ -62,6 +62,101 @@ void Node::RefreshCongestions()
     }
 }
 
+template <typename TMsg>
+void Node::SendShared(Peer& peer, io::SharedBuffer& frame, const TMsg& msg)
+{
+	if (frame.empty())
+	{
+		if (!peer.IsLive())
+			return;
+
+		peer.SerializeShared(frame, msg);
+		m_BroadcastStats.m_BytesSerialized += frame.size;
+	}
+
+	SendShared(peer, frame);
+}
+
+void Node::SendShared(Peer& peer, const io::SharedBuffer& frame)
+{
+	m_BroadcastStats.m_BytesSent += peer.SendShared(frame);
+}
+
+bool Node::BodyCache::Key::operator < (const Key& x) const
+{
+	return
+		std::tie(m_Row, m_Height0, m_HorizonLo1, m_HorizonHi1, m_FlagP, m_FlagE) <
+		std::tie(x.m_Row, x.m_Height0, x.m_HorizonLo1, x.m_HorizonHi1, x.m_FlagP, x.m_FlagE);
+}
+
+size_t Node::BodyCache::Element::get_Size() const
+{
+	return sizeof(*this) + m_Body.m_Eternal.size() + m_Body.m_Perishable.size();
+}
+
+bool Node::BodyCache::Find(proto::BodyBuffers& out, const Key& key)
+{
+	Element::Data d;
+	d.m_Key = key;
+
+	DataSet::iterator it = m_setData.find(d);
+	if (m_setData.end() == it)
+	{
+		m_Misses++;
+		return false;
+	}
+
+	m_Hits++;
+
+	Element& x = it->get_ParentObj();
+	m_lstMru.erase(MruList::s_iterator_to(x.m_Mru));
+	m_lstMru.push_front(x.m_Mru);
+
+	out = x.m_Body;
+	return true;
+}
+
+void Node::BodyCache::Add(const proto::BodyBuffers& body, const Key& key, size_t nMaxSize)
+{
+	Element* pElem = new Element;
+	pElem->m_Body = body;
+	pElem->m_Data.m_Key = key;
+
+	size_t nSize = pElem->get_Size();
+	if (nSize > nMaxSize)
+	{
+		delete pElem;
+		return;
+	}
+
+	while (m_TotalSize + nSize > nMaxSize)
+		Delete(m_lstMru.back().get_ParentObj());
+
+	m_setData.insert(pElem->m_Data);
+	m_lstMru.push_front(pElem->m_Mru);
+	m_TotalSize += nSize;
+}
+
+void Node::BodyCache::Delete(Element& x)
+{
+	m_TotalSize -= x.get_Size();
+	m_setData.erase(DataSet::s_iterator_to(x.m_Data));
+	m_lstMru.erase(MruList::s_iterator_to(x.m_Mru));
+	delete &x;
+}
+
+void Node::BodyCache::Clear()
+{
+	while (!m_lstMru.empty())
+		Delete(m_lstMru.front().get_ParentObj());
+}
+
+uint32_t Node::BodyCache::get_HitRate() const
+{
+	uint64_t nTotal = m_Hits + m_Misses;
+	return nTotal ? static_cast<uint32_t>(m_Hits * 100 / nTotal) : 0;
+}
+
 void Node::UpdateSyncStatus()
 {
 	SyncStatus stat = m_SyncStatus;
@@ -605,6 +700,8 @@ void Node::Processor::OnNewState()
     proto::NewTip msg;
     msg.m_Description = m_Cursor.m_Full;
 
+    io::SharedBuffer frame; // serialized once, on demand
+
     for (PeerList::iterator it = get_ParentObj().m_lstPeers.begin(); get_ParentObj().m_lstPeers.end() != it; it++)
     {
         Peer& peer = *it;
@@ -622,7 +719,7 @@ void Node::Processor::OnNewState()
 				continue;
 		}
 
-        peer.Send(msg);
+        get_ParentObj().SendShared(peer, frame, msg);
     }
 
     get_ParentObj().RefreshCongestions();
@@ -702,6 +799,8 @@ void Node::Processor::OnRolledBack()
 {
     LOG_INFO() << "Rolled back to: " << m_Cursor.m_ID;
 
+	get_ParentObj().m_BodyCache.Clear();
+
 	TxPool::Fluff& txp = get_ParentObj().m_TxPool;
     while (!txp.m_setOutdated.empty())
     {
@@ -875,6 +974,7 @@ Node::Peer* Node::AllocPeer(const beam::io::Address& addr)
     m_lstPeers.push_back(*pPeer);
 
 	pPeer->m_UnsentHiMark = m_Cfg.m_BandwidthCtl.m_Drown;
+	pPeer->m_pIoShards = m_pIoShards.get();
     pPeer->m_pInfo = NULL;
     pPeer->m_Flags = 0;
     pPeer->m_Port = 0;
@@ -941,6 +1041,9 @@ void Node::Initialize(IExternalPOW* externalPOW)
 	ZeroObject(m_SyncStatus);
     RefreshCongestions();
 
+    if (m_Cfg.m_IoThreads)
+        m_pIoShards = std::make_unique<IoShards>(m_Cfg.m_IoThreads);
+
     if (m_Cfg.m_Listen.port())
     {
         m_Server.Listen(m_Cfg.m_Listen);
@@ -1112,6 +1215,8 @@ void Node::Bbs::MaybeCleanup()
 Node::~Node()
 {
     LOG_INFO() << "Node stopping...";
+    LOG_INFO() << "Broadcast bytes serialized: " << m_BroadcastStats.m_BytesSerialized << ", sent: " << m_BroadcastStats.m_BytesSent;
+    LOG_INFO() << "Body cache hits: " << m_BodyCache.m_Hits << ", misses: " << m_BodyCache.m_Misses << " (" << m_BodyCache.get_HitRate() << "%)";
 
     m_Miner.HardAbortSafe();
 	if (m_Miner.m_External.m_pSolver)
@@ -1134,6 +1239,8 @@ Node::~Node()
     while (!m_lstPeers.empty())
         m_lstPeers.front().DeleteSelf(false, proto::NodeConnection::ByeReason::Stopping);
 
+    m_pIoShards.reset(); // after the connections are closed
+
     while (!m_lstTasksUnassigned.empty())
         DeleteUnassignedTask(m_lstTasksUnassigned.front());
 
@@ -1779,12 +1886,17 @@ bool Node::DecodeAndCheckHdrs(std::vector<Block::SystemState::Full>& v, const pr
 		s1.m_ChainWork = s0.m_ChainWork + s1.m_PoW.m_Difficulty;
 	}
 
+	// Heights are consecutive, the sanity check (genesis/prehistoric) is relevant for the first header only.
+	// Do it before the heavy part.
+	if (!v.front().IsSane())
+		return false;
+
 	struct MyTask
 		:public Executor::TaskSync
 	{
 		const Block::SystemState::Full* m_pV;
 		uint32_t m_Count;
-		bool m_Valid;
+		std::atomic<bool> m_Valid;
 
 		virtual ~MyTask() {}
 
@@ -1794,9 +1906,10 @@ bool Node::DecodeAndCheckHdrs(std::vector<Block::SystemState::Full>& v, const pr
             ctx.get_Portion(i0, nCount, m_Count);
             nCount += i0;
 
-			for (; i0 < nCount; i0++)
-				if (!m_pV[i0].IsValid())
-					m_Valid = false;
+			// abort as soon as any thread encounters an invalid header
+			for (; (i0 < nCount) && m_Valid.load(std::memory_order_relaxed); i0++)
+				if (!m_pV[i0].IsValidPoW())
+					m_Valid.store(false, std::memory_order_relaxed);
 		}
 	};
 
@@ -1807,7 +1920,7 @@ bool Node::DecodeAndCheckHdrs(std::vector<Block::SystemState::Full>& v, const pr
 
     m_Processor.m_ExecutorMT.ExecAll(t);
 
-	return t.m_Valid;
+	return t.m_Valid.load();
 }
 
 void Node::Peer::OnMsg(proto::HdrPack&& msg)
@@ -1966,7 +2079,29 @@ bool Node::Peer::GetBlock(proto::BodyBuffers& out, const NodeDB::StateID& sid, c
 		ThrowUnexpected();
 	}
 
-	if (!m_This.m_Processor.GetBlock(sid, pE, pP, msg.m_Height0, msg.m_HorizonLo1, msg.m_HorizonHi1, bActive))
+	// The body of an active block is stable as long as no more outputs can be spent within the requested horizon,
+	// i.e. new blocks may only spend them above it. Rollback invalidates the cache.
+	Processor& p = m_This.m_Processor; // alias
+	bool bCacheable =
+		bActive &&
+		m_This.m_Cfg.m_BandwidthCtl.m_BodyCacheSize &&
+		(std::max(msg.m_HorizonHi1, sid.m_Height) <= p.m_Cursor.m_ID.m_Height);
+
+	BodyCache::Key key;
+	if (bCacheable)
+	{
+		key.m_Row = sid.m_Row;
+		key.m_Height0 = msg.m_Height0;
+		key.m_HorizonLo1 = msg.m_HorizonLo1;
+		key.m_HorizonHi1 = msg.m_HorizonHi1;
+		key.m_FlagP = msg.m_FlagP;
+		key.m_FlagE = msg.m_FlagE;
+
+		if (m_This.m_BodyCache.Find(out, key))
+			return true;
+	}
+
+	if (!p.GetBlock(sid, pE, pP, msg.m_Height0, msg.m_HorizonLo1, msg.m_HorizonHi1, bActive))
 		return false;
 
 	if (proto::BodyBuffers::Recovery1 == msg.m_FlagP)
@@ -1988,6 +2123,9 @@ bool Node::Peer::GetBlock(proto::BodyBuffers& out, const NodeDB::StateID& sid, c
 		ser.swap_buf(out.m_Perishable);
 	}
 
+	if (bCacheable)
+		m_This.m_BodyCache.Add(out, key, m_This.m_Cfg.m_BandwidthCtl.m_BodyCacheSize);
+
 	return true;
 }
 
@@ -2934,7 +3072,17 @@ void Node::Peer::OnMsg(proto::GetTransaction&& msg)
     if (m_This.m_TxPool.m_setTxs.end() == it)
         return; // don't have it
 
-    SendTx(it->get_ParentObj().m_pValue, true);
+    TxPool::Fluff::Element& x = it->get_ParentObj();
+    if (x.m_Frame.empty())
+    {
+        proto::NewTransaction msgOut;
+        msgOut.m_Fluff = true;
+
+        TemporarySwap scope(msgOut.m_Transaction, x.m_pValue);
+        m_This.SendShared(*this, x.m_Frame, msgOut);
+    }
+    else
+        m_This.SendShared(*this, x.m_Frame);
 }
 
 void Node::Peer::SendTx(Transaction::Ptr& ptx, bool bFluff)
@@ -84,6 +84,11 @@ struct Node
 		// negative: number of cores minus number of mining threads.
 		int m_VerificationThreads = 0;
 
+		// Number of I/O threads for peer connections. Once the secure channel is established, the connection
+		// is moved to one of them (reading, decryption, framing). The messages are still processed on the main thread.
+		// 0: all on the main thread
+		uint32_t m_IoThreads = 0;
+
 		struct RollbackLimit
 		{
 			Height m_Max = 60; // artificial restriction on how much the node will rollback automatically
@@ -121,6 +126,8 @@ struct Node
 			size_t m_MaxBodyPackSize = 1024 * 1024 * 5;
 			uint32_t m_MaxBodyPackCount = 3000;
 
+			size_t m_BodyCacheSize = 1024 * 1024 * 64; // ready-to-send bodies, for serving syncing peers. 0 to disable
+
 		} m_BandwidthCtl;
 
 		struct TestMode {
@@ -200,6 +207,70 @@ struct Node
 	uint32_t get_AcessiblePeerCount() const; // all the peers with known addresses. Including temporarily banned
     const PeerManager::AddrSet& get_AcessiblePeerAddrs() const;
 
+	struct BroadcastStats
+	{
+		uint64_t m_BytesSerialized = 0; // frames serialized once for the fan-out
+		uint64_t m_BytesSent = 0; // their per-peer encrypted copies
+
+	} m_BroadcastStats;
+
+	struct BodyCache
+	{
+		struct Key
+		{
+			uint64_t m_Row;
+			Height m_Height0;
+			Height m_HorizonLo1;
+			Height m_HorizonHi1;
+			uint8_t m_FlagP;
+			uint8_t m_FlagE;
+
+			bool operator < (const Key&) const;
+		};
+
+		struct Element
+		{
+			proto::BodyBuffers m_Body;
+
+			struct Data
+				:public boost::intrusive::set_base_hook<>
+			{
+				Key m_Key;
+
+				bool operator < (const Data& x) const { return m_Key < x.m_Key; }
+				IMPLEMENT_GET_PARENT_OBJ(Element, m_Data)
+			} m_Data;
+
+			struct Mru
+				:public boost::intrusive::list_base_hook<>
+			{
+				IMPLEMENT_GET_PARENT_OBJ(Element, m_Mru)
+			} m_Mru;
+
+			size_t get_Size() const;
+		};
+
+		typedef boost::intrusive::multiset<Element::Data> DataSet;
+		typedef boost::intrusive::list<Element::Mru> MruList;
+
+		DataSet m_setData;
+		MruList m_lstMru; // most recently used first
+		size_t m_TotalSize = 0;
+
+		uint64_t m_Hits = 0;
+		uint64_t m_Misses = 0;
+
+		uint32_t get_HitRate() const; // percent of the lookups served from the cache
+
+		bool Find(proto::BodyBuffers&, const Key&);
+		void Add(const proto::BodyBuffers&, const Key&, size_t nMaxSize);
+		void Delete(Element&);
+		void Clear();
+
+		~BodyCache() { Clear(); }
+
+	} m_BodyCache; // cleared on rollback
+
 	bool m_UpdatedFromPeers = false;
 	bool m_PostStartSynced = false;
 
@@ -272,6 +343,10 @@ private:
 
 	struct Peer;
 
+	template <typename TMsg>
+	void SendShared(Peer&, io::SharedBuffer& frame, const TMsg&); // serializes the frame if empty
+	void SendShared(Peer&, const io::SharedBuffer& frame);
+
 	struct Task
 		:public boost::intrusive::set_base_hook<>
 		,public boost::intrusive::list_base_hook<>
@@ -604,6 +679,8 @@ private:
 	typedef boost::intrusive::list<Peer> PeerList;
 	PeerList m_lstPeers;
 
+	std::unique_ptr<IoShards> m_pIoShards;
+
 	ECC::NoLeak<ECC::uintBig> m_NonceLast;
 	const ECC::uintBig& NextNonce();
 	void NextNonce(ECC::Scalar::Native&);
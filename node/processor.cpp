@@ -2523,33 +2523,37 @@ void NodeProcessor::Recognize(const TxKernelShieldedOutput& v, Height h, uint32_
 
 	ViewerKeys vk;
 	get_ViewerKeys(vk);
+	if (!vk.m_nSh)
+		return;
 
-	for (Key::Index nIdx = 0; nIdx < vk.m_nSh; nIdx++)
-	{
-		const ShieldedTxo& txo = v.m_Txo;
+	// test all the viewers at once
+	const ShieldedTxo& txo = v.m_Txo;
+	const ShieldedTxo::Ticket* pTicket = &txo.m_Ticket;
 
-		ShieldedTxo::Data::Params pars;
-		if (!pars.m_Ticket.Recover(txo.m_Ticket, vk.m_pSh[nIdx]))
-			continue;
+	ShieldedTxo::Data::TicketParams::Scanner::Result res;
+	ShieldedTxo::Data::TicketParams::Scanner::Scan(&res, &pTicket, 1, vk.m_pSh, vk.m_nSh);
+	if (res.m_iViewer >= vk.m_nSh)
+		return;
 
-		ECC::Oracle oracle;
-		oracle << v.m_Msg;
+	ShieldedTxo::Data::Params pars;
+	pars.m_Ticket = res.m_Params;
 
-		if (!pars.m_Output.Recover(txo, pars.m_Ticket.m_SharedSecret, oracle))
-			continue;
+	ECC::Oracle oracle;
+	oracle << v.m_Msg;
+
+	if (!pars.m_Output.Recover(txo, pars.m_Ticket.m_SharedSecret, oracle))
+		return;
 
-		proto::Event::Shielded evt;
-		evt.m_TxoID = nID;
-		pars.ToID(evt.m_CoinID);
-		evt.m_CoinID.m_Key.m_nIdx = nIdx;
-		evt.m_Flags = proto::Event::Flags::Add;
+	proto::Event::Shielded evt;
+	evt.m_TxoID = nID;
+	pars.ToID(evt.m_CoinID);
+	evt.m_CoinID.m_Key.m_nIdx = res.m_iViewer;
+	evt.m_Flags = proto::Event::Flags::Add;
 
-		EventKey::Shielded key = pars.m_Ticket.m_SpendPk;
-		key.m_Y |= EventKey::s_FlagShielded;
+	EventKey::Shielded key = pars.m_Ticket.m_SpendPk;
+	key.m_Y |= EventKey::s_FlagShielded;
 
-		AddEvent(h, EventKey::s_IdxKernel + nKrnIdx, evt, key);
-		break;
-	}
+	AddEvent(h, EventKey::s_IdxKernel + nKrnIdx, evt, key);
 }
 
 void NodeProcessor::Recognize(const Output& x, Height h, Key::IPKdf& keyViewer)
@@ -102,6 +102,7 @@ void TxPool::Fluff::Delete(Element& x)
 void TxPool::Fluff::DeleteEmpty(Element& x)
 {
 	assert(!x.m_pValue);
+	x.m_Frame.clear(); // the element may still be referenced by the queue
 	InternalErase(x);
 	Release(x);
 }
@@ -18,6 +18,7 @@
 #include <boost/intrusive/list.hpp>
 #include "../core/block_crypt.h"
 #include "../utility/io/timer.h"
+#include "../utility/io/buffer.h"
 
 namespace beam {
 
@@ -39,6 +40,7 @@ struct TxPool
 		struct Element
 		{
 			Transaction::Ptr m_pValue;
+			io::SharedBuffer m_Frame; // serialized NewTransaction, created on the 1st request and shared by all the peers
 
 			struct Tx
 				:public boost::intrusive::set_base_hook<>
@@ -2661,9 +2661,15 @@ namespace beam
 		auto logger = beam::Logger::create(LOG_LEVEL_DEBUG, LOG_LEVEL_DEBUG);
 		node.PrintTxos();
 
+		Node::BodyCache::Key key;
+		ZeroObject(key);
+		node.m_BodyCache.Add(proto::BodyBuffers(), key, node.m_Cfg.m_BandwidthCtl.m_BodyCacheSize);
+		verify_test(!node.m_BodyCache.m_lstMru.empty());
+
 		NodeProcessor& proc = node.get_Processor();
 		proc.ManualRollbackTo(3);
 		verify_test(proc.m_Cursor.m_ID.m_Height >= 3); // it won't necessarily reach 3
+		verify_test(node.m_BodyCache.m_lstMru.empty() && !node.m_BodyCache.m_TotalSize); // cleared on rollback
 		verify_test(proc.m_sidForbidden.m_Height > Rules::HeightGenesis); // some rollback with forbidden state update must take place
 	}
 
@@ -2916,6 +2922,200 @@ namespace beam
 		verify_test(fc.m_bTip);
 		verify_test(fc.m_hRolledTo <= hBranch); // must rollback beyond the manually appended state
 		verify_test(!fc.m_Hist.m_Map.empty() && fc.m_Hist.m_Map.rbegin()->second.m_Height == hThrd2);
+
+		// several clients sharing the chain view and the connection
+		struct MySubscriber
+			:public proto::FlyClient
+		{
+			proto::FlyClientHub& m_Hub;
+			Block::SystemState::HistoryMap* m_pOwn = nullptr;
+			uint32_t m_nTips = 0;
+			bool m_bStop = true;
+
+			MySubscriber(proto::FlyClientHub& hub) :m_Hub(hub) {}
+
+			virtual Block::SystemState::IHistory& get_History() override
+			{
+				if (m_pOwn)
+					return *m_pOwn;
+				return m_Hub.get_History();
+			}
+
+			virtual void OnNewTip() override
+			{
+				m_nTips++;
+				if (m_bStop)
+					io::Reactor::get_Current().stop();
+			}
+		};
+
+		proto::FlyClientHub hub;
+		MySubscriber sub1(hub), sub2(hub), sub3(hub);
+		hub.Subscribe(sub1);
+		hub.Subscribe(sub2);
+		hub.Subscribe(sub2); // duplicates are ignored
+
+		// keeps its own history, the hub brings it up to date
+		Block::SystemState::HistoryMap hist3;
+		hist3.AddStates(&fc.m_Hist.m_Map.begin()->second, 1); // some stale state
+		sub3.m_pOwn = &hist3;
+		hub.Subscribe(sub3);
+
+		{
+			proto::FlyClient::NetworkStd net(hub);
+
+			io::Address addr;
+			addr.resolve("127.0.0.1");
+			addr.port(g_Port);
+			net.m_Cfg.m_vNodes.push_back(addr);
+			net.Connect();
+
+			fc.SetTimer(90 * 1000);
+			io::Reactor::get_Current().run();
+			fc.KillTimer();
+		}
+
+		verify_test((1 == sub1.m_nTips) && (1 == sub2.m_nTips) && (1 == sub3.m_nTips));
+
+		Block::SystemState::Full sTip, sTip3;
+		verify_test(sub1.get_History().get_Tip(sTip) && (sTip.m_Height == hThrd2));
+		verify_test(hist3.get_Tip(sTip3) && (sTip3 == sTip));
+
+		// rollback below the tip is propagated too
+		hub.get_History().DeleteFrom(sTip.m_Height - 1);
+		hub.OnRolledBack();
+		verify_test(!hist3.get_Tip(sTip3) || (sTip3.m_Height < sTip.m_Height - 1));
+
+		// a late subscriber is brought up to the tip at once, not on the next block
+		MySubscriber sub4(hub);
+		sub4.m_bStop = false;
+		Block::SystemState::HistoryMap hist4;
+		sub4.m_pOwn = &hist4;
+
+		hub.SyncSubscriber(sub4); // not subscribed, ignored
+		verify_test(!sub4.m_nTips && hist4.m_Map.empty());
+
+		hub.Subscribe(sub4);
+		hub.SyncSubscriber(sub4);
+		verify_test(1 == sub4.m_nTips);
+
+		Block::SystemState::Full sTip4;
+		verify_test(hub.get_History().get_Tip(sTip) && hist4.get_Tip(sTip4) && (sTip4 == sTip));
+
+		hub.Unsubscribe(sub1);
+		hub.Unsubscribe(sub2);
+		hub.Unsubscribe(sub3);
+		hub.Unsubscribe(sub4);
+	}
+
+	void TestFlyClientHubBbs()
+	{
+		// BBS subscriptions of several clients over the single network of the hub
+		struct MyNetwork
+			:public proto::FlyClient::INetwork
+		{
+			std::map<BbsChannel, std::pair<proto::FlyClient::IBbsReceiver*, Timestamp> > m_Subs;
+			uint32_t m_Requests = 0;
+
+			virtual void Connect() override {}
+			virtual void Disconnect() override {}
+			virtual void PostRequestInternal(proto::FlyClient::Request&) override { m_Requests++; }
+
+			virtual void BbsSubscribe(BbsChannel ch, Timestamp ts, proto::FlyClient::IBbsReceiver* p) override
+			{
+				if (p)
+					m_Subs[ch] = std::make_pair(p, ts);
+				else
+					m_Subs.erase(ch);
+			}
+		};
+
+		struct MyReceiver
+			:public proto::FlyClient::IBbsReceiver
+		{
+			uint32_t m_Msgs = 0;
+			virtual void OnMsg(proto::BbsMsg&& msg) override
+			{
+				verify_test(msg.m_Message.size() == 10);
+				m_Msgs++;
+			}
+		};
+
+		proto::FlyClientHub hub;
+		auto pNet = std::make_shared<MyNetwork>();
+		hub.m_pNet = pNet;
+
+		MyReceiver r1, r2;
+		{
+			proto::FlyClientHub::Network net1(hub), net2(hub);
+			net1.BbsSubscribe(5, 200, &r1);
+			net2.BbsSubscribe(5, 100, &r2);
+			net2.BbsSubscribe(6, 100, &r2);
+
+			verify_test(pNet->m_Subs.size() == 2);
+			verify_test(pNet->m_Subs[5].second == 100); // the earliest
+
+			proto::BbsMsg msg;
+			msg.m_Channel = 5;
+			msg.m_TimePosted = 300;
+			msg.m_Message.resize(10);
+			pNet->m_Subs[5].first->OnMsg(std::move(msg));
+			verify_test((1 == r1.m_Msgs) && (1 == r2.m_Msgs));
+			net2.BbsSubscribe(5, 250, &r2); // the network resumes after the last message unless a receiver holds it back
+			verify_test(pNet->m_Subs[5].second == 250);
+
+			net1.BbsSubscribe(5, 0, nullptr);
+			verify_test(pNet->m_Subs.size() == 2); // still used by net2
+
+			proto::FlyClient::RequestUtxo::Ptr pReq(new proto::FlyClient::RequestUtxo);
+			net1.PostRequestInternal(*pReq);
+			verify_test(1 == pNet->m_Requests);
+		}
+
+		verify_test(pNet->m_Subs.empty()); // the rest is unsubscribed on destruction
+	}
+
+	void TestBodyCache()
+	{
+		Node::BodyCache bc;
+
+		auto makeKey = [](uint64_t nRow)
+		{
+			Node::BodyCache::Key key;
+			ZeroObject(key);
+			key.m_Row = nRow;
+			return key;
+		};
+
+		proto::BodyBuffers body, out;
+		body.m_Perishable.resize(1000, 1);
+		body.m_Eternal.resize(24, 2);
+
+		const size_t nMax = (sizeof(Node::BodyCache::Element) + 1024) * 3;
+
+		for (uint64_t i = 0; i < 3; i++)
+			bc.Add(body, makeKey(i), nMax);
+		verify_test(bc.m_TotalSize == nMax);
+
+		verify_test(bc.Find(out, makeKey(0))); // becomes the most recently used
+		verify_test((out.m_Perishable == body.m_Perishable) && (out.m_Eternal == body.m_Eternal));
+
+		bc.Add(body, makeKey(3), nMax); // the least recently used is evicted
+		verify_test(bc.m_TotalSize == nMax);
+		verify_test(!bc.Find(out, makeKey(1)));
+		verify_test(bc.Find(out, makeKey(0)));
+		verify_test(bc.Find(out, makeKey(2)));
+		verify_test(bc.Find(out, makeKey(3)));
+
+		body.m_Perishable.resize(nMax); // larger than the whole cache, not added
+		bc.Add(body, makeKey(4), nMax);
+		verify_test(bc.m_TotalSize == nMax);
+		verify_test(!bc.Find(out, makeKey(4)));
+
+		verify_test((bc.m_Hits == 4) && (bc.m_Misses == 2) && (bc.get_HitRate() == 66));
+
+		bc.Clear();
+		verify_test(bc.m_lstMru.empty() && bc.m_setData.empty() && !bc.m_TotalSize);
 	}
 
 	void TestHalving()
@@ -2975,6 +3175,7 @@ void TestAll()
 	if (!bClientProtoOnly)
 	{
 		beam::TestHalving();
+		beam::TestBodyCache();
 		beam::TestChainworkProof();
 	}
 
@@ -3060,6 +3261,8 @@ void TestAll()
 
 	beam::TestFlyClient();
 	beam::DeleteFile(beam::g_sz);
+
+	beam::TestFlyClientHubBbs();
 }
 
 int main()
@@ -30,7 +30,7 @@ public:
     {
         _stream->enable_read(
             [this](io::ErrorCode what, void* data, size_t size) -> bool
-            { return _msgReader.new_data_from_stream(what, data, size); }
+            { return _msgReader.new_data_from_stream_writable(what, data, size); }
         );
     }
 
@@ -49,6 +49,10 @@ public:
     /// Disables all messages
     void disable_all_msg_types() { _msgReader.disable_all_msg_types(); }
 
+    /// Used when the connection is moved to another thread. The connection is unusable once the stream is taken
+    MsgReader& get_reader() { return _msgReader; }
+    io::TcpStream::Ptr& get_stream() { return _stream; }
+
 private:
     MsgReader _msgReader;
 };
@@ -36,6 +36,25 @@ MsgReader::MsgReader(ProtocolBase& protocol, uint64_t streamId, size_t defaultSi
     enable_all_msg_types();
 }
 
+MsgReader::MsgReader(ProtocolBase& protocol, MsgReader& src) :
+    _protocol(protocol),
+    _streamId(src._streamId),
+    _defaultSize(src._defaultSize),
+    _bytesLeft(src._bytesLeft),
+    _state(src._state),
+    _expectedMsgTypes(src._expectedMsgTypes)
+{
+	_pAlive.reset(new bool);
+	*_pAlive = true;
+
+    size_t offset = src._cursor - src._msgBuffer.data();
+    _msgBuffer.swap(src._msgBuffer);
+    _cursor = _msgBuffer.data() + offset;
+
+    src._msgBuffer.resize(_defaultSize);
+    src.reset();
+}
+
 MsgReader::~MsgReader()
 {
 	if (_pAlive)
@@ -68,6 +87,41 @@ void MsgReader::disable_all_msg_types() {
     _expectedMsgTypes.reset();
 }
 
+bool MsgReader::on_header(const MsgHeader& header, volatile const bool& bAlive) {
+	if (!_protocol.approve_msg_header(_streamId, header))
+		// at this moment, the *this* may be deleted
+		return false;
+
+	if (!bAlive)
+		return false;
+
+	if (!_expectedMsgTypes.test(header.type)) {
+		_protocol.on_unexpected_msg(_streamId, header.type);
+		// at this moment, the *this* may be deleted
+		return false;
+	}
+
+	return bAlive;
+}
+
+bool MsgReader::on_message(const uint8_t* pFrame, const MsgHeader& header, volatile const bool& bAlive) {
+	if (!_protocol.VerifyMsg(pFrame, static_cast<uint32_t>(MsgHeader::SIZE + header.size)))
+	{
+		_protocol.on_corrupt_msg(_streamId);
+		return false;
+	}
+
+	if (!_protocol.on_new_message(_streamId, header.type, pFrame + MsgHeader::SIZE, header.size - _protocol.get_MacSize())) {
+		// at this moment, the *this* may be deleted
+		if (bAlive) {
+			reset();
+		}
+		return false;
+	}
+
+	return bAlive;
+}
+
 bool MsgReader::new_data_from_stream(io::ErrorCode connectionStatus, const void* data, size_t size) {
     if (connectionStatus != 0) {
         _protocol.on_connection_error(_streamId, connectionStatus);
@@ -97,48 +151,16 @@ bool MsgReader::new_data_from_stream(io::ErrorCode connectionStatus, const void*
 		if (_state == reading_header)
 		{
 			// header has just been read
-			if (!_protocol.approve_msg_header(_streamId, header))
-				// at this moment, the *this* may be deleted
-				return false;
-
-			if (!bAlive)
-				return false;
-
-			if (!_expectedMsgTypes.test(header.type)) {
-				_protocol.on_unexpected_msg(_streamId, header.type);
-				// at this moment, the *this* may be deleted
-				return false;
-			}
-
-			if (!bAlive)
+			if (!on_header(header, bAlive))
 				return false;
 
 			// header deserialized successfully
-			_bytesLeft = header.size;
-			_msgBuffer.resize(MsgHeader::SIZE + _bytesLeft);
-			_cursor = _msgBuffer.data() + MsgHeader::SIZE;
-
-			_state = reading_message;
-
+			start_message(header);
 		}
 		else
 		{
 			// whole message has been read
-			if (!_protocol.VerifyMsg(_msgBuffer.data(), static_cast<uint32_t>(_msgBuffer.size())))
-			{
-				_protocol.on_corrupt_msg(_streamId);
-				return false;
-			}
-
-            if (!_protocol.on_new_message(_streamId, header.type, _msgBuffer.data() + MsgHeader::SIZE, header.size - _protocol.get_MacSize())) {
-                // at this moment, the *this* may be deleted
-                if (bAlive) {
-                    reset();
-                }
-                return false;
-            }
-
-			if (!bAlive)
+			if (!on_message(_msgBuffer.data(), header, bAlive))
 				return false;
 
 			if (_msgBuffer.size() > 2 * _defaultSize) {
@@ -168,5 +190,62 @@ bool MsgReader::new_data_from_stream(io::ErrorCode connectionStatus, const void*
 	return true;
 }
 
+bool MsgReader::new_data_from_stream_writable(io::ErrorCode connectionStatus, void* data, size_t size) {
+    if (connectionStatus != 0) {
+        _protocol.on_connection_error(_streamId, connectionStatus);
+        return false;
+    }
+
+    if (!data || !size) {
+        return true;
+    }
+
+	std::shared_ptr<bool> pAlive(_pAlive);
+	volatile const bool& bAlive = *pAlive;
+
+    uint8_t* p = (uint8_t*)data;
+    size_t sz = size;
+
+	// As long as there's no partially read message - parse the frames directly out of the stream buffer
+	while ((_state == reading_header) && (_bytesLeft == MsgHeader::SIZE) && (sz >= MsgHeader::SIZE))
+	{
+		_protocol.Decrypt(p, (uint32_t) MsgHeader::SIZE);
+
+		MsgHeader header(p);
+		if (!on_header(header, bAlive))
+			return false;
+
+		size_t nFrame = MsgHeader::SIZE + header.size;
+		if (sz < nFrame)
+		{
+			// spans reads, continue in our buffer. The header is already decrypted
+			start_message(header);
+			memcpy(_msgBuffer.data(), p, MsgHeader::SIZE);
+
+			p += MsgHeader::SIZE;
+			sz -= MsgHeader::SIZE;
+			break;
+		}
+
+		_protocol.Decrypt(p + MsgHeader::SIZE, header.size);
+
+		if (!on_message(p, header, bAlive))
+			return false;
+
+		p += nFrame;
+		sz -= nFrame;
+	}
+
+	return new_data_from_stream(io::EC_OK, p, sz);
+}
+
+void MsgReader::start_message(const MsgHeader& header) {
+	_bytesLeft = header.size;
+	_msgBuffer.resize(MsgHeader::SIZE + _bytesLeft);
+	_cursor = _msgBuffer.data() + MsgHeader::SIZE;
+
+	_state = reading_message;
+}
+
 
 } //namespace
@@ -24,6 +24,9 @@ class MsgReader {
 public:
     /// Ctor sets initial statr (reading_header)
     MsgReader(ProtocolBase& protocol, uint64_t streamId, size_t defaultSize);
+
+    /// Continues reading from where src stopped (partially read message, filters), with another protocol
+    MsgReader(ProtocolBase& protocol, MsgReader& src);
 	~MsgReader();
 
     uint64_t id() const { return _streamId; }
@@ -33,6 +36,10 @@ public:
     /// Calls the callback whenever a new protocol message is exctracted or on errors
     bool new_data_from_stream(io::ErrorCode connectionStatus, const void* data, size_t size);
 
+    /// Same as above, but the data is modified (decrypted) in place.
+    /// Complete frames are parsed directly out of it, only messages that span reads are copied
+    bool new_data_from_stream_writable(io::ErrorCode connectionStatus, void* data, size_t size);
+
     /// Allows receiving messages of given type
     void enable_msg_type(MsgType type);
 
@@ -52,6 +59,13 @@ private:
     /// 2 states of the reader
     enum State { reading_header, reading_message };
 
+    /// Validate the header and the message, dispatch the message. Return false if reading should stop
+    bool on_header(const MsgHeader& header, volatile const bool& bAlive);
+    bool on_message(const uint8_t* pFrame, const MsgHeader& header, volatile const bool& bAlive);
+
+    /// Prepares the buffer for the message body
+    void start_message(const MsgHeader& header);
+
     /// Callbacks
     ProtocolBase& _protocol;
 
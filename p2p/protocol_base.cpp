@@ -14,6 +14,7 @@
 
 #include "protocol_base.h"
 #include "utility/logger.h"
+#include <assert.h>
 
 namespace beam {
 
@@ -32,4 +33,12 @@ bool ProtocolBase::on_new_message(uint64_t fromStream, MsgType type, const void*
     return ret;
 }
 
+void ProtocolBase::copy_dispatch_table(const ProtocolBase& src) {
+    assert(_maxMessageTypes == src._maxMessageTypes);
+    for (size_t i = 0; i < _maxMessageTypes; i++) {
+        _dispatchTable[i] = src._dispatchTable[i];
+        _dispatchTable[i].msgHandler = 0;
+    }
+}
+
 } //namespace
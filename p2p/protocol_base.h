@@ -133,7 +133,7 @@ public:
     }
 
     /// Returns header with unknow size for serializer
-    MsgHeader get_default_header() {
+    MsgHeader get_default_header() const {
         return MsgHeader(V0, V1, V2);
     }
 
@@ -190,7 +190,7 @@ public:
     );
 
     /// Called by MsgReader on new message. Returning false means no more reading
-    bool on_new_message(uint64_t fromStream, MsgType type, const void* data, size_t size);
+    virtual bool on_new_message(uint64_t fromStream, MsgType type, const void* data, size_t size);
 
 	virtual void Decrypt(uint8_t*, uint32_t /*nSize*/) {}
 	virtual uint32_t get_MacSize() { return 0; }
@@ -225,6 +225,9 @@ protected:
 
     /// Raw messages dispatch table for this protocol
     DispatchTableItem* _dispatchTable;
+
+    /// Copies message types and size limits from another protocol, without the handler objects
+    void copy_dispatch_table(const ProtocolBase& src);
 };
 
 } //namespace
@@ -0,0 +1,336 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sharded_connection.h"
+#include "utility/logger.h"
+#include <assert.h>
+
+namespace beam {
+
+/////////////////////////
+// IoShards
+
+IoShards::IoShards(uint32_t nThreads) {
+    _ownerQueue._event = io::AsyncEvent::create(io::Reactor::get_Current(), [this]() { _ownerQueue.flush(); });
+
+    _threads.resize(nThreads);
+    for (uint32_t i = 0; i < nThreads; i++) {
+        _threads[i] = std::make_unique<Thread>();
+        Thread& t = *_threads[i];
+
+        t._reactor = io::Reactor::create();
+        t._queue._event = io::AsyncEvent::create(*t._reactor, [&t]() { t._queue.flush(); });
+        t._thread = std::thread(&IoShards::run_thread, t._reactor);
+    }
+}
+
+IoShards::~IoShards() {
+    for (auto& pThread : _threads) {
+        // after the pending tasks (closing connections)
+        io::Reactor::Ptr pReactor = pThread->_reactor;
+        pThread->_queue.push([pReactor]() { pReactor->stop(); });
+    }
+
+    for (auto& pThread : _threads) {
+        if (pThread->_thread.joinable()) {
+            pThread->_thread.join();
+        }
+    }
+
+    _threads.clear();
+}
+
+void IoShards::run_thread(io::Reactor::Ptr reactor) {
+    io::Reactor::Scope scope(*reactor);
+    reactor->run();
+}
+
+uint32_t IoShards::assign() {
+    assert(!_threads.empty());
+
+    uint32_t iRes = 0;
+    for (uint32_t i = 1; i < _threads.size(); i++) {
+        if (_threads[i]->_connections < _threads[iRes]->_connections) {
+            iRes = i;
+        }
+    }
+
+    _threads[iRes]->_connections++;
+    return iRes;
+}
+
+void IoShards::release(uint32_t iThread) {
+    assert(_threads[iThread]->_connections);
+    _threads[iThread]->_connections--;
+}
+
+void IoShards::post_to_shard(uint32_t iThread, Task&& task) {
+    _threads[iThread]->_queue.push(std::move(task));
+}
+
+void IoShards::post_to_owner(Task&& task) {
+    _ownerQueue.push(std::move(task));
+}
+
+void IoShards::Queue::push(Task&& task) {
+    bool wasEmpty;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        wasEmpty = _tasks.empty();
+        _tasks.push_back(std::move(task));
+    }
+
+    if (wasEmpty) {
+        _event->post();
+    }
+}
+
+void IoShards::Queue::flush() {
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        tasks.swap(_tasks);
+    }
+
+    for (auto& task : tasks) {
+        task();
+    }
+}
+
+/////////////////////////
+// ShardedConnectionCtx
+
+/// Shared between the owner and the I/O thread. Each member is accessed by one thread only, unless atomic
+struct ShardedConnectionCtx : public std::enable_shared_from_this<ShardedConnectionCtx> {
+    ShardedConnectionCtx(IoShards& shards, uint32_t iThread, uint64_t streamId) :
+        _shards(shards),
+        _iThread(iThread),
+        _streamId(streamId)
+    {}
+
+    IoShards& _shards;
+    const uint32_t _iThread;
+    const uint64_t _streamId;
+
+    /// Owner thread, reset when the connection is destroyed
+    ProtocolBase* _protocol=0;
+    IErrorHandler* _errorHandler=0;
+
+    /// I/O thread
+    std::unique_ptr<ShardProtocol> _shardProtocol;
+    std::unique_ptr<MsgReader> _reader;
+    io::TcpStream::Ptr _stream;
+    bool _failed=false;
+
+    /// Queued by the owner, not written to the stream yet
+    std::atomic<size_t> _pending{0};
+
+    /// Unsent by the stream, as of the last I/O
+    std::atomic<size_t> _unsent{0};
+
+    void on_attach(uv_os_sock_t sock);
+    bool on_read(io::ErrorCode what, void* data, size_t size);
+    void on_write(const io::SerializedMsg& fragments, size_t size);
+    void on_close();
+    void update_unsent();
+
+    void post_message(MsgType type, io::SharedBuffer&& msg);
+    void post_protocol_error(ProtocolError error);
+    void post_connection_error(io::ErrorCode errorCode);
+};
+
+void ShardedConnectionCtx::on_attach(uv_os_sock_t sock) {
+    _stream = io::Reactor::get_Current().attach_tcpstream(sock);
+
+    io::Result res = _stream ?
+        _stream->enable_read(
+            [this](io::ErrorCode what, void* data, size_t size) -> bool
+            { return on_read(what, data, size); }
+        ) :
+        io::make_result(io::EC_EBADF);
+
+    if (!res) {
+        post_connection_error(res.error());
+    }
+}
+
+bool ShardedConnectionCtx::on_read(io::ErrorCode what, void* data, size_t size) {
+    if (_failed) {
+        return false;
+    }
+
+    bool ret = _reader->new_data_from_stream_writable(what, data, size);
+    update_unsent();
+    return ret;
+}
+
+void ShardedConnectionCtx::on_write(const io::SerializedMsg& fragments, size_t size) {
+    _pending -= size;
+
+    if (!_stream || _failed) {
+        return;
+    }
+
+    io::Result res = _stream->write(fragments);
+    if (!res) {
+        post_connection_error(res.error());
+    }
+
+    update_unsent();
+}
+
+void ShardedConnectionCtx::on_close() {
+    _stream.reset();
+    _reader.reset();
+    _shardProtocol.reset();
+    _unsent = 0;
+}
+
+void ShardedConnectionCtx::update_unsent() {
+    _unsent = _stream ? _stream->state().unsent : 0;
+}
+
+void ShardedConnectionCtx::post_message(MsgType type, io::SharedBuffer&& msg) {
+    _shards.post_to_owner([pThis = shared_from_this(), type, msg]() {
+        if (pThis->_protocol) {
+            pThis->_protocol->on_new_message(pThis->_streamId, type, msg.data, msg.size);
+        }
+    });
+}
+
+void ShardedConnectionCtx::post_protocol_error(ProtocolError error) {
+    if (_failed) {
+        return;
+    }
+    // no more reading, the owner closes the connection
+    _failed = true;
+
+    _shards.post_to_owner([pThis = shared_from_this(), error]() {
+        if (pThis->_errorHandler) {
+            pThis->_errorHandler->on_protocol_error(pThis->_streamId, error);
+        }
+    });
+}
+
+void ShardedConnectionCtx::post_connection_error(io::ErrorCode errorCode) {
+    if (_failed) {
+        return;
+    }
+    _failed = true;
+
+    _shards.post_to_owner([pThis = shared_from_this(), errorCode]() {
+        if (pThis->_errorHandler) {
+            pThis->_errorHandler->on_connection_error(pThis->_streamId, errorCode);
+        }
+    });
+}
+
+/////////////////////////
+// ShardProtocol
+
+ShardProtocol::ShardProtocol(const ProtocolBase& src) :
+    ProtocolBase(src.get_default_header().V0, src.get_default_header().V1, src.get_default_header().V2, src.max_message_types(), *this)
+{
+    copy_dispatch_table(src);
+}
+
+bool ShardProtocol::on_new_message(uint64_t, MsgType type, const void* data, size_t size) {
+    assert(_ctx);
+
+    // the read buffer is reused by the stream
+    _ctx->post_message(type, io::SharedBuffer(data, size));
+    return true;
+}
+
+void ShardProtocol::on_protocol_error(uint64_t, ProtocolError error) {
+    assert(_ctx);
+    _ctx->post_protocol_error(error);
+}
+
+void ShardProtocol::on_connection_error(uint64_t, io::ErrorCode errorCode) {
+    assert(_ctx);
+    _ctx->post_connection_error(errorCode);
+}
+
+/////////////////////////
+// ShardedConnection
+
+ShardedConnection::Ptr ShardedConnection::create(IoShards& shards, Connection& src, ProtocolBase& protocol, IErrorHandler& errorHandler, std::unique_ptr<ShardProtocol>&& shardProtocol) {
+    assert(shards.size() && shardProtocol);
+
+    io::Address peerAddress = src.peer_address();
+
+    uv_os_sock_t sock;
+    io::Result res = io::Reactor::detach_tcpstream(src.get_stream(), sock);
+    if (!res) {
+        LOG_DEBUG() << "Connection to " << peerAddress << " stays on the owner thread: " << io::error_str(res.error());
+        return Ptr();
+    }
+
+    auto ctx = std::make_shared<ShardedConnectionCtx>(shards, shards.assign(), src.id());
+    ctx->_protocol = &protocol;
+    ctx->_errorHandler = &errorHandler;
+
+    ctx->_shardProtocol = std::move(shardProtocol);
+    ctx->_shardProtocol->_ctx = ctx.get();
+    ctx->_reader = std::make_unique<MsgReader>(*ctx->_shardProtocol, src.get_reader());
+
+    shards.post_to_shard(ctx->_iThread, [ctx, sock]() { ctx->on_attach(sock); });
+
+    return Ptr(new ShardedConnection(shards, ctx, peerAddress));
+}
+
+ShardedConnection::ShardedConnection(IoShards& shards, const std::shared_ptr<ShardedConnectionCtx>& ctx, const io::Address& peerAddress) :
+    _shards(shards),
+    _ctx(ctx),
+    _peerAddress(peerAddress)
+{}
+
+ShardedConnection::~ShardedConnection() {
+    _ctx->_protocol = 0;
+    _ctx->_errorHandler = 0;
+
+    _shards.release(_ctx->_iThread);
+
+    std::shared_ptr<ShardedConnectionCtx> ctx = std::move(_ctx);
+    _shards.post_to_shard(ctx->_iThread, [ctx]() { ctx->on_close(); });
+}
+
+uint64_t ShardedConnection::id() const {
+    return _ctx->_streamId;
+}
+
+io::Result ShardedConnection::write_msg(const io::SerializedMsg& fragments) {
+    size_t size = 0;
+    for (const auto& f : fragments) {
+        size += f.size;
+    }
+
+    _ctx->_pending += size;
+
+    std::shared_ptr<ShardedConnectionCtx> ctx = _ctx;
+    _shards.post_to_shard(ctx->_iThread, [ctx, fragments, size]() { ctx->on_write(fragments, size); });
+
+    return io::Ok();
+}
+
+io::Result ShardedConnection::write_msg(const io::SharedBuffer& msg) {
+    return write_msg(io::SerializedMsg(1, msg));
+}
+
+size_t ShardedConnection::get_Unsent() const {
+    return _ctx->_pending + _ctx->_unsent;
+}
+
+} //namespace
@@ -0,0 +1,129 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "connection.h"
+#include "utility/io/asyncevent.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+namespace beam {
+
+/// I/O threads, each one runs its own reactor.
+/// Created on the owner thread, which receives the messages of the connections served by the I/O threads
+class IoShards {
+public:
+    using Task = std::function<void()>;
+
+    /// Starts the threads
+    explicit IoShards(uint32_t nThreads);
+
+    /// Stops the threads, the tasks posted before are completed
+    ~IoShards();
+
+    uint32_t size() const { return (uint32_t) _threads.size(); }
+
+    /// Selects the least loaded thread for a new connection. Called from the owner thread
+    uint32_t assign();
+
+    /// Called from the owner thread when the connection is closed
+    void release(uint32_t iThread);
+
+    /// Executes the task on the I/O thread. Can be called from any thread
+    void post_to_shard(uint32_t iThread, Task&& task);
+
+    /// Executes the task on the owner thread. Can be called from any thread
+    void post_to_owner(Task&& task);
+
+private:
+    /// Tasks are executed in batches, the event is posted only when the queue becomes non-empty
+    struct Queue {
+        std::mutex _mutex;
+        std::vector<Task> _tasks;
+        io::AsyncEvent::Ptr _event;
+
+        void push(Task&& task);
+        void flush();
+    };
+
+    struct Thread {
+        io::Reactor::Ptr _reactor;
+        Queue _queue;
+        std::thread _thread;
+
+        /// Number of connections, owner thread only
+        uint32_t _connections=0;
+    };
+
+    static void run_thread(io::Reactor::Ptr reactor);
+
+    std::vector<std::unique_ptr<Thread>> _threads;
+    Queue _ownerQueue;
+};
+
+struct ShardedConnectionCtx;
+
+/// Protocol counterpart on the I/O thread. Validates headers against the dispatch table of the original protocol,
+/// forwards the messages and errors to the owner thread. Derived classes add decryption.
+class ShardProtocol : public ProtocolBase, public IErrorHandler {
+public:
+    explicit ShardProtocol(const ProtocolBase& src);
+
+    bool on_new_message(uint64_t fromStream, MsgType type, const void* data, size_t size) override;
+
+    void on_protocol_error(uint64_t fromStream, ProtocolError error) override;
+    void on_connection_error(uint64_t fromStream, io::ErrorCode errorCode) override;
+
+private:
+    friend class ShardedConnection;
+
+    /// Owns this object
+    ShardedConnectionCtx* _ctx=0;
+};
+
+/// Connection served by one of the I/O threads: reading, decryption and framing take place there.
+/// The messages and errors are dispatched on the owner thread, in the order they were received
+class ShardedConnection {
+public:
+    using Ptr = std::unique_ptr<ShardedConnection>;
+
+    /// Moves the stream and the reader state of src to the I/O thread, src must be destroyed afterwards.
+    /// Returns null if the stream can't be moved now (unsent data, not supported by the platform), src is intact then
+    static Ptr create(IoShards& shards, Connection& src, ProtocolBase& protocol, IErrorHandler& errorHandler, std::unique_ptr<ShardProtocol>&& shardProtocol);
+
+    /// Closes the stream on the I/O thread. No callbacks are called after this
+    ~ShardedConnection();
+
+    uint64_t id() const;
+
+    /// Writes are queued to the I/O thread, errors are reported asynchronously via on_connection_error
+    io::Result write_msg(const io::SerializedMsg& fragments);
+    io::Result write_msg(const io::SharedBuffer& msg);
+
+    /// Returns peer address of the original stream
+    io::Address peer_address() const { return _peerAddress; }
+
+    /// Queued bytes, plus the unsent by the stream as of the last I/O
+    size_t get_Unsent() const;
+
+private:
+    ShardedConnection(IoShards& shards, const std::shared_ptr<ShardedConnectionCtx>& ctx, const io::Address& peerAddress);
+
+    IoShards& _shards;
+    std::shared_ptr<ShardedConnectionCtx> _ctx;
+    io::Address _peerAddress;
+};
+
+} //namespace
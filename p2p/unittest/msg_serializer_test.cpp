@@ -83,11 +83,13 @@ struct MsgHandler : IErrorHandler {
     bool on_some_object(uint64_t fromStream, SomeObject&& msg) {
         cout << __FUNCTION__ << "(" << fromStream << "," << msg.i << ")" << endl;
         receivedObj = msg;
+        objectsReceived++;
         return true;
     }
 
     IntList receivedInts;
     SomeObject receivedObj;
+    int objectsReceived=0;
 };
 
 void msg_serializer_test_1() {
@@ -183,8 +185,46 @@ void msg_serializer_test_2() {
     assert(msg == handler.receivedObj);
 }
 
+void msg_reader_writable_test() {
+    MsgType type = 123;
+
+    MsgHandler handler;
+    Protocol protocol(0xAA, 0xBB, 0xCC, 256, handler, 50);
+    protocol.add_message_handler<MsgHandler, SomeObject, &MsgHandler::on_some_object>(type, &handler, 8, 1<<24);
+
+    // several messages in a row
+    std::vector<uint8_t> stream;
+    SomeObject msg;
+    for (int n=0; n<3; ++n) {
+        msg.i = n;
+        msg.x = n * 7;
+        for (int i=0; i<50; ++i) msg.ooo.push_back(i + n);
+
+        std::vector<io::SharedBuffer> fragments;
+        protocol.serialize(fragments, type, msg);
+        for (const auto& f: fragments) {
+            stream.insert(stream.end(), f.data, f.data + f.size);
+        }
+    }
+
+    // whole frames are parsed in place, the rest spans reads
+    for (size_t chunk=1; chunk<=stream.size(); chunk += 13) {
+        handler.objectsReceived = 0;
+        MsgReader reader(protocol, 123456, 12);
+
+        std::vector<uint8_t> buf(stream);
+        for (size_t pos=0; pos<buf.size(); pos += chunk) {
+            reader.new_data_from_stream_writable(io::EC_OK, &buf[pos], std::min(chunk, buf.size() - pos));
+        }
+
+        assert(handler.objectsReceived == 3);
+        assert(msg == handler.receivedObj);
+    }
+}
+
 int main() {
     fragment_writer_test();
     msg_serializer_test_1();
     msg_serializer_test_2();
+    msg_reader_writable_test();
 }
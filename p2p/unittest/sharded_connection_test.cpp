@@ -0,0 +1,178 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "p2p/sharded_connection.h"
+#include "p2p/protocol.h"
+#include "utility/io/tcpserver.h"
+#include "utility/io/timer.h"
+#include <iostream>
+#include <thread>
+
+using namespace beam;
+using namespace beam::io;
+using namespace std;
+
+constexpr uint16_t g_port = 33334;
+
+constexpr MsgType msgTypeForSomeObject = 222;
+constexpr MsgType msgTypeForResponse = 223;
+
+struct SomeObject {
+    int i=0;
+    std::vector<int> ooo;
+
+    SERIALIZE(i,ooo);
+};
+
+struct Response {
+    size_t z=0;
+
+    SERIALIZE(z);
+};
+
+constexpr int g_nMessages = 5;
+
+// Both sides live on the main thread, the server side connection is served by the I/O threads
+struct Test : IErrorHandler {
+    Protocol serverProtocol;
+    Protocol clientProtocol;
+    IoShards shards;
+
+    unique_ptr<Connection> clientConnection;
+    ShardedConnection::Ptr serverConnection;
+
+    thread::id mainThread;
+    int objectsReceived=0;
+    bool ok=true;
+    Response response;
+
+    Test() :
+        serverProtocol(0xAA, 0xBB, 0xCC, 256, *this, 200),
+        clientProtocol(0xAA, 0xBB, 0xCC, 256, *this, 200),
+        shards(2),
+        mainThread(this_thread::get_id())
+    {
+        serverProtocol.add_message_handler<Test, SomeObject, &Test::on_some_object>(msgTypeForSomeObject, this, 1, 10000000);
+        clientProtocol.add_message_handler<Test, Response, &Test::on_response>(msgTypeForResponse, this, 1, 100);
+    }
+
+    void on_protocol_error(uint64_t fromStream, ProtocolError error) override {
+        cout << __FUNCTION__ << "(" << fromStream << "," << static_cast<int32_t>(error) << ")" << endl;
+        ok = false;
+        Reactor::get_Current().stop();
+    }
+
+    void on_connection_error(uint64_t fromStream, io::ErrorCode errorCode) override {
+        cout << __FUNCTION__ << "(" << fromStream << "," << errorCode << ")" << endl;
+        ok = false;
+        Reactor::get_Current().stop();
+    }
+
+    bool on_some_object(uint64_t fromStream, SomeObject&& msg) {
+        cout << __FUNCTION__ << "(" << fromStream << "," << msg.i << "," << msg.ooo.size() << ")" << endl;
+
+        // dispatched on the owner thread, in order
+        if ((this_thread::get_id() != mainThread) || (msg.i != objectsReceived) || (msg.ooo.size() != size_t(msg.i) * 100000)) {
+            ok = false;
+        }
+
+        if (++objectsReceived == g_nMessages) {
+            Response r;
+            r.z = objectsReceived;
+
+            SerializedMsg sm;
+            serverProtocol.serialize(sm, msgTypeForResponse, r);
+            serverConnection->write_msg(sm);
+        }
+        return true;
+    }
+
+    bool on_response(uint64_t fromStream, Response&& msg) {
+        cout << __FUNCTION__ << "(" << fromStream << "," << msg.z << ")" << endl;
+        response = msg;
+        Reactor::get_Current().stop();
+        return true;
+    }
+
+    void on_stream_accepted(TcpStream::Ptr&& newStream, int errorCode) {
+        if (errorCode || serverConnection) {
+            return;
+        }
+
+        Connection c(serverProtocol, 12345, Connection::inbound, 100, move(newStream));
+        serverConnection = ShardedConnection::create(shards, c, serverProtocol, *this, make_unique<ShardProtocol>(serverProtocol));
+        if (!serverConnection) {
+            cout << "Connection can't be moved" << endl;
+            Reactor::get_Current().stop();
+        }
+    }
+
+    void on_client_connected(uint64_t tag, TcpStream::Ptr&& newStream, io::ErrorCode status) {
+        if (!newStream) {
+            on_connection_error(tag, status);
+            return;
+        }
+
+        clientConnection = make_unique<Connection>(clientProtocol, tag, Connection::outbound, 100, move(newStream));
+
+        for (int n = 0; n < g_nMessages; n++) {
+            SomeObject msg;
+            msg.i = n;
+            msg.ooo.resize(n * 100000, n);
+
+            SerializedMsg sm;
+            clientProtocol.serialize(sm, msgTypeForSomeObject, msg);
+            clientConnection->write_msg(sm);
+        }
+    }
+};
+
+void sharded_connection_test() {
+    Reactor::Ptr reactor = Reactor::create();
+    Reactor::Scope scope(*reactor);
+
+    Test test;
+
+    TcpServer::Ptr server = TcpServer::create(
+        *reactor, Address::localhost().port(g_port),
+        [&test](TcpStream::Ptr&& newStream, int errorCode) { test.on_stream_accepted(move(newStream), errorCode); }
+    );
+
+    reactor->tcp_connect(
+        Address::localhost().port(g_port),
+        13,
+        [&test](uint64_t tag, TcpStream::Ptr&& newStream, io::ErrorCode status) { test.on_client_connected(tag, move(newStream), status); }
+    );
+
+    Timer::Ptr timer = Timer::create(*reactor);
+    timer->start(10000, false, [] { Reactor::get_Current().stop(); });
+
+    reactor->run();
+
+    test.serverConnection.reset();
+    test.clientConnection.reset();
+
+    assert(test.ok);
+    assert(test.objectsReceived == g_nMessages);
+    assert(test.response.z == size_t(g_nMessages));
+}
+
+int main() {
+    try {
+        sharded_connection_test();
+    } catch (const std::exception& e) {
+        cout << "Exception: " << e.what() << "\n";
+        return 1;
+    }
+}
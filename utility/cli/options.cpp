@@ -138,6 +138,7 @@ namespace beam
         const char* MINING_THREADS = "mining_threads";
         const char* POW_SOLVE_TIME = "pow_solve_time";
         const char* VERIFICATION_THREADS = "verification_threads";
+        const char* IO_THREADS = "io_threads";
         const char* NONCEPREFIX_DIGITS = "nonceprefix_digits";
         const char* NODE_PEER = "peer";
         const char* NODE_PEERS_PERSISTENT = "peers_persistent";
@@ -275,6 +276,9 @@ namespace beam
         const char* API_TLS_REJECT_UNAUTHORIZED = "tls_reject_unauthorized";
         const char* API_USE_ACL= "use_acl";
         const char* API_ACL_PATH = "acl_path";
+        const char* API_WALLETS_PATH = "wallets_path";
+        const char* API_WALLET_THREADS = "wallet_threads";
+        const char* API_WALLETS_SHARED_NODE = "wallets_shared_node";
 
         // treasury
         const char* TR_OPCODE = "tr_op";
@@ -366,6 +370,7 @@ namespace beam
             (cli::POW_SOLVE_TIME, po::value<uint32_t>()->default_value(15 * 1000), "pow solve time. It works if FakePoW is enabled")
 
             (cli::VERIFICATION_THREADS, po::value<int>()->default_value(-1), "number of threads for cryptographic verifications (0 = single thread, -1 = auto)")
+            (cli::IO_THREADS, po::value<uint32_t>()->default_value(0), "number of threads for peer connections I/O (0 = all on the main thread)")
             (cli::NONCEPREFIX_DIGITS, po::value<unsigned>()->default_value(0), "number of hex digits for nonce prefix for stratum client (0..6)")
             (cli::NODE_PEER, po::value<vector<string>>()->multitoken(), "nodes to connect to")
             (cli::NODE_PEERS_PERSISTENT, po::value<bool>()->default_value(false), "Keep persistent connection to the specified peers, regardless to ratings")
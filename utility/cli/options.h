@@ -36,6 +36,7 @@ namespace beam
         extern const char* MINING_THREADS;
         extern const char* POW_SOLVE_TIME;
         extern const char* VERIFICATION_THREADS;
+        extern const char* IO_THREADS;
         extern const char* NONCEPREFIX_DIGITS;
         extern const char* NODE_PEER;
         extern const char* NODE_PEERS_PERSISTENT;
@@ -175,6 +176,9 @@ namespace beam
         extern const char* API_TLS_REJECT_UNAUTHORIZED;
         extern const char* API_USE_ACL;
         extern const char* API_ACL_PATH;
+        extern const char* API_WALLETS_PATH;
+        extern const char* API_WALLET_THREADS;
+        extern const char* API_WALLETS_SHARED_NODE;
 
         // treasury
         extern const char* TR_OPCODE;
@@ -15,6 +15,7 @@
 #include "common.h"
 #include "executor.h"
 #include <exception>
+#include <atomic>
 
 #ifndef WIN32
 #	include <unistd.h>
@@ -313,6 +314,91 @@ namespace beam
 		}
 	}
 
+	///////////////////////
+	// ExecutorOnPool
+	struct ExecutorOnPool::Batch
+	{
+		Executor* m_pThis;
+		TaskSync* m_pTask; // valid until all the portions are done
+		uint32_t m_Portions;
+		std::atomic<uint32_t> m_iNext;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_AllDone;
+		uint32_t m_Done;
+
+		bool ExecNext()
+		{
+			uint32_t iPortion = m_iNext++;
+			if (iPortion >= m_Portions)
+				return false; // all taken, the task may be already gone
+
+			Context ctx;
+			ctx.m_pThis = m_pThis;
+			ctx.m_iThread = iPortion;
+			m_pTask->Exec(ctx);
+
+			std::unique_lock<std::mutex> scope(m_Mutex);
+			if (++m_Done == m_Portions)
+				m_AllDone.notify_one();
+
+			return true;
+		}
+
+		struct Helper
+			:public TaskAsync
+		{
+			std::shared_ptr<Batch> m_pBatch;
+
+			virtual void Exec(Context&) override
+			{
+				while (m_pBatch->ExecNext())
+					;
+			}
+		};
+	};
+
+	uint32_t ExecutorOnPool::get_Threads()
+	{
+		return m_Pool.get_Threads();
+	}
+
+	void ExecutorOnPool::Push(TaskAsync::Ptr&& pTask)
+	{
+		m_Pool.Push(std::move(pTask));
+	}
+
+	uint32_t ExecutorOnPool::Flush(uint32_t nMaxTasks)
+	{
+		return m_Pool.Flush(nMaxTasks);
+	}
+
+	void ExecutorOnPool::ExecAll(TaskSync& t)
+	{
+		auto pBatch = std::make_shared<Batch>();
+		pBatch->m_pThis = this;
+		pBatch->m_pTask = &t;
+		pBatch->m_Portions = get_Threads();
+		pBatch->m_iNext = 0;
+		pBatch->m_Done = 0;
+
+		// the caller takes one portion, the helpers take the rest unless the caller is faster (if the pool is busy)
+		for (uint32_t i = 1; i < pBatch->m_Portions; i++)
+		{
+			auto pHelper = std::make_unique<Batch::Helper>();
+			pHelper->m_pBatch = pBatch;
+			m_Pool.Push(std::move(pHelper));
+		}
+
+		while (pBatch->ExecNext())
+			;
+
+		// wait for the portions taken by the helpers
+		std::unique_lock<std::mutex> scope(pBatch->m_Mutex);
+		while (pBatch->m_Done < pBatch->m_Portions)
+			pBatch->m_AllDone.wait(scope);
+	}
+
 } // namespace beam
 
 namespace std
@@ -108,4 +108,21 @@ namespace beam
 		void InitSafe();
 		void FlushLocked(std::unique_lock<std::mutex>&, uint32_t nMaxTasks);
 	};
+
+	// runs ExecAll on the threads of another executor (as async tasks), the caller thread executes the portions as well.
+	// Creates no threads, can be used by many threads concurrently, including the threads of that executor (no deadlock).
+	struct ExecutorOnPool
+		:public Executor
+	{
+		ExecutorOnPool(Executor& pool) :m_Pool(pool) {}
+
+		virtual uint32_t get_Threads() override;
+		virtual void Push(TaskAsync::Ptr&&) override;
+		virtual uint32_t Flush(uint32_t nMaxTasks) override;
+		virtual void ExecAll(TaskSync&) override;
+
+	private:
+		Executor& m_Pool;
+		struct Batch;
+	};
 }
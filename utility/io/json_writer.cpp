@@ -0,0 +1,197 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "json_writer.h"
+#include "nlohmann/json.hpp"
+#include <assert.h>
+#include <cmath>
+
+namespace beam { namespace io {
+
+JsonWriter& JsonWriter::begin_object() {
+    open('{');
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_object() {
+    close('}');
+    return *this;
+}
+
+JsonWriter& JsonWriter::begin_array() {
+    open('[');
+    return *this;
+}
+
+JsonWriter& JsonWriter::end_array() {
+    close(']');
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    assert(!_afterKey);
+    separate();
+    write_string(name);
+    put(':');
+    _afterKey = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view s) {
+    separate();
+    write_string(s);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool b) {
+    separate();
+    if (b) {
+        _fw.write("true", 4);
+    } else {
+        _fw.write("false", 5);
+    }
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(double d) {
+    if (!std::isfinite(d)) {
+        return null();
+    }
+
+    separate();
+
+    // same shortest round-trip format as of nlohmann::json
+    char buf[64];
+    char* end = nlohmann::detail::to_chars(buf, buf + sizeof(buf), d);
+    _fw.write(buf, end - buf);
+    return *this;
+}
+
+JsonWriter& JsonWriter::null() {
+    separate();
+    _fw.write("null", 4);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value_signed(int64_t n) {
+    if (n >= 0) {
+        return value_unsigned(uint64_t(n));
+    }
+
+    separate();
+    put('-');
+
+    // no overflow for INT64_MIN
+    uint64_t abs = 0 - uint64_t(n);
+
+    char buf[20];
+    char* p = buf + sizeof(buf);
+    do {
+        *--p = char('0' + abs % 10);
+        abs /= 10;
+    } while (abs);
+
+    _fw.write(p, buf + sizeof(buf) - p);
+    return *this;
+}
+
+JsonWriter& JsonWriter::value_unsigned(uint64_t n) {
+    separate();
+
+    char buf[20];
+    char* p = buf + sizeof(buf);
+    do {
+        *--p = char('0' + n % 10);
+        n /= 10;
+    } while (n);
+
+    _fw.write(p, buf + sizeof(buf) - p);
+    return *this;
+}
+
+void JsonWriter::finalize() {
+    assert(_levels.empty() && !_afterKey);
+
+    // for stratum
+    put('\n');
+    _fw.finalize();
+}
+
+void JsonWriter::separate() {
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+
+    if (!_levels.empty()) {
+        if (_levels.back()) {
+            put(',');
+        } else {
+            _levels.back() = true;
+        }
+    }
+}
+
+void JsonWriter::open(char c) {
+    separate();
+    put(c);
+    _levels.push_back(false);
+}
+
+void JsonWriter::close(char c) {
+    assert(!_levels.empty() && !_afterKey);
+    _levels.pop_back();
+    put(c);
+}
+
+void JsonWriter::write_string(std::string_view s) {
+    static const char hex[] = "0123456789abcdef";
+
+    put('"');
+
+    // unescaped runs are written at once
+    size_t runBegin = 0;
+    for (size_t i = 0; i < s.size(); i++) {
+        unsigned char c = s[i];
+        if (c >= 0x20 && c != '"' && c != '\\') {
+            continue;
+        }
+
+        _fw.write(s.data() + runBegin, i - runBegin);
+        runBegin = i + 1;
+
+        char esc[6] = { '\\', 0, '0', '0', 0, 0 };
+        size_t len = 2;
+        switch (c) {
+            case '"': esc[1] = '"'; break;
+            case '\\': esc[1] = '\\'; break;
+            case '\b': esc[1] = 'b'; break;
+            case '\f': esc[1] = 'f'; break;
+            case '\n': esc[1] = 'n'; break;
+            case '\r': esc[1] = 'r'; break;
+            case '\t': esc[1] = 't'; break;
+            default:
+                esc[1] = 'u';
+                esc[4] = hex[c >> 4];
+                esc[5] = hex[c & 0xf];
+                len = 6;
+        }
+        _fw.write(esc, len);
+    }
+    _fw.write(s.data() + runBegin, s.size() - runBegin);
+
+    put('"');
+}
+
+}} //namespaces
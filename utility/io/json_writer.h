@@ -0,0 +1,84 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+#include "fragment_writer.h"
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace beam { namespace io {
+
+/// Renders json directly into fragments, without building the document in memory.
+/// Separators are placed automatically, the caller is responsible for the structure (a key before each member value).
+/// Output is the same as of serialize_json_msg() for the same members in the same order
+class JsonWriter {
+public:
+    explicit JsonWriter(FragmentWriter& fw) : _fw(fw) {}
+
+    JsonWriter& begin_object();
+    JsonWriter& end_object();
+    JsonWriter& begin_array();
+    JsonWriter& end_array();
+
+    /// Member name, the value must follow
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view s);
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+    JsonWriter& value(const std::string& s) { return value(std::string_view(s)); }
+    JsonWriter& value(bool b);
+    JsonWriter& value(double d);
+    JsonWriter& null();
+
+    template <typename T> std::enable_if_t<std::is_integral_v<T>, JsonWriter&> value(T n) {
+        if constexpr (std::is_signed_v<T>) {
+            return value_signed(n);
+        } else {
+            return value_unsigned(n);
+        }
+    }
+
+    template <typename T> JsonWriter& member(std::string_view name, const T& v) {
+        return key(name).value(v);
+    }
+
+    /// Appends the line terminator and finalizes the message, like serialize_json_msg()
+    void finalize();
+
+private:
+    JsonWriter& value_signed(int64_t n);
+    JsonWriter& value_unsigned(uint64_t n);
+
+    /// Comma before the next item, if needed
+    void separate();
+
+    void open(char c);
+    void close(char c);
+
+    void write_string(std::string_view s);
+
+    void put(char c) { _fw.write(&c, 1); }
+
+    FragmentWriter& _fw;
+
+    /// Open objects and arrays, true if the level has items already
+    std::vector<bool> _levels;
+
+    /// The key is written, the value follows without a separator
+    bool _afterKey=false;
+};
+
+}} //namespaces
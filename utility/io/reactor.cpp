@@ -23,6 +23,8 @@
 
 #ifndef WIN32
 #include <signal.h>
+#include <unistd.h>
+#include <errno.h>
 #endif // WIN32
 
 #ifndef LOG_VERBOSE_ENABLED
@@ -575,6 +577,57 @@ TcpStream* Reactor::move_stream(TcpStream* newStream, TcpStream* oldStream) {
     return newStream;
 }
 
+Result Reactor::detach_tcpstream(TcpStream::Ptr& stream, uv_os_sock_t& sock) {
+    assert(stream);
+
+    if (!stream->is_connected()) {
+        return make_unexpected(EC_ENOTCONN);
+    }
+
+    if (stream->state().unsent) {
+        // pending writes would be lost
+        return make_unexpected(EC_EAGAIN);
+    }
+
+#ifdef WIN32
+    (void) sock;
+    return make_unexpected(EC_ENOTSUP);
+#else // WIN32
+    uv_os_fd_t fd;
+    ErrorCode errorCode = (ErrorCode)uv_fileno(stream->_handle, &fd);
+    if (errorCode != 0) {
+        return make_unexpected(errorCode);
+    }
+
+    sock = dup(fd);
+    if (sock < 0) {
+        return make_unexpected((ErrorCode)uv_translate_sys_error(errno));
+    }
+
+    // closes the original descriptor only
+    stream.reset();
+    return Ok();
+#endif // WIN32
+}
+
+TcpStream::Ptr Reactor::attach_tcpstream(uv_os_sock_t sock) {
+    TcpStream::Ptr stream(new TcpStream());
+
+    ErrorCode errorCode = init_tcpstream(stream.get());
+    if (errorCode == 0) {
+        errorCode = (ErrorCode)uv_tcp_open((uv_tcp_t*)stream->_handle, sock);
+        if (errorCode == 0) {
+            return stream;
+        }
+    }
+
+    LOG_ERROR() << "attach_tcpstream failed, " << error_str(errorCode);
+#ifndef WIN32
+    close(sock);
+#endif // WIN32
+    return TcpStream::Ptr();
+}
+
 ErrorCode Reactor::accept_tcpstream(Object* acceptor, Object* newConnection) {
     assert(acceptor->_handle);
 
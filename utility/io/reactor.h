@@ -82,6 +82,15 @@ public:
 
     void cancel_tcp_connect(uint64_t tag);
 
+    /// Detaches the socket from the connected stream, so that it can be attached to another reactor.
+    /// On success the stream is closed, the socket remains open. Fails if the stream has unsent data.
+    /// Not supported on Windows.
+    static Result detach_tcpstream(std::unique_ptr<TcpStream>& stream, uv_os_sock_t& sock);
+
+    /// Creates the stream out of the detached socket. Must be called from this reactor's thread.
+    /// Takes ownership of the socket, returns null on errors
+    std::unique_ptr<TcpStream> attach_tcpstream(uv_os_sock_t sock);
+
 	class Scope
 	{
 		Reactor* m_pPrev;
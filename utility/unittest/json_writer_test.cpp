@@ -0,0 +1,206 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "utility/io/json_writer.h"
+#include "utility/io/json_serializer.h"
+#include "utility/helpers.h"
+#include "nlohmann/json.hpp"
+#include <iostream>
+#include <assert.h>
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace beam;
+using namespace std;
+using json = nlohmann::json;
+
+namespace {
+
+// Collects the fragments of one message, like HttpMsgCreator does
+struct Packer {
+    io::SerializedMsg msg;
+    io::FragmentWriter fw;
+
+    explicit Packer(size_t fragmentSize) :
+        fw(fragmentSize, 16, [this](io::SharedBuffer&& fragment) { msg.push_back(move(fragment)); })
+    {}
+
+    size_t size() const {
+        size_t n = 0;
+        for (const auto& f : msg) {
+            n += f.size;
+        }
+        return n;
+    }
+
+    string str() const {
+        string s;
+        for (const auto& f : msg) {
+            s.append((const char*)f.data, f.size);
+        }
+        return s;
+    }
+};
+
+int g_failures = 0;
+
+void check(bool cond, const char* what) {
+    if (!cond) {
+        cout << "FAILED: " << what << endl;
+        g_failures++;
+    }
+}
+
+void test_same_as_dom() {
+    json dom = json{
+        { "a_str", "quote\" backslash\\ tab\t nl\n ctl\x01 utf8 \xc3\xa9" },
+        { "b_empty_obj", json::object() },
+        { "c_empty_arr", json::array() },
+        { "d_neg", -1234567890123LL },
+        { "e_max", std::numeric_limits<uint64_t>::max() },
+        { "f_min", std::numeric_limits<int64_t>::min() },
+        { "g_zero", 0 },
+        { "h_double", 1.5e-7 },
+        { "i_double2", 123456.789 },
+        { "j_bool", true },
+        { "k_null", nullptr },
+        { "l_nested", json::array({ json{ {"x", 1}, {"y", json::array({1, "2", false})} }, json::array(), 3.0 }) }
+    };
+
+    Packer p1(64), p2(64);
+    check(serialize_json_msg(p1.fw, dom), "dom serialized");
+
+    io::JsonWriter w(p2.fw);
+    w.begin_object()
+        .member("a_str", "quote\" backslash\\ tab\t nl\n ctl\x01 utf8 \xc3\xa9")
+        .key("b_empty_obj").begin_object().end_object()
+        .key("c_empty_arr").begin_array().end_array()
+        .member("d_neg", -1234567890123LL)
+        .member("e_max", std::numeric_limits<uint64_t>::max())
+        .member("f_min", std::numeric_limits<int64_t>::min())
+        .member("g_zero", 0)
+        .member("h_double", 1.5e-7)
+        .member("i_double2", 123456.789)
+        .member("j_bool", true)
+        .key("k_null").null()
+        .key("l_nested").begin_array()
+            .begin_object()
+                .member("x", 1)
+                .key("y").begin_array().value(1).value("2").value(false).end_array()
+            .end_object()
+            .begin_array().end_array()
+            .value(3.0)
+        .end_array()
+    .end_object();
+    w.finalize();
+
+    cout << p2.str();
+    check(p1.str() == p2.str(), "same as dom");
+    check(p2.msg.size() > 1, "several fragments");
+
+    // the writing can go on with the next message
+    io::JsonWriter w2(p2.fw);
+    w2.begin_array().value("next").end_array();
+    w2.finalize();
+    check(p2.str() == p1.str() + "[\"next\"]\n", "next message");
+}
+
+constexpr int g_nBlocks = 1000;
+constexpr int g_nOutputs = 100;
+
+const char* g_commitment = "0x8f2a3c9d5e6b7a8f2a3c9d5e6b7a8f2a3c9d5e6b7a8f2a3c9d5e6b7a8f2a3c";
+
+long peak_rss_kb() {
+#ifndef WIN32
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+void render_streaming(Packer& p) {
+    io::JsonWriter w(p.fw);
+    w.begin_array();
+    for (int b = 0; b < g_nBlocks; b++) {
+        w.begin_object()
+            .member("found", true)
+            .member("height", b);
+        w.key("outputs").begin_array();
+        for (int i = 0; i < g_nOutputs; i++) {
+            w.begin_object()
+                .member("commitment", g_commitment)
+                .member("extra", "Maturity=12345")
+            .end_object();
+        }
+        w.end_array();
+        w.end_object();
+    }
+    w.end_array();
+    w.finalize();
+}
+
+void render_dom(Packer& p) {
+    json blocks = json::array();
+    for (int b = 0; b < g_nBlocks; b++) {
+        json outputs = json::array();
+        for (int i = 0; i < g_nOutputs; i++) {
+            outputs.push_back(json{
+                {"commitment", g_commitment},
+                {"extra", "Maturity=12345"}
+            });
+        }
+        blocks.push_back(json{
+            {"found", true},
+            {"height", b},
+            {"outputs", outputs}
+        });
+    }
+    serialize_json_msg(p.fw, blocks);
+}
+
+// Not a strict test: prints the latency and the peak memory of both ways for a large response.
+// The streaming one goes first, as the peak RSS never decreases
+void benchmark() {
+    long rss0 = peak_rss_kb();
+
+    Packer p1(4096);
+    uint64_t t = local_timestamp_msec();
+    render_streaming(p1);
+    uint64_t tStreaming = local_timestamp_msec() - t;
+    long rss1 = peak_rss_kb();
+
+    Packer p2(4096);
+    t = local_timestamp_msec();
+    render_dom(p2);
+    uint64_t tDom = local_timestamp_msec() - t;
+    long rss2 = peak_rss_kb();
+
+    cout << "response of " << p1.size() << " bytes" << endl;
+    cout << "streaming: " << tStreaming << " ms, peak RSS +" << rss1 - rss0 << " KB" << endl;
+    cout << "dom:       " << tDom << " ms, peak RSS +" << rss2 - rss1 << " KB" << endl;
+
+    check(p1.size() == p2.size(), "same size");
+    check(p1.str() == p2.str(), "same response");
+}
+
+} //namespace
+
+int main() {
+    test_same_as_dom();
+    benchmark();
+    return g_failures;
+}
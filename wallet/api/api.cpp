@@ -1208,6 +1208,20 @@ OfferInput collectOfferInput(const JsonRpcId& id, const json& params)
             }
         }
 
+        if (existsJsonParam(params, "after"))
+        {
+            if (!params["after"].is_string())
+            {
+                throw jsonrpc_exception{ApiError::InvalidJsonRpc, "Invalid 'after' parameter.", id};
+            }
+
+            getUtxo.after = Coin::FromString(params["after"].get<std::string>());
+            if (!getUtxo.after)
+            {
+                throw jsonrpc_exception{ApiError::InvalidParamsJsonRpc, "Invalid 'after' parameter.", id};
+            }
+        }
+
         getHandler().onMessage(id, getUtxo);
     }
 
@@ -1275,6 +1289,8 @@ OfferInput collectOfferInput(const JsonRpcId& id, const json& params)
             else throw jsonrpc_exception{ ApiError::InvalidJsonRpc, "Invalid 'skip' parameter.", id };
         }
 
+        txList.after = ParameterReader(id, params).readTxId("after", false);
+
         getHandler().onMessage(id, txList);
     }
 
@@ -409,6 +409,9 @@ namespace beam::wallet
         int skip = 0;
         bool withAssets = false;
 
+        // last coin of the previous page
+        boost::optional<Coin::ID> after;
+
         struct
         {
             boost::optional<Asset::ID> assetId;
@@ -456,6 +459,9 @@ namespace beam::wallet
         int count = 0;
         int skip = 0;
 
+        // last tx of the previous page
+        boost::optional<TxID> after;
+
         struct Response
         {
             std::vector<Status::Response> resultList;
@@ -17,11 +17,13 @@
 
 #include "wallet/api/api.h"
 #include "wallet/api/api_handler.h"
+#include "wallet/api/wallet_router.h"
 
 #include <boost/program_options.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string/trim.hpp>
 #include <map>
+#include <set>
 #include <core/block_crypt.h>
 
 #include "utility/cli/options.h"
@@ -37,6 +39,7 @@
 #include "http/http_msg_creator.h"
 
 #include "p2p/line_protocol.h"
+#include "p2p/sharded_connection.h"
 
 #include "wallet/core/wallet_db.h"
 #include "wallet/core/wallet_network.h"
@@ -124,6 +127,54 @@ WalletApi::ACL loadACL(const std::string& path)
     return WalletApi::ACL(keys);
 }
 
+// wallet id and path
+using WalletList = std::vector<std::pair<std::string, std::string>>;
+
+bool loadWalletList(const std::string& path, WalletList& wallets)
+{
+    std::ifstream file(path);
+    std::string line;
+    std::set<std::string> ids;
+    int curLine = 0;
+
+    while (std::getline(file, line)) 
+    {
+        curLine++;
+        boost::algorithm::trim(line);
+
+        if (line.empty())
+        {
+            continue;
+        }
+
+        std::istringstream ss(line);
+        std::string id, walletPath, rest;
+
+        if (!(ss >> id >> walletPath) || (ss >> rest))
+        {
+            LOG_ERROR() << "Wallet list parsing error, line " << curLine;
+            return false;
+        }
+
+        if (!ids.insert(id).second)
+        {
+            LOG_ERROR() << "Duplicate wallet id " << id << ", line " << curLine;
+            return false;
+        }
+
+        wallets.emplace_back(id, walletPath);
+    }
+
+    if (wallets.empty())
+    {
+        LOG_ERROR() << "Wallet list is empty";
+        return false;
+    }
+
+    LOG_INFO() << "Wallet list successfully loaded, " << wallets.size() << " wallets";
+    return true;
+}
+
 #ifdef BEAM_ATOMIC_SWAP_SUPPORT
 using BaseSwapClient = beam::bitcoin::Client;
 class SwapClient : public BaseSwapClient
@@ -183,40 +234,108 @@ private:
 };
 #endif // BEAM_ATOMIC_SWAP_SUPPORT
 
-class IWalletApiServer
+// Node connection shared by the wallets of one wallet thread. The headers are synced once for all of them,
+// the wallets post their requests and BBS subscriptions to it. Lives on the thread it was created on
+class SharedNode
 {
 public:
-    virtual void closeConnection(uint64_t id) = 0;
+    SharedNode(const io::Address& nodeAddr, uint32_t pollPeriod_ms)
+    {
+        auto nnet = std::make_shared<proto::FlyClient::NetworkStd>(_hub);
+        nnet->m_Cfg.m_PollPeriod_ms = pollPeriod_ms;
+        nnet->m_Cfg.m_vNodes.push_back(nodeAddr);
+        _hub.m_pNet = nnet;
+        nnet->Connect();
+    }
+
+    ~SharedNode()
+    {
+        // the wallets must have been closed
+        _hub.m_pNet.reset();
+    }
+
+    proto::FlyClientHub& getHub()
+    {
+        return _hub;
+    }
+
+private:
+    proto::FlyClientHub _hub;
 };
 
-class WalletApiServer 
-    : public IWalletApiServer
+// Wallet with its node connection. Lives on the thread of the reactor it was created on
+class WalletService
 #ifdef BEAM_ATOMIC_SWAP_SUPPORT
-    , public IAtomicSwapProvider
+    : public IAtomicSwapProvider
     , ISwapOffersObserver
 #endif // BEAM_ATOMIC_SWAP_SUPPORT
 {
 public:
-    WalletApiServer(IWalletDB::Ptr walletDB, Wallet::Ptr wallet, io::Reactor& reactor,
-        io::Address listenTo, bool useHttp, WalletApi::ACL acl, const TlsOptions& tlsOptions, const std::vector<uint32_t>& whitelist, bool withAssets)
-        : _reactor(reactor)
-        , _bindAddress(listenTo)
-        , _useHttp(useHttp)
-        , _tlsOptions(tlsOptions)
-        , _walletDB(walletDB)
-        , _wallet(wallet)
-        , _acl(acl)
-        , _whitelist(whitelist)
-        , _withAssets(withAssets)
+    WalletService(IWalletDB::Ptr walletDB, const io::Address& nodeAddr, uint32_t pollPeriod_ms, bool withAssets)
+        : _walletDB(walletDB)
+        , _wallet(std::make_shared<Wallet>(walletDB, withAssets))
     {
-        start();
+        auto nnet = std::make_shared<proto::FlyClient::NetworkStd>(*_wallet);
+        nnet->m_Cfg.m_PollPeriod_ms = pollPeriod_ms;
+        nnet->m_Cfg.m_vNodes.push_back(nodeAddr);
+        nnet->Connect();
+
+        _nnet = nnet;
+        init(withAssets);
     }
 
-    ~WalletApiServer()
+    // The wallet is a subscriber of the shared node connection, which must outlive it
+    WalletService(IWalletDB::Ptr walletDB, SharedNode& node, bool withAssets)
+        : _walletDB(walletDB)
+        , _wallet(std::make_shared<Wallet>(walletDB, withAssets))
+        , _hub(&node.getHub())
     {
-        stop();
+        _nnet = std::make_shared<proto::FlyClientHub::Network>(*_hub);
+        _hub->Subscribe(*_wallet);
+        init(withAssets);
+
+        // don't wait for the next block if the connection is already synced
+        _hub->SyncSubscriber(*_wallet);
+    }
+
+    ~WalletService()
+    {
+        if (_hub)
+        {
+            _hub->Unsubscribe(*_wallet);
+        }
     }
 
+    WalletApiHandler::IWalletData& getWalletData()
+    {
+        return *_walletData;
+    }
+
+private:
+    void init(bool withAssets)
+    {
+        _wnet = std::make_shared<WalletNetworkViaBbs>(*_wallet, _nnet, _walletDB);
+        _wallet->AddMessageEndpoint(_wnet);
+        _wallet->SetNodeEndpoint(_nnet);
+
+#if defined(BEAM_ATOMIC_SWAP_SUPPORT)
+        RegisterSwapTxCreators(_wallet, _walletDB);
+        initSwapFeature(*_nnet, *_wnet);
+        _walletData = std::make_unique<WalletData>(_walletDB, _wallet, *this);
+#else
+        _walletData = std::make_unique<WalletData>(_walletDB, _wallet);
+#endif  // BEAM_ATOMIC_SWAP_SUPPORT
+
+        if (Rules::get().CA.Enabled && withAssets)
+        {
+            RegisterAssetCreators(*_wallet);
+        }
+
+        // All TxCreators must be registered by this point
+        _wallet->ResumeAllTransactions();
+    }
+
+public:
 #if defined(BEAM_ATOMIC_SWAP_SUPPORT)
     Amount getBtcAvailable() const override
     {
@@ -314,7 +433,57 @@ public:
     {
 
     }
+#endif // BEAM_ATOMIC_SWAP_SUPPORT
+
 private:
+    struct WalletData : WalletApiHandler::IWalletData
+    {
+        #ifdef BEAM_ATOMIC_SWAP_SUPPORT
+        WalletData(IWalletDB::Ptr walletDB, Wallet::Ptr wallet, IAtomicSwapProvider& atomicSwapProvider)
+            : m_atomicSwapProvider(atomicSwapProvider)
+            , m_walletDB(walletDB)
+            , m_wallet(wallet)
+        {
+        }
+        #else
+        WalletData(IWalletDB::Ptr walletDB, Wallet::Ptr wallet)
+            : m_walletDB(walletDB)
+            , m_wallet(wallet)
+        {
+        }
+        #endif  // BEAM_ATOMIC_SWAP_SUPPORT
+
+        virtual ~WalletData() {}
+
+        IWalletDB::Ptr getWalletDBPtr() override
+        {
+            return m_walletDB;
+        }
+
+        Wallet::Ptr getWalletPtr() override
+        {
+            return m_wallet;
+        }
+
+        #ifdef BEAM_ATOMIC_SWAP_SUPPORT
+        const IAtomicSwapProvider& getAtomicSwapProvider() const override
+        {
+            return m_atomicSwapProvider;
+        }
+        IAtomicSwapProvider& m_atomicSwapProvider;
+        #endif  // BEAM_ATOMIC_SWAP_SUPPORT
+
+        IWalletDB::Ptr m_walletDB;
+        Wallet::Ptr m_wallet;
+    };
+
+    IWalletDB::Ptr _walletDB;
+    Wallet::Ptr _wallet;
+    proto::FlyClientHub* _hub = nullptr;
+    proto::FlyClient::INetwork::Ptr _nnet;
+    std::shared_ptr<WalletNetworkViaBbs> _wnet;
+
+#ifdef BEAM_ATOMIC_SWAP_SUPPORT
     std::shared_ptr<BroadcastRouter> _broadcastRouter;
     std::shared_ptr<OfferBoardProtocolHandler> _offerBoardProtocolHandler;
     SwapOffersBoard::Ptr _offersBulletinBoard;
@@ -330,8 +499,74 @@ private:
     SwapClient::Ptr _qtumClient;
 #endif // BEAM_ATOMIC_SWAP_SUPPORT
 
+    std::unique_ptr<WalletData> _walletData;
+};
+
+class IWalletApiServer
+{
+public:
+    virtual void closeConnection(uint64_t id) = 0;
+};
+
+// Transport side of a client connection
+class IApiConnection
+{
+public:
+    using Ptr = std::shared_ptr<IApiConnection>;
+
+    virtual ~IApiConnection() {}
+    virtual void sendMsg(const json& msg) = 0;
+};
+
+// Processing side of a client connection, the responses are sent via IApiConnection::sendMsg, maybe later
+class IApiRequestHandler
+{
+public:
+    using Ptr = std::unique_ptr<IApiRequestHandler>;
+
+    virtual ~IApiRequestHandler() {}
+    virtual bool onRequest(const char* data, size_t size) = 0;
+};
+
+// Accepts the client connections, the requests are passed to the handlers created by the derived class
+class WalletApiServer 
+    : public IWalletApiServer
+{
+public:
+    WalletApiServer(io::Reactor& reactor, io::Address listenTo, bool useHttp, const TlsOptions& tlsOptions, const std::vector<uint32_t>& whitelist)
+        : _reactor(reactor)
+        , _bindAddress(listenTo)
+        , _useHttp(useHttp)
+        , _tlsOptions(tlsOptions)
+        , _whitelist(whitelist)
+    {
+        start();
+    }
+
+    virtual ~WalletApiServer()
+    {
+        stop();
+    }
+
 protected:
 
+    virtual IApiRequestHandler::Ptr createRequestHandler(uint64_t id, IApiConnection& connection) = 0;
+
+    // The connection is erased, no more requests from it
+    virtual void onConnectionClosed(uint64_t id) {}
+
+    // Returns null if the connection is closed
+    IApiConnection* findConnection(uint64_t id)
+    {
+        if (std::find(_pendingToClose.begin(), _pendingToClose.end(), id) != _pendingToClose.end())
+        {
+            return nullptr;
+        }
+
+        auto it = _connections.find(id);
+        return (it != _connections.end()) ? it->second.get() : nullptr;
+    }
+
     void start()
     {
         LOG_INFO() << "Start server on " << _bindAddress;
@@ -369,73 +604,13 @@ private:
             for (auto id : _pendingToClose)
             {
                 _connections.erase(id);
+                onConnectionClosed(id);
             }
 
             _pendingToClose.clear();
         }
     }
 
-        struct WalletData : WalletApiHandler::IWalletData
-        {
-            #ifdef BEAM_ATOMIC_SWAP_SUPPORT
-            WalletData(IWalletDB::Ptr walletDB, Wallet::Ptr wallet, IAtomicSwapProvider& atomicSwapProvider)
-                : m_atomicSwapProvider(atomicSwapProvider)
-                , m_walletDB(walletDB)
-                , m_wallet(wallet)
-            {
-            }
-            #else
-            WalletData(IWalletDB::Ptr walletDB, Wallet::Ptr wallet)
-                : m_walletDB(walletDB)
-                , m_wallet(wallet)
-            {
-            }
-            #endif  // BEAM_ATOMIC_SWAP_SUPPORT
-
-            virtual ~WalletData() {}
-
-            IWalletDB::Ptr getWalletDBPtr() override
-            {
-                return m_walletDB;
-            }
-
-            Wallet::Ptr getWalletPtr() override
-            {
-                return m_wallet;
-            }
-
-            #ifdef BEAM_ATOMIC_SWAP_SUPPORT
-            const IAtomicSwapProvider& getAtomicSwapProvider() const override
-            {
-                return m_atomicSwapProvider;
-            }
-            IAtomicSwapProvider& m_atomicSwapProvider;
-            #endif  // BEAM_ATOMIC_SWAP_SUPPORT
-
-            IWalletDB::Ptr m_walletDB;
-            Wallet::Ptr m_wallet;
-        };
-
-    template<typename T>
-    std::shared_ptr<WalletApiHandler> createConnection(io::TcpStream::Ptr&& newStream)
-    {
-        if (!_walletData)
-        {
-            #ifdef BEAM_ATOMIC_SWAP_SUPPORT
-            _walletData = std::make_unique<WalletData>(_walletDB, _wallet, *this);
-            #else
-            _walletData = std::make_unique<WalletData>(_walletDB, _wallet);
-            #endif
-        }
-
-        return std::static_pointer_cast<WalletApiHandler>(
-            std::make_shared<T>(*this
-                                , std::move(newStream)
-                                , *_walletData
-                                , _acl
-                                , _withAssets));
-    }
-
     void on_stream_accepted(io::TcpStream::Ptr&& newStream, io::ErrorCode errorCode)
     {
         if (errorCode == 0) 
@@ -456,30 +631,25 @@ private:
             checkConnections();
 
             _connections[peer.u64()] = _useHttp
-                ? createConnection<HttpApiConnection>(std::move(newStream))
-                : createConnection<TcpApiConnection>(std::move(newStream));
+                ? std::static_pointer_cast<IApiConnection>(std::make_shared<HttpApiConnection>(*this, std::move(newStream)))
+                : std::static_pointer_cast<IApiConnection>(std::make_shared<TcpApiConnection>(*this, std::move(newStream)));
         }
 
         LOG_DEBUG() << "on_stream_accepted";
     }
 
 private:
-    class TcpApiConnection : public WalletApiHandler
+    class TcpApiConnection : public IApiConnection
     {
     public:
-    TcpApiConnection(IWalletApiServer& server
+    TcpApiConnection(WalletApiServer& server
                     , io::TcpStream::Ptr&& newStream
-                    , IWalletData& walletData
-                    , WalletApi::ACL acl
-                    , bool withAssets
         )
-        : WalletApiHandler(walletData
-                      , acl
-                      , withAssets)
-        , _server(server)
+        : _server(server)
         , _stream(std::move(newStream))
         , _lineProtocol(BIND_THIS_MEMFN(on_raw_message), BIND_THIS_MEMFN(on_write))
         {
+            _handler = _server.createRequestHandler(_stream->peer_address().u64(), *this);
             _stream->enable_keepalive(2);
             _stream->enable_read(BIND_THIS_MEMFN(on_stream_data));
         }
@@ -489,7 +659,7 @@ private:
 
         }
 
-        void serializeMsg(const json& msg) override
+        void sendMsg(const json& msg) override
         {
             serialize_json_msg(_lineProtocol, msg);
         }
@@ -501,7 +671,7 @@ private:
 
         bool on_raw_message(void* data, size_t size)
         {
-            return _api.parse(static_cast<const char*>(data), size);
+            return _handler->onRequest(static_cast<const char*>(data), size);
         }
 
         bool on_stream_data(io::ErrorCode errorCode, void* data, size_t size)
@@ -524,25 +694,19 @@ private:
         }
 
     private:
-        IWalletApiServer& _server;
+        WalletApiServer& _server;
         io::TcpStream::Ptr _stream;
         LineProtocol _lineProtocol;
+        IApiRequestHandler::Ptr _handler;
     };
 
-    class HttpApiConnection : public WalletApiHandler
+    class HttpApiConnection : public IApiConnection
     {
     public:
-        HttpApiConnection(IWalletApiServer& server
+        HttpApiConnection(WalletApiServer& server
                         , io::TcpStream::Ptr&& newStream
-                        , IWalletData& walletData
-                        , WalletApi::ACL acl
-                        , bool withAssets
             )
-            : WalletApiHandler(
-                  walletData
-                , acl
-                , withAssets)
-            , _server(server)
+            : _server(server)
             , _keepalive(false)
             , _msgCreator(2000)
             , _packer(PACKER_FRAGMENTS_SIZE)
@@ -550,6 +714,7 @@ private:
             newStream->enable_keepalive(1);
             auto peer = newStream->peer_address();
 
+            _handler = _server.createRequestHandler(peer.u64(), *this);
             _connection = std::make_unique<HttpConnection>(
                 peer.u64(),
                 BaseConnection::inbound,
@@ -562,10 +727,15 @@ private:
 
         virtual ~HttpApiConnection() {}
 
-        void serializeMsg(const json& msg) override
+        void sendMsg(const json& msg) override
         {
             serialize_json_msg(_body, _packer, msg);                
             _keepalive = send(_connection, 200, "OK");
+
+            if (!_keepalive)
+            {
+                close();
+            }
         }
 
     private:
@@ -595,18 +765,26 @@ private:
                 size_t size = 0;
                 auto data = msg.msg->get_body(size);
 
-                _api.parse((char*)data, size);
+                // sendMsg closes the connection if the response fails
+                _keepalive = true;
+                _handler->onRequest((const char*)data, size);
+                return _keepalive;
             }
 
             if (!_keepalive)
             {
-                _connection->shutdown();
-                _server.closeConnection(id);
+                close();
             }
 
             return _keepalive;
         }
 
+        void close()
+        {
+            _connection->shutdown();
+            _server.closeConnection(_connection->id());
+        }
+
         bool send(const HttpConnection::Ptr& conn, int code, const char* message)
         {
             assert(conn);
@@ -642,13 +820,14 @@ private:
         }
 
         HttpConnection::Ptr _connection;
-        IWalletApiServer& _server;
+        WalletApiServer& _server;
         bool _keepalive;
 
         HttpMsgCreator _msgCreator;
         HttpMsgCreator _packer;
         io::SerializedMsg _headers;
         io::SerializedMsg _body;
+        IApiRequestHandler::Ptr _handler;
     };
 
     io::Reactor& _reactor;
@@ -657,17 +836,229 @@ private:
     bool _useHttp;
     TlsOptions _tlsOptions;
 
-    std::unordered_map<uint64_t, std::shared_ptr<WalletApiHandler>> _connections;
-
-    IWalletDB::Ptr _walletDB;
-    Wallet::Ptr _wallet;
+    std::unordered_map<uint64_t, IApiConnection::Ptr> _connections;
 
-    std::unique_ptr<WalletData> _walletData;
     std::vector<uint64_t> _pendingToClose;
-    WalletApi::ACL _acl;
     std::vector<uint32_t> _whitelist;
+};
+
+// Serves one wallet, the requests are processed on the spot
+class SingleWalletApiServer : public WalletApiServer
+{
+public:
+    SingleWalletApiServer(WalletService& service, io::Reactor& reactor,
+        io::Address listenTo, bool useHttp, WalletApi::ACL acl, const TlsOptions& tlsOptions, const std::vector<uint32_t>& whitelist, bool withAssets)
+        : WalletApiServer(reactor, listenTo, useHttp, tlsOptions, whitelist)
+        , _service(service)
+        , _acl(acl)
+        , _withAssets(withAssets)
+    {
+    }
+
+private:
+    class RequestHandler 
+        : public WalletApiHandler
+        , public IApiRequestHandler
+    {
+    public:
+        RequestHandler(IApiConnection& connection
+                      , IWalletData& walletData
+                      , WalletApi::ACL acl
+                      , bool withAssets
+            )
+            : WalletApiHandler(walletData
+                          , acl
+                          , withAssets)
+            , _connection(connection)
+        {
+        }
+
+        void serializeMsg(const json& msg) override
+        {
+            _connection.sendMsg(msg);
+        }
+
+        bool onRequest(const char* data, size_t size) override
+        {
+            return _api.parse(data, size);
+        }
+
+    private:
+        IApiConnection& _connection;
+    };
+
+    IApiRequestHandler::Ptr createRequestHandler(uint64_t id, IApiConnection& connection) override
+    {
+        return std::make_unique<RequestHandler>(connection, _service.getWalletData(), _acl, _withAssets);
+    }
+
+    WalletService& _service;
+    WalletApi::ACL _acl;
     bool _withAssets;
 };
+
+// Serves many wallets, each one on one of the wallet threads. The connections stay on the main thread,
+// the requests are routed by their "wallet_id" member. If sharedNode is set, the wallets of a thread
+// share one node connection, w/o the owner login (the events of the owned nodes are not received)
+class MultiWalletApiServer : public WalletApiServer
+{
+public:
+    MultiWalletApiServer(const WalletList& wallets, const SecString& pass, uint32_t nThreads, const io::Address& nodeAddr, uint32_t pollPeriod_ms, bool sharedNode, io::Reactor& reactor,
+        io::Address listenTo, bool useHttp, WalletApi::ACL acl, const TlsOptions& tlsOptions, const std::vector<uint32_t>& whitelist, bool withAssets)
+        : WalletApiServer(reactor, listenTo, useHttp, tlsOptions, whitelist)
+        , _nodes(nThreads)
+        , _router(nThreads, [this](uint64_t connectionId, const json& msg)
+            {
+                if (auto connection = findConnection(connectionId))
+                {
+                    connection->sendMsg(msg);
+                }
+            })
+    {
+        // the copy is erased when all the wallets are opened
+        auto walletPass = std::make_shared<SecString>();
+        walletPass->assign(static_cast<const void*>(pass.data()), pass.size());
+
+        for (const auto& [id, path] : wallets)
+        {
+            _router.addWallet(id, [this, path = path, walletPass, nodeAddr, pollPeriod_ms, sharedNode, acl, withAssets](uint32_t iThread)
+            {
+                auto walletDB = WalletDB::open(path, *walletPass);
+
+                std::unique_ptr<WalletService> service;
+                if (sharedNode)
+                {
+                    auto& node = _nodes[iThread];
+                    if (!node)
+                    {
+                        node = std::make_unique<SharedNode>(nodeAddr, pollPeriod_ms);
+                    }
+
+                    service = std::make_unique<WalletService>(walletDB, *node, withAssets);
+                }
+                else
+                {
+                    service = std::make_unique<WalletService>(walletDB, nodeAddr, pollPeriod_ms, withAssets);
+                }
+
+                return std::make_unique<ServedWallet>(_router, std::move(service), acl, withAssets);
+            });
+        }
+    }
+
+    ~MultiWalletApiServer()
+    {
+        // the wallets are closed on their threads, then the shared connections, before the threads stop
+        _router.closeWallets();
+
+        for (uint32_t i = 0; i < _nodes.size(); i++)
+        {
+            _router.post(i, [this, i]() { _nodes[i].reset(); });
+        }
+    }
+
+private:
+    // Processes the requests of one connection to one wallet, on the wallet thread
+    class WalletRequestHandler : public WalletApiHandler
+    {
+    public:
+        WalletRequestHandler(WalletRouter& router
+                            , uint64_t connectionId
+                            , IWalletData& walletData
+                            , WalletApi::ACL acl
+                            , bool withAssets
+            )
+            : WalletApiHandler(walletData
+                          , acl
+                          , withAssets)
+            , _router(router)
+            , _connectionId(connectionId)
+        {
+        }
+
+        void serializeMsg(const json& msg) override
+        {
+            _router.sendMsg(_connectionId, msg);
+        }
+
+        void onRequest(const std::string& request)
+        {
+            _api.parse(request.data(), request.size());
+        }
+
+    private:
+        WalletRouter& _router;
+        uint64_t _connectionId;
+    };
+
+    class ServedWallet : public WalletRouter::IWallet
+    {
+    public:
+        ServedWallet(WalletRouter& router, std::unique_ptr<WalletService>&& service, WalletApi::ACL acl, bool withAssets)
+            : _router(router)
+            , _service(std::move(service))
+            , _acl(acl)
+            , _withAssets(withAssets)
+        {
+        }
+
+        void onRequest(uint64_t connectionId, const std::string& request) override
+        {
+            auto& handler = _handlers[connectionId];
+            if (!handler)
+            {
+                handler = std::make_unique<WalletRequestHandler>(_router, connectionId, _service->getWalletData(), _acl, _withAssets);
+            }
+
+            handler->onRequest(request);
+        }
+
+        void onConnectionClosed(uint64_t connectionId) override
+        {
+            _handlers.erase(connectionId);
+        }
+
+    private:
+        WalletRouter& _router;
+        std::unique_ptr<WalletService> _service;
+        WalletApi::ACL _acl;
+        bool _withAssets;
+        std::map<uint64_t, std::unique_ptr<WalletRequestHandler>> _handlers; // destroyed before the service
+    };
+
+    // Passes the requests of a connection to the wallet threads, on the main thread
+    class RoutingRequestHandler : public IApiRequestHandler
+    {
+    public:
+        RoutingRequestHandler(WalletRouter& router, uint64_t connectionId)
+            : _router(router)
+            , _connectionId(connectionId)
+        {
+        }
+
+        bool onRequest(const char* data, size_t size) override
+        {
+            return _router.route(_connectionId, data, size);
+        }
+
+    private:
+        WalletRouter& _router;
+        uint64_t _connectionId;
+    };
+
+    IApiRequestHandler::Ptr createRequestHandler(uint64_t id, IApiConnection& connection) override
+    {
+        return std::make_unique<RoutingRequestHandler>(_router, id);
+    }
+
+    void onConnectionClosed(uint64_t id) override
+    {
+        _router.onConnectionClosed(id);
+    }
+
+    std::vector<std::unique_ptr<SharedNode>> _nodes; // per wallet thread, accessed on that thread only. Must outlive the threads
+    WalletRouter _router;
+};
 }  // namespace
 
 int main(int argc, char* argv[])
@@ -687,6 +1078,9 @@ int main(int argc, char* argv[])
             std::string nodeURI;
             bool useHttp;
             Nonnegative<uint32_t> pollPeriod_ms;
+            std::string walletsPath;
+            uint32_t walletThreads;
+            bool walletsSharedNode;
 
             bool useAcl;
             std::string aclPath;
@@ -699,7 +1093,8 @@ int main(int argc, char* argv[])
         TlsOptions tlsOptions;
 
         io::Address node_addr;
-        IWalletDB::Ptr walletDB;
+        SecString pass;
+        WalletList wallets;
         io::Reactor::Ptr reactor = io::Reactor::create();
         WalletApi::ACL acl;
         std::vector<uint32_t> whitelist;
@@ -717,7 +1112,10 @@ int main(int argc, char* argv[])
                 (cli::IP_WHITELIST, po::value<std::string>(&options.whitelist)->default_value(""), "IP whitelist")
                 (cli::LOG_CLEANUP_DAYS, po::value<uint32_t>(&options.logCleanupPeriod)->default_value(5), "old logfiles cleanup period(days)")
                 (cli::NODE_POLL_PERIOD, po::value<Nonnegative<uint32_t>>(&options.pollPeriod_ms)->default_value(Nonnegative<uint32_t>(0)), "Node poll period in milliseconds. Set to 0 to keep connection. Anyway poll period would be no less than the expected rate of blocks if it is less then it will be rounded up to block rate value.")
-                (cli::WITH_ASSETS,    po::bool_switch()->default_value(false), "enable confidential assets transactions");
+                (cli::WITH_ASSETS,    po::bool_switch()->default_value(false), "enable confidential assets transactions")
+                (cli::API_WALLETS_PATH, po::value<std::string>(&options.walletsPath), "path to the list of wallets to serve, one '<wallet id> <path to wallet file>' per line, all with the same password. The requests select the wallet by the 'wallet_id' member")
+                (cli::API_WALLET_THREADS, po::value<uint32_t>(&options.walletThreads)->default_value(0), "number of the wallet threads when several wallets are served, 0 - number of the CPU cores")
+                (cli::API_WALLETS_SHARED_NODE, po::value<bool>(&options.walletsSharedNode)->default_value(false), "the wallets of a thread share one node connection (the headers are synced once). The events of the owned nodes (UTXO, shielded) are not received then")
             ;
 
             po::options_description authDesc("User authorization options");
@@ -819,22 +1217,35 @@ int main(int argc, char* argv[])
                 return -1;
             }
 
-            if (!WalletDB::isInitialized(options.walletPath))
+            if (!options.walletsPath.empty())
+            {
+                if (!(boost::filesystem::exists(options.walletsPath) && loadWalletList(options.walletsPath, wallets)))
+                {
+                    LOG_ERROR() << "Wallet list not loaded, path is: " << options.walletsPath;
+                    return -1;
+                }
+
+                for (const auto& [id, walletPath] : wallets)
+                {
+                    if (!WalletDB::isInitialized(walletPath))
+                    {
+                        LOG_ERROR() << "Wallet " << id << " not found, path is: " << walletPath;
+                        return -1;
+                    }
+                }
+            }
+            else if (!WalletDB::isInitialized(options.walletPath))
             {
                 LOG_ERROR() << "Wallet not found, path is: " << options.walletPath;
                 return -1;
             }
 
-            SecString pass;
             if (!beam::read_wallet_pass(pass, vm))
             {
                 LOG_ERROR() << "Please, provide password for the wallet.";
                 return -1;
             }
 
-            walletDB = WalletDB::open(options.walletPath, pass);
-            LOG_INFO() << "wallet sucessfully opened...";
-
             // this should be exactly CLI flag value to print correct error messages
             // Rules::CA.Enabled would be checked as well but later
             withAssets = vm[cli::WITH_ASSETS].as<bool>();
@@ -845,47 +1256,43 @@ int main(int argc, char* argv[])
         io::Reactor::GracefulIntHandler gih(*reactor);
 
         LogRotation logRotation(*reactor, LOG_ROTATION_PERIOD, options.logCleanupPeriod);
-        auto wallet = std::make_shared<Wallet>(walletDB, withAssets);
 
-        auto nnet = std::make_shared<proto::FlyClient::NetworkStd>(*wallet);
-        nnet->m_Cfg.m_PollPeriod_ms = options.pollPeriod_ms.value;
-        
-        if (nnet->m_Cfg.m_PollPeriod_ms)
+        uint32_t pollPeriod_ms = options.pollPeriod_ms.value;
+        if (pollPeriod_ms)
         {
-            LOG_INFO() << "Node poll period = " << nnet->m_Cfg.m_PollPeriod_ms << " ms";
-            uint32_t timeout_ms = std::max(Rules::get().DA.Target_s * 1000, nnet->m_Cfg.m_PollPeriod_ms);
-            if (timeout_ms != nnet->m_Cfg.m_PollPeriod_ms)
+            LOG_INFO() << "Node poll period = " << pollPeriod_ms << " ms";
+            uint32_t timeout_ms = std::max(Rules::get().DA.Target_s * 1000, pollPeriod_ms);
+            if (timeout_ms != pollPeriod_ms)
             {
                 LOG_INFO() << "Node poll period has been automatically rounded up to block rate: " << timeout_ms << " ms";
             }
         }
         uint32_t responceTime_s = Rules::get().DA.Target_s * wallet::kDefaultTxResponseTime;
-        if (nnet->m_Cfg.m_PollPeriod_ms >= responceTime_s * 1000)
+        if (pollPeriod_ms >= responceTime_s * 1000)
         {
             LOG_WARNING() << "The \"--node_poll_period\" parameter set to more than " << uint32_t(responceTime_s / 3600) << " hours may cause transaction problems.";
         }
-        nnet->m_Cfg.m_vNodes.push_back(node_addr);
-        nnet->Connect();
 
-        auto wnet = std::make_shared<WalletNetworkViaBbs>(*wallet, nnet, walletDB);
-		wallet->AddMessageEndpoint(wnet);
-        wallet->SetNodeEndpoint(nnet);
+        std::unique_ptr<WalletService> service;
+        std::unique_ptr<WalletApiServer> server;
 
-        WalletApiServer server(walletDB, wallet, *reactor, 
-            listenTo, options.useHttp, acl, tlsOptions, whitelist, withAssets);
-
-#if defined(BEAM_ATOMIC_SWAP_SUPPORT)
-        RegisterSwapTxCreators(wallet, walletDB);
-        server.initSwapFeature(*nnet, *wnet);
-#endif  // BEAM_ATOMIC_SWAP_SUPPORT
-
-        if (Rules::get().CA.Enabled && withAssets)
+        if (wallets.empty())
         {
-            RegisterAssetCreators(*wallet);
+            service = std::make_unique<WalletService>(WalletDB::open(options.walletPath, pass), node_addr, pollPeriod_ms, withAssets);
+            LOG_INFO() << "wallet sucessfully opened...";
+
+            server = std::make_unique<SingleWalletApiServer>(*service, *reactor,
+                listenTo, options.useHttp, acl, tlsOptions, whitelist, withAssets);
         }
+        else
+        {
+            uint32_t nThreads = options.walletThreads ? options.walletThreads : std::thread::hardware_concurrency();
+            nThreads = std::max(nThreads, 1u);
+            LOG_INFO() << "Serving " << wallets.size() << " wallets on " << nThreads << " threads";
 
-        // All TxCreators must be registered by this point
-        wallet->ResumeAllTransactions();
+            server = std::make_unique<MultiWalletApiServer>(wallets, pass, nThreads, node_addr, pollPeriod_ms, options.walletsSharedNode, *reactor,
+                listenTo, options.useHttp, acl, tlsOptions, whitelist, withAssets);
+        }
 
         io::Reactor::get_Current().run();
 
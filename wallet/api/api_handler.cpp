@@ -826,20 +826,28 @@ namespace beam::wallet
 
         GetUtxo::Response response;
         response.confirmations_count = walletDB->getCoinConfirmationsOffset();
-        walletDB->visitCoins([&response, &data](const Coin& c)->bool {
-            if(!data.withAssets && c.isAsset())
+
+        auto assetId = data.filter.assetId;
+        if (!data.withAssets)
+        {
+            if (assetId && *assetId != Asset::s_InvalidID)
             {
-                return true;
+                return doResponse(id, response);
             }
-            if (data.filter.assetId && !c.isAsset(*data.filter.assetId))
+            assetId = Asset::s_InvalidID;
+        }
+
+        if (data.after)
+        {
+            Coin coin;
+            coin.m_ID = *data.after;
+            if (!walletDB->findCoin(coin))
             {
-                return true;
+                return doError(id, ApiError::InvalidParamsJsonRpc, "Unknown coin ID.");
             }
-            response.utxos.push_back(c);
-            return true;
-        });
+        }
 
-        doPagination(data.skip, data.count, response.utxos);
+        response.utxos = walletDB->getCoinsPage(assetId, data.after, data.skip, data.count > 0 ? data.count : std::numeric_limits<int>::max());
         doResponse(id, response);
     }
 
@@ -935,59 +943,48 @@ namespace beam::wallet
                 return doError(id, ApiError::NotOpenedError);
             }
 
-            auto txList = walletDB->getTxHistory(TxType::Simple);
+            TxHistoryFilter filter;
+            filter.m_txTypes = { TxType::Simple };
+            filter.m_status = data.filter.status;
+            filter.m_assetId = data.filter.assetId;
+            filter.m_proofHeight = data.filter.height;
 
             if (data.withAssets)
             {
-                auto txIssue = walletDB->getTxHistory(TxType::AssetIssue);
-                auto txConsume = walletDB->getTxHistory(TxType::AssetConsume);
-                auto txInfo = walletDB->getTxHistory(TxType::AssetInfo);
+                filter.m_txTypes.push_back(TxType::AssetIssue);
+                filter.m_txTypes.push_back(TxType::AssetConsume);
+                filter.m_txTypes.push_back(TxType::AssetInfo);
+            }
+            else
+            {
+                if (filter.m_assetId && *filter.m_assetId != Asset::s_InvalidID)
+                {
+                    return doResponse(id, res);
+                }
+                filter.m_assetId = Asset::s_InvalidID;
+            }
 
-                txList.insert(txList.end(), txIssue.begin(), txIssue.end());
-                txList.insert(txList.end(), txConsume.begin(), txConsume.end());
-                txList.insert(txList.end(), txInfo.begin(), txInfo.end());
+            if (data.after && !walletDB->getTx(*data.after))
+            {
+                return doError(id, ApiError::InvalidParamsJsonRpc, "Unknown transaction ID.");
             }
 
-            std::sort(txList.begin(), txList.end(), [](const TxDescription& a, const TxDescription& b) -> bool {
-                return a.m_minHeight > b.m_minHeight;
-             });
+            auto txList = walletDB->getTxHistoryPage(filter, data.after, data.skip, data.count > 0 ? data.count : std::numeric_limits<int>::max());
 
             Block::SystemState::ID stateID = {};
             walletDB->getSystemStateID(stateID);
 
             for (const auto& tx : txList)
             {
-                if (!data.withAssets && tx.m_assetId != Asset::s_InvalidID)
-                {
-                    continue;
-                }
-
-                if (data.filter.assetId && tx.m_assetId != *data.filter.assetId)
-                {
-                    continue;
-                }
-
-                if (data.filter.status && tx.m_status != *data.filter.status)
-                {
-                    continue;
-                }
-
-                const auto height = storage::DeduceTxProofHeight(*walletDB, tx);
-                if (data.filter.height && height != *data.filter.height)
-                {
-                    continue;
-                }
-
                 Status::Response item;
                 item.tx = tx;
-                item.txHeight = height;
+                item.txHeight = storage::DeduceTxProofHeight(*walletDB, tx);
                 item.systemHeight = stateID.m_Height;
                 item.confirmations = 0;
                 res.resultList.push_back(item);
             }
         }
 
-        doPagination(data.skip, data.count, res.resultList);
         doResponse(id, res);
     }
 
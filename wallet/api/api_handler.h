@@ -65,25 +65,6 @@ public:
 
     void doTxAlreadyExistsError(const JsonRpcId& id);
 
-    template<typename T>
-    static void doPagination(size_t skip, size_t count, std::vector<T>& res)
-    {
-        if (count > 0)
-        {
-            size_t start = skip;
-            size_t end = start + count;
-            size_t size = res.size();
-
-            if (start < size)
-            {
-                if (end > size) end = size;
-
-                res = std::vector<T>(res.begin() + start, res.begin() + end);
-            }
-            else res = {};
-        }
-    }
-
     template<typename T>
     void onIssueConsumeMessage(bool issue, const JsonRpcId& id, const T& data);
 
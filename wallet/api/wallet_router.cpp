@@ -0,0 +1,161 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "wallet/api/wallet_router.h"
+#include "utility/logger.h"
+
+namespace beam::wallet
+{
+    namespace
+    {
+        json makeJsonRpcError(const json& id, ApiError code, const std::string& data)
+        {
+            return json
+            {
+                {Api::JsonRpcHrd, Api::JsonRpcVerHrd},
+                {"id", id},
+                {"error",
+                    {
+                        {"code", code},
+                        {"message", Api::getErrorMessage(code)},
+                        {"data", data}
+                    }
+                }
+            };
+        }
+    }
+
+    WalletRouter::WalletRouter(uint32_t nThreads, Sender&& sender)
+        : _sender(std::move(sender))
+        , _shards(nThreads)
+    {
+    }
+
+    WalletRouter::~WalletRouter()
+    {
+        closeWallets();
+    }
+
+    void WalletRouter::addWallet(const std::string& id, Opener&& opener)
+    {
+        auto slot = std::make_shared<Slot>();
+        slot->_iThread = _shards.assign();
+        _wallets[id] = slot;
+
+        _shards.post_to_shard(slot->_iThread, [slot, id, opener = std::move(opener)]()
+        {
+            try
+            {
+                slot->_wallet = opener(slot->_iThread);
+                LOG_INFO() << "wallet " << id << " successfully opened...";
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR() << "wallet " << id << " not opened: " << e.what();
+            }
+        });
+    }
+
+    bool WalletRouter::route(uint64_t connectionId, const char* data, size_t size)
+    {
+        json msg;
+        try
+        {
+            msg = json::parse(data, data + size);
+        }
+        catch (const nlohmann::detail::exception& e)
+        {
+            _sender(connectionId, makeJsonRpcError(nullptr, ApiError::InvalidJsonRpc, e.what()));
+            return false;
+        }
+
+        if (!msg.is_object())
+        {
+            _sender(connectionId, makeJsonRpcError(nullptr, ApiError::InvalidJsonRpc, "JSON object expected."));
+            return false;
+        }
+
+        auto itWallet = (Api::existsJsonParam(msg, "wallet_id") && msg["wallet_id"].is_string())
+            ? _wallets.find(msg["wallet_id"].get<std::string>())
+            : _wallets.end();
+
+        if (itWallet == _wallets.end())
+        {
+            _sender(connectionId, makeJsonRpcError(msg["id"], ApiError::InvalidParamsJsonRpc, "Unknown 'wallet_id'."));
+            return true;
+        }
+
+        std::shared_ptr<Slot> slot = itWallet->second;
+        _connectionWallets[connectionId].insert(slot);
+
+        _shards.post_to_shard(slot->_iThread, [this, slot, connectionId, id = msg["id"], request = std::string(data, size)]()
+        {
+            if (!slot->_wallet)
+            {
+                sendMsg(connectionId, makeJsonRpcError(id, ApiError::NotOpenedError, ""));
+                return;
+            }
+
+            slot->_wallet->onRequest(connectionId, request);
+        });
+
+        return true;
+    }
+
+    void WalletRouter::onConnectionClosed(uint64_t connectionId)
+    {
+        auto it = _connectionWallets.find(connectionId);
+        if (it == _connectionWallets.end())
+        {
+            return;
+        }
+
+        for (const auto& slot : it->second)
+        {
+            _shards.post_to_shard(slot->_iThread, [slot = slot, connectionId]()
+            {
+                if (slot->_wallet)
+                {
+                    slot->_wallet->onConnectionClosed(connectionId);
+                }
+            });
+        }
+
+        _connectionWallets.erase(it);
+    }
+
+    void WalletRouter::closeWallets()
+    {
+        for (const auto& [id, slot] : _wallets)
+        {
+            _shards.post_to_shard(slot->_iThread, [slot = slot]() { slot->_wallet.reset(); });
+        }
+
+        _wallets.clear();
+        _connectionWallets.clear();
+    }
+
+    void WalletRouter::sendMsg(uint64_t connectionId, const json& msg)
+    {
+        _shards.post_to_owner([this, connectionId, msg]()
+        {
+            _sender(connectionId, msg);
+        });
+    }
+
+    void WalletRouter::post(uint32_t iThread, IoShards::Task&& task)
+    {
+        _shards.post_to_shard(iThread, std::move(task));
+    }
+}
@@ -0,0 +1,78 @@
+// Copyright 2018 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "wallet/api/api.h"
+#include "p2p/sharded_connection.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+namespace beam::wallet
+{
+    // Routes the JSON-RPC requests of the api connections to many wallets, by the "wallet_id" member of the request.
+    // Each wallet lives on one of the wallet threads. The connections and the replies stay on the owner thread
+    class WalletRouter
+    {
+    public:
+        // Created, used and destroyed on its wallet thread
+        struct IWallet
+        {
+            using Ptr = std::unique_ptr<IWallet>;
+            virtual ~IWallet() = default;
+
+            // the replies go through WalletRouter::sendMsg
+            virtual void onRequest(uint64_t connectionId, const std::string& request) = 0;
+            virtual void onConnectionClosed(uint64_t connectionId) = 0;
+        };
+
+        // Opens the wallet on the specified wallet thread, throws on failure
+        using Opener = std::function<IWallet::Ptr(uint32_t iThread)>;
+
+        // Delivers the message to the connection, on the owner thread
+        using Sender = std::function<void(uint64_t connectionId, const json& msg)>;
+
+        WalletRouter(uint32_t nThreads, Sender&& sender);
+        ~WalletRouter();
+
+        uint32_t getThreads() const { return _shards.size(); }
+
+        // Owner thread only
+        void addWallet(const std::string& id, Opener&& opener);
+        bool route(uint64_t connectionId, const char* data, size_t size); // false if it's not a JSON object
+        void onConnectionClosed(uint64_t connectionId);
+        void closeWallets(); // on their threads, the tasks posted afterwards find them closed
+
+        // Can be called from any thread
+        void sendMsg(uint64_t connectionId, const json& msg);
+        void post(uint32_t iThread, IoShards::Task&& task);
+
+    private:
+        struct Slot
+        {
+            uint32_t _iThread = 0;
+            IWallet::Ptr _wallet; // wallet thread only
+        };
+
+        Sender _sender;
+        IoShards _shards;
+
+        std::map<std::string, std::shared_ptr<Slot>> _wallets;
+        std::map<uint64_t, std::set<std::shared_ptr<Slot>>> _connectionWallets;
+    };
+}
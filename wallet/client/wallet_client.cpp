@@ -576,6 +576,16 @@ namespace beam::wallet
         onSyncProgressUpdated(done, total);
     }
 
+    void WalletClient::onEventsSyncProgress(Height done, Height total, uint32_t eventsPerSec)
+    {
+        onEventsSyncProgressUpdated(done, total, eventsPerSec);
+    }
+
+    void WalletClient::onTxBuildProgress(const TxID& txID, uint32_t done, uint32_t total)
+    {
+        onTxBuildProgressUpdated(txID, done, total);
+    }
+
     void WalletClient::onOwnedNode(const PeerID& id, bool connected)
     {
         updateConnectionTrust(connected);
@@ -115,6 +115,8 @@ namespace beam::wallet
         virtual void onStatus(const WalletStatus& status) {}
         virtual void onTxStatus(ChangeAction, const std::vector<TxDescription>& items) {}
         virtual void onSyncProgressUpdated(int done, int total) {}
+        virtual void onEventsSyncProgressUpdated(Height done, Height total, uint32_t eventsPerSec) {}
+        virtual void onTxBuildProgressUpdated(const TxID& txID, uint32_t done, uint32_t total) {}
         virtual void onChangeCalculated(Amount change) {}
         virtual void onAllUtxoChanged(ChangeAction, const std::vector<Coin>& utxos) {}
         virtual void onAddressesChanged(ChangeAction, const std::vector<WalletAddress>& addresses) {}
@@ -153,6 +155,8 @@ namespace beam::wallet
         void onSystemStateChanged(const Block::SystemState::ID& stateID) override;
         void onAddressChanged(ChangeAction action, const std::vector<WalletAddress>& items) override;
         void onSyncProgress(int done, int total) override;
+        void onEventsSyncProgress(Height done, Height total, uint32_t eventsPerSec) override;
+        void onTxBuildProgress(const TxID& txID, uint32_t done, uint32_t total) override;
         void onOwnedNode(const PeerID& id, bool connected) override;
 
         void sendMoney(const WalletID& receiver, const std::string& comment, Amount amount, Amount fee) override;
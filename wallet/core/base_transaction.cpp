@@ -325,6 +325,11 @@ namespace beam::wallet
         GetGateway().UpdateOnNextTip(GetTxID());
     }
 
+    void BaseTransaction::UpdateOnHeight(Height h)
+    {
+        GetGateway().UpdateOnHeight(GetTxID(), h);
+    }
+
     void BaseTransaction::CompleteTx()
     {
         LOG_INFO() << m_Context << " Transaction completed";
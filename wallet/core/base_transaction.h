@@ -238,6 +238,7 @@ namespace beam::wallet
         bool GetTip(Block::SystemState::Full& state) const;
         void UpdateAsync();
         void UpdateOnNextTip();
+        void UpdateOnHeight(Height);
         INegotiatorGateway& GetGateway() const;
         SubTxID GetSubTxID() const;
 
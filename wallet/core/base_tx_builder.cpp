@@ -84,6 +84,16 @@ namespace beam::wallet
         }
     }
 
+    void BaseTxBuilder::KeyKeeperHandler::OnProgress(uint32_t nDone, uint32_t nTotal)
+    {
+        if (m_pLink)
+        {
+            std::shared_ptr<BaseTxBuilder> pBld = m_pBuilder.lock();
+            if (pBld)
+                pBld->m_Tx.GetGateway().on_tx_build_progress(pBld->m_Tx.GetTxID(), nDone, nTotal);
+        }
+    }
+
     void BaseTxBuilder::KeyKeeperHandler::OnFailed(BaseTxBuilder& b, IPrivateKeyKeeper2::Status::Type n)
     {
         Detach(b);
@@ -312,25 +322,23 @@ namespace beam::wallet
             using KeyKeeperHandler::KeyKeeperHandler;
 
             std::vector<IPrivateKeyKeeper2::Method::CreateOutput> m_vCalls;
-            std::vector<Output::Ptr> m_Outputs;
 
             virtual ~MyHandler() {} // auto
 
             virtual void OnSuccess(BaseTxBuilder& b) override
             {
-                size_t iDone = m_Outputs.size();
-                assert(iDone < m_vCalls.size());
-                assert(m_vCalls[iDone].m_pResult);
-
-                m_Outputs.push_back(std::move(m_vCalls[iDone].m_pResult));
+                // all done. Keep the original order
+                b.m_Outputs.clear();
+                b.m_Outputs.reserve(m_vCalls.size());
 
-                if (m_Outputs.size() == m_vCalls.size())
+                for (auto& c : m_vCalls)
                 {
-                    // all done
-                    b.m_Outputs = std::move(m_Outputs);
-                    b.FinalizeOutputs();
-                    OnAllDone(b);
+                    assert(c.m_pResult);
+                    b.m_Outputs.push_back(std::move(c.m_pResult));
                 }
+
+                b.FinalizeOutputs();
+                OnAllDone(b);
             }
         };
 
@@ -338,15 +346,15 @@ namespace beam::wallet
         MyHandler& x = Cast::Up<MyHandler>(*pHandler);
 
         x.m_vCalls.resize(m_OutputCoins.size());
-        x.m_Outputs.reserve(m_OutputCoins.size());
         for (size_t i = 0; i < m_OutputCoins.size(); i++)
         {
             x.m_vCalls[i].m_hScheme = m_MinHeight;
             x.m_vCalls[i].m_Cid = m_OutputCoins[i];
-
-            m_Tx.get_KeyKeeperStrict()->InvokeAsync(x.m_vCalls[i], pHandler);
         }
 
+        // single request, the key keeper may create the outputs in parallel
+        m_Tx.get_KeyKeeperStrict()->InvokeAsyncBatch(x.m_vCalls, pHandler);
+
         return true;// true if async
     }
 
@@ -385,41 +393,41 @@ namespace beam::wallet
         {
             using KeyKeeperHandler::KeyKeeperHandler;
 
-            struct CoinPars :public IPrivateKeyKeeper2::Method::get_Kdf {
-                CoinID m_Cid;
-            };
-
-            std::vector<CoinPars> m_vCalls;
-            std::vector<Input::Ptr> m_Inputs;
+            // Kdf is requested once per distinct child, usually all the coins are of the root
+            std::vector<IPrivateKeyKeeper2::Method::get_Kdf> m_vCalls;
+            std::vector<CoinID> m_vCoins;
+            std::vector<size_t> m_vCallIdx; // per coin
 
             virtual ~MyHandler() {} // auto
 
             virtual void OnSuccess(BaseTxBuilder& b) override
             {
-                size_t iDone = m_Inputs.size();
-                assert(iDone < m_vCalls.size());
-                CoinPars& c = m_vCalls[iDone];
-
-                if (!c.m_pPKdf)
+                for (const auto& c : m_vCalls)
                 {
-                    OnFailed(b, IPrivateKeyKeeper2::Status::Unspecified); // although shouldn't happen
-                    return;
+                    if (!c.m_pPKdf)
+                    {
+                        OnFailed(b, IPrivateKeyKeeper2::Status::Unspecified); // although shouldn't happen
+                        return;
+                    }
                 }
 
-                Point::Native comm;
-                CoinID::Worker(c.m_Cid).Recover(comm, *c.m_pPKdf);
+                std::vector<Input::Ptr> vInputs;
+                vInputs.reserve(m_vCoins.size());
 
-                m_Inputs.emplace_back();
-                m_Inputs.back().reset(new Input);
-                m_Inputs.back()->m_Commitment = comm;
-
-                if (m_Inputs.size() == m_vCalls.size())
+                for (size_t i = 0; i < m_vCoins.size(); i++)
                 {
-                    // all done
-                    b.m_Inputs = std::move(m_Inputs);
-                    b.FinalizeInputs();
-                    OnAllDone(b);
+                    Point::Native comm;
+                    CoinID::Worker(m_vCoins[i]).Recover(comm, *m_vCalls[m_vCallIdx[i]].m_pPKdf);
+
+                    vInputs.emplace_back();
+                    vInputs.back().reset(new Input);
+                    vInputs.back()->m_Commitment = comm;
                 }
+
+                // all done
+                b.m_Inputs = std::move(vInputs);
+                b.FinalizeInputs();
+                OnAllDone(b);
             }
         };
 
@@ -432,15 +440,25 @@ namespace beam::wallet
         KeyKeeperHandler::Ptr pHandler = std::make_shared<MyHandler>(*this, m_CreatingInputs);
         MyHandler& x = Cast::Up<MyHandler>(*pHandler);
 
-        x.m_vCalls.resize(m_InputCoins.size());
-        x.m_Inputs.reserve(m_InputCoins.size());
+        std::map<std::pair<bool, Key::Index>, size_t> mapCalls;
+
+        x.m_vCoins = m_InputCoins;
+        x.m_vCallIdx.resize(m_InputCoins.size());
         for (size_t i = 0; i < m_InputCoins.size(); i++)
         {
-            MyHandler::CoinPars& c = x.m_vCalls[i];
-            c.m_Cid = m_InputCoins[i];
-            c.m_Root = !c.m_Cid.get_ChildKdfIndex(c.m_iChild);
-            m_Tx.get_KeyKeeperStrict()->InvokeAsync(x.m_vCalls[i], pHandler);
+            IPrivateKeyKeeper2::Method::get_Kdf c;
+            c.From(m_InputCoins[i]);
+            if (c.m_Root)
+                c.m_iChild = 0; // ignored
+
+            auto it = mapCalls.emplace(std::make_pair(c.m_Root, c.m_iChild), x.m_vCalls.size()).first;
+            if (it->second == x.m_vCalls.size())
+                x.m_vCalls.push_back(std::move(c));
+
+            x.m_vCallIdx[i] = it->second;
         }
+
+        m_Tx.get_KeyKeeperStrict()->InvokeAsyncBatch(x.m_vCalls, pHandler);
     }
 
     struct BaseTxBuilder::ShieldedInputContext
@@ -1066,6 +1084,69 @@ namespace beam::wallet
         return transaction;
     }
 
+    bool BaseTxBuilder::CreateAndVerifyTransaction()
+    {
+        if (m_Verifying)
+            return true;
+
+        if (m_IsTransactionValid)
+            return false;
+
+        if (!m_Transaction)
+            m_Transaction = CreateTransaction();
+
+        struct Verifier
+        {
+            Transaction::Ptr m_pTx;
+            Height m_hMin;
+            bool m_Valid = false;
+
+            void Do()
+            {
+                TxBase::Context::Params pars;
+                TxBase::Context ctx(pars);
+                ctx.m_Height.m_Min = m_hMin;
+                m_Valid = m_pTx->IsValid(ctx);
+            }
+        };
+
+        auto pVerifier = std::make_shared<Verifier>();
+        pVerifier->m_pTx = m_Transaction;
+        pVerifier->m_hMin = GetMinHeight();
+
+        std::weak_ptr<BaseTxBuilder> pWeak = shared_from_this();
+        bool bAsync = m_Tx.GetGateway().DoAsync(
+            [pVerifier]() { pVerifier->Do(); },
+            [pVerifier, pWeak]()
+            {
+                std::shared_ptr<BaseTxBuilder> pBld = pWeak.lock();
+                if (!pBld)
+                    return;
+
+                pBld->m_Verifying = false;
+                pBld->m_IsTransactionValid = pVerifier->m_Valid;
+
+                ITransaction::Ptr pGuard(pBld->m_Tx.shared_from_this());
+                pBld->m_Tx.Update();
+            });
+
+        if (bAsync)
+        {
+            m_Verifying = true;
+            return true;
+        }
+
+        pVerifier->Do();
+        m_IsTransactionValid = pVerifier->m_Valid;
+        return false;
+    }
+
+    const Transaction::Ptr& BaseTxBuilder::GetVerifiedTransaction() const
+    {
+        static const Transaction::Ptr s_Null;
+        return (m_IsTransactionValid && *m_IsTransactionValid) ? m_Transaction : s_Null;
+    }
+
     bool BaseTxBuilder::IsPeerSignatureValid() const
     {
         Signature peerSig;
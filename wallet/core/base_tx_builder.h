@@ -54,6 +54,10 @@ namespace beam::wallet
         bool CreateInputs();
         void FinalizeInputs();
         virtual Transaction::Ptr CreateTransaction();
+        // Creates the final transaction and verifies it, on a worker thread if the gateway supports it.
+        // Returns true while the verification is in progress
+        bool CreateAndVerifyTransaction();
+        const Transaction::Ptr& GetVerifiedTransaction() const; // nullptr if invalid
         bool SignSender(bool initial, bool bIsConventional = true);
         bool SignReceiver(bool bIsConventional = true);
         bool SignSplit();
@@ -95,6 +99,7 @@ namespace beam::wallet
             ~KeyKeeperHandler();
 
             virtual void OnDone(IPrivateKeyKeeper2::Status::Type) override;
+            virtual void OnProgress(uint32_t nDone, uint32_t nTotal) override;
 
             virtual void OnSuccess(BaseTxBuilder&) = 0;
             virtual void OnFailed(BaseTxBuilder&, IPrivateKeyKeeper2::Status::Type);
@@ -162,6 +167,10 @@ namespace beam::wallet
         bool m_CreatingInputsShielded = false;
         bool m_CreatingOutputs = false;
         bool m_Signing = false;
+        bool m_Verifying = false;
+
+        Transaction::Ptr m_Transaction;
+        boost::optional<bool> m_IsTransactionValid;
 
         struct ShieldedInputContext;
     };
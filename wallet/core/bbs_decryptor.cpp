@@ -0,0 +1,156 @@
+// Copyright 2019 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bbs_decryptor.h"
+#include "utility/logger.h"
+
+namespace beam::wallet
+{
+
+struct BbsDecryptor::Job
+    :public Executor::TaskAsync
+{
+    std::shared_ptr<State> m_pState;
+    Task::Ptr m_pTask;
+
+    void Exec(Executor::Context&) override
+    {
+        Process(*m_pTask);
+
+        std::unique_lock<std::mutex> scope(m_pState->m_Mutex);
+        if (!m_pState->m_pEvt)
+            return; // stopped
+
+        m_pTask->m_Done = true;
+
+        // keep the arrival order, the earlier messages may still be in progress
+        bool bPost = false;
+        TaskQueue& q = m_pState->m_Queue;
+        while (!q.empty() && q.front()->m_Done)
+        {
+            // the invalid are returned too, the caller tracks what's handled
+            m_pState->m_Done.push_back(std::move(q.front()));
+            q.pop_front();
+            bPost = true;
+        }
+
+        if (bPost)
+            m_pState->m_pEvt->post();
+    }
+};
+
+void BbsDecryptor::Start(io::AsyncEvent::Callback&& cb)
+{
+    assert(!m_pState);
+    m_pExecutor = GetSharedExecutor();
+    m_pState = std::make_shared<State>();
+    m_pState->m_pEvt = io::AsyncEvent::create(io::Reactor::get_Current(), std::move(cb));
+}
+
+void BbsDecryptor::Stop()
+{
+    if (m_pState)
+    {
+        {
+            std::unique_lock<std::mutex> scope(m_pState->m_Mutex);
+            m_pState->m_pEvt.reset();
+            m_pState->m_Queue.clear();
+            m_pState->m_Done.clear();
+        }
+
+        m_pState.reset();
+        m_pExecutor.reset();
+    }
+}
+
+bool BbsDecryptor::Push(Task::Ptr&& pTask)
+{
+    assert(m_pState);
+    {
+        std::unique_lock<std::mutex> scope(m_pState->m_Mutex);
+        if (m_pState->m_Queue.size() + m_pState->m_Done.size() >= s_MaxInProgress)
+        {
+            if (!(m_Rejected++ % s_MaxInProgress))
+                LOG_WARNING() << "BBS decryptor is overloaded, incoming messages rejected: " << m_Rejected;
+            return false;
+        }
+
+        m_pState->m_Queue.push_back(pTask);
+    }
+
+    auto pJob = std::make_unique<Job>();
+    pJob->m_pState = m_pState;
+    pJob->m_pTask = std::move(pTask);
+    m_pExecutor->Push(std::move(pJob));
+    return true;
+}
+
+BbsDecryptor::Task::Ptr BbsDecryptor::Pop()
+{
+    Task::Ptr pTask;
+    if (m_pState)
+    {
+        std::unique_lock<std::mutex> scope(m_pState->m_Mutex);
+        if (!m_pState->m_Done.empty())
+        {
+            pTask = std::move(m_pState->m_Done.front());
+            m_pState->m_Done.pop_front();
+        }
+    }
+    return pTask;
+}
+
+uint32_t BbsDecryptor::get_InProgress() const
+{
+    if (!m_pState)
+        return 0;
+
+    std::unique_lock<std::mutex> scope(m_pState->m_Mutex);
+    return static_cast<uint32_t>(m_pState->m_Queue.size() + m_pState->m_Done.size());
+}
+
+void BbsDecryptor::Process(Task& t)
+{
+    assert(!t.m_Msg.empty());
+
+    const uint8_t* pBody = &t.m_Msg.front();
+    uint32_t nBody = static_cast<uint32_t>(t.m_Msg.size());
+
+    ByteBuffer buf;
+    for (const Key& key : *t.m_pKeys)
+    {
+        buf.assign(pBody, pBody + nBody); // Decrypt works in-place
+        uint8_t* pMsg = &buf.front();
+        uint32_t nSize = nBody;
+
+        if (!proto::Bbs::Decrypt(pMsg, nSize, key.m_sk))
+            continue;
+
+        try {
+            Deserializer der;
+            der.reset(pMsg, nSize);
+            der& t.m_Parameters;
+
+            t.m_Wid = key.m_Wid;
+            t.m_Valid = true;
+            return;
+        }
+        catch (const std::exception&) {
+            LOG_WARNING() << "BBS deserialization failed";
+            t.m_Parameters = SetTxParameter();
+        }
+    }
+}
+
+}  // namespace beam::wallet
@@ -0,0 +1,97 @@
+// Copyright 2019 The Beam Team
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/ecc_native.h"
+#include "core/proto.h"
+#include "utility/executor.h"
+#include "utility/io/asyncevent.h"
+#include "common.h"
+
+namespace beam::wallet
+{
+
+// incoming message decryption and parsing on the shared worker pool
+class BbsDecryptor
+{
+public:
+    struct Key
+    {
+        WalletID m_Wid;
+        ECC::Scalar::Native m_sk;
+    };
+
+    // own addresses of the channel, not modified once shared with the threads
+    typedef std::vector<Key> KeyList;
+    typedef std::shared_ptr<const KeyList> KeyListPtr;
+
+    struct Task
+    {
+        ByteBuffer m_Msg;
+        KeyListPtr m_pKeys;
+        BbsChannel m_Channel = 0;
+        Timestamp m_TimePosted = 0;
+        bool m_Done = false;
+
+        // result
+        bool m_Valid = false;
+        WalletID m_Wid;
+        SetTxParameter m_Parameters;
+
+        typedef std::shared_ptr<Task> Ptr;
+    };
+
+    // messages in progress and processed but not taken yet. The newer are rejected beyond it, the caller should fetch them later
+    static const uint32_t s_MaxInProgress = 1024;
+
+    ~BbsDecryptor() { Stop(); }
+
+    void Start(io::AsyncEvent::Callback&&); // invoked on the caller reactor when decoded messages are available
+    void Stop(); // the tasks in progress are abandoned, they're not handled
+    bool IsStarted() const { return static_cast<bool>(m_pState); }
+
+    bool Push(Task::Ptr&&); // false if rejected, the task is not taken
+    Task::Ptr Pop(); // processed, in the arrival order. Check m_Valid
+    uint32_t get_InProgress() const;
+
+    uint64_t get_Rejected() const { return m_Rejected; }
+
+    static void Process(Task&);
+
+private:
+    typedef std::deque<Task::Ptr> TaskQueue;
+
+    // shared with the jobs, outlives the decryptor if they're still in progress
+    struct State
+    {
+        std::mutex m_Mutex;
+        io::AsyncEvent::Ptr m_pEvt; // reset on stop
+        TaskQueue m_Queue; // all the tasks in progress, in the arrival order
+        TaskQueue m_Done; // processed, in the arrival order
+    };
+
+    struct Job;
+
+    std::shared_ptr<State> m_pState;
+    std::shared_ptr<Executor> m_pExecutor;
+    uint64_t m_Rejected = 0;
+};
+}  // namespace beam::wallet
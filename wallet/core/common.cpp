@@ -19,6 +19,7 @@
 #include "core/serialization_adapters.h"
 #include "base58.h"
 #include "utility/string_helpers.h"
+#include "utility/executor.h"
 #include "strings_resources.h"
 #include "core/shielded.h"
 #include "3rdparty/nlohmann/json.hpp"
@@ -858,6 +859,23 @@ namespace beam::wallet
         return ret;
     }
 
+    std::shared_ptr<Executor> GetSharedExecutor()
+    {
+        static std::mutex s_Mutex;
+        static std::weak_ptr<ExecutorMT> s_pExecutor;
+
+        std::unique_lock<std::mutex> scope(s_Mutex);
+
+        std::shared_ptr<ExecutorMT> pRet = s_pExecutor.lock();
+        if (!pRet)
+        {
+            pRet = std::make_shared<ExecutorMT>();
+            s_pExecutor = pRet;
+        }
+
+        return pRet;
+    }
+
     std::string GetSendToken(const std::string& sbbsAddress, const std::string& identityStr, Amount amount)
     {
         WalletID walletID;
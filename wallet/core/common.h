@@ -25,6 +25,11 @@
 #include "wallet/core/exchange_rate.h"
 #include "utility/std_extension.h"
 
+namespace beam
+{
+    struct Executor;
+}
+
 namespace beam::wallet
 {
     enum class TxType : uint8_t
@@ -680,7 +685,14 @@ namespace beam::wallet
         virtual void get_shielded_list(const TxID&, TxoID startIndex, uint32_t count, ShieldedListCallback&& callback) = 0;
         virtual void get_proof_shielded_output(const TxID&, const ECC::Point& serialPublic, ProofShildedOutputCallback&& callback) {};
         virtual void UpdateOnNextTip(const TxID&) = 0;
+        // wakes the transaction once the tip reaches the given height, the default is to poll on every tip
+        virtual void UpdateOnHeight(const TxID& txID, Height) { UpdateOnNextTip(txID); }
         virtual void get_UniqueVoucher(const WalletID& peerID, const TxID& txID, boost::optional<ShieldedTxo::Voucher>&) {}
+        // runs the job on a worker thread, then the completion on the wallet thread.
+        // Returns false if not supported, then the caller should do the job inline
+        virtual bool DoAsync(std::function<void()>&& job, std::function<void()>&& done) { return false; }
+        // progress of the key keeper batches (outputs creation), for the UI
+        virtual void on_tx_build_progress(const TxID&, uint32_t nDone, uint32_t nTotal) {}
     };
 
     enum class ErrorType : uint8_t
@@ -738,6 +750,10 @@ namespace beam::wallet
 
     uint64_t get_RandomID();
 
+    // Worker pool for the heavy jobs of all the wallets in the process (outputs creation, tx verification).
+    // Created on demand, destroyed with the last user. For async tasks only (Push), since ExecAll is not reentrant
+    std::shared_ptr<Executor> GetSharedExecutor();
+
     template<typename Observer, typename Notifier>
     struct ScopedSubscriber
     {
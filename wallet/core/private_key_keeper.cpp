@@ -70,6 +70,58 @@ namespace beam::wallet
 	KEY_KEEPER_METHODS(THE_MACRO)
 #undef THE_MACRO
 
+	////////////////////////////////
+	// Batch methods implemented via single ones
+	struct IPrivateKeyKeeper2::HandlerBatch
+		:public Handler
+	{
+		Handler::Ptr m_pHandler;
+		size_t m_Pending;
+		size_t m_Total;
+
+		virtual void OnDone(Status::Type nRes) override
+		{
+			if (!m_pHandler)
+				return; // already failed
+
+			if (Status::Success == nRes)
+			{
+				assert(m_Pending);
+				if (--m_Pending)
+				{
+					m_pHandler->OnProgress(static_cast<uint32_t>(m_Total - m_Pending), static_cast<uint32_t>(m_Total));
+					return;
+				}
+			}
+
+			Handler::Ptr pHandler = std::move(m_pHandler);
+			pHandler->OnDone(nRes);
+		}
+	};
+
+	template <typename TMethod>
+	void IPrivateKeyKeeper2::InvokeAsyncBatchInternal(std::vector<TMethod>& v, const Handler::Ptr& pHandler)
+	{
+		assert(!v.empty());
+
+		auto p = std::make_shared<HandlerBatch>();
+		p->m_pHandler = pHandler;
+		p->m_Pending = v.size();
+		p->m_Total = v.size();
+
+		for (size_t i = 0; i < v.size(); i++)
+			InvokeAsync(v[i], p);
+	}
+
+#define THE_MACRO(method) \
+	void IPrivateKeyKeeper2::InvokeAsyncBatch(std::vector<Method::method>& v, const Handler::Ptr& pHandler) \
+	{ \
+		InvokeAsyncBatchInternal(v, pHandler); \
+	}
+
+	KEY_KEEPER_BATCH_METHODS(THE_MACRO)
+#undef THE_MACRO
+
 	////////////////////////////////
 	// misc
 	IPrivateKeyKeeper2::Status::Type IPrivateKeyKeeper2::get_Commitment(ECC::Point::Native& res, const CoinID& cid)
@@ -150,6 +202,15 @@ namespace beam::wallet
 		PushOut(pTask);
 	}
 
+	void PrivateKeyKeeper_WithMarshaller::PushProgress(uint32_t nDone, uint32_t nTotal, const Handler::Ptr& pHandler)
+	{
+		Task::Ptr pTask(new TaskProgress);
+		Cast::Up<TaskProgress>(*pTask).m_Done = nDone;
+		Cast::Up<TaskProgress>(*pTask).m_Total = nTotal;
+		pTask->m_pHandler = pHandler;
+		PushOut(pTask);
+	}
+
 	void PrivateKeyKeeper_WithMarshaller::OnNewOut()
 	{
 		// protect this obj from destruction from the handler invocation
@@ -172,6 +233,11 @@ namespace beam::wallet
 		m_pHandler->OnDone(m_Status);
 	}
 
+	void PrivateKeyKeeper_WithMarshaller::TaskProgress::Execute(Task::Ptr&)
+	{
+		m_pHandler->OnProgress(m_Done, m_Total);
+	}
+
 	////////////////////////////////
 	// PrivateKeyKeeper_AsyncNotify
 #define THE_MACRO(method) \
@@ -268,6 +334,40 @@ namespace beam::wallet
 	KEY_KEEPER_METHODS(THE_MACRO)
 #undef THE_MACRO
 
+	template <typename TMethod>
+	void ThreadedPrivateKeyKeeper::InvokeAsyncBatchInternal(std::vector<TMethod>& v, const Handler::Ptr& pHandler)
+	{
+		assert(!v.empty());
+
+		struct MyTask :public Task {
+			std::vector<TMethod>* m_pV;
+			virtual void Exec(IPrivateKeyKeeper2& k) override
+			{
+				for (size_t i = 0; i < m_pV->size(); i++)
+				{
+					m_Status = k.InvokeSync(m_pV->at(i));
+					if (Status::Success != m_Status)
+						break;
+				}
+			}
+		};
+
+		Task::Ptr pTask(new MyTask);
+		pTask->m_pHandler = pHandler;
+		Cast::Up<MyTask>(*pTask).m_pV = &v;
+
+		PushIn(pTask);
+	}
+
+#define THE_MACRO(method) \
+	void ThreadedPrivateKeyKeeper::InvokeAsyncBatch(std::vector<Method::method>& v, const Handler::Ptr& pHandler) \
+	{ \
+		InvokeAsyncBatchInternal<Method::method>(v, pHandler); \
+	}
+
+	KEY_KEEPER_BATCH_METHODS(THE_MACRO)
+#undef THE_MACRO
+
 
 
 } // namespace beam::wallet
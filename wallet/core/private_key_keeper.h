@@ -52,6 +52,8 @@ namespace beam::wallet
 
             virtual ~Handler() {}
             virtual void OnDone(Status::Type) = 0;
+            // Batches only, optional. Invoked on the caller thread, before OnDone
+            virtual void OnProgress(uint32_t nDone, uint32_t nTotal) {}
         };
 
         struct ShieldedInput
@@ -172,6 +174,18 @@ namespace beam::wallet
         KEY_KEEPER_METHODS(THE_MACRO)
 #undef THE_MACRO
 
+#define KEY_KEEPER_BATCH_METHODS(macro) \
+		macro(get_Kdf) \
+		macro(CreateOutput) \
+
+        // Batch of the same method (must not be empty). The handler is notified once: after all the methods are done, or on the first failure.
+        // By default the methods are invoked one by one. Implementations may process the whole batch at once (in parallel, in a single round-trip)
+#define THE_MACRO(method) \
+			virtual void InvokeAsyncBatch(std::vector<Method::method>&, const Handler::Ptr&);
+
+        KEY_KEEPER_BATCH_METHODS(THE_MACRO)
+#undef THE_MACRO
+
         virtual ~IPrivateKeyKeeper2() {}
 
         // synthetic functions (in terms of underlying ones)
@@ -179,9 +193,13 @@ namespace beam::wallet
 
     private:
         struct HandlerSync;
+        struct HandlerBatch;
 
         template <typename TMethod>
         Status::Type InvokeSyncInternal(TMethod& m);
+
+        template <typename TMethod>
+        void InvokeAsyncBatchInternal(std::vector<TMethod>&, const Handler::Ptr&);
     };
 
     // implements async notification mechanism, base for async implementations
@@ -212,6 +230,16 @@ namespace beam::wallet
             virtual ~TaskFin() {}
         };
 
+        struct TaskProgress
+            :public Task
+        {
+            uint32_t m_Done;
+            uint32_t m_Total;
+
+            virtual void Execute(Task::Ptr&) override;
+            virtual ~TaskProgress() {}
+        };
+
 		struct TaskList
 			:public boost::intrusive::list<Task>
 		{
@@ -228,6 +256,7 @@ namespace beam::wallet
         void EnsureEvtOut();
         void PushOut(Task::Ptr& p);
         void PushOut(Status::Type, const Handler::Ptr&);
+        void PushProgress(uint32_t nDone, uint32_t nTotal, const Handler::Ptr&);
 
         void OnNewOut();
     };
@@ -273,12 +302,22 @@ namespace beam::wallet
 		template <typename TMethod>
         void InvokeAsyncInternal(TMethod& m, const Handler::Ptr& pHandler);
 
+		template <typename TMethod>
+        void InvokeAsyncBatchInternal(std::vector<TMethod>& v, const Handler::Ptr& pHandler);
+
 #define THE_MACRO(method) \
 		void InvokeAsync(Method::method& m, const Handler::Ptr& pHandler) override;
 
 		KEY_KEEPER_METHODS(THE_MACRO)
 #undef THE_MACRO
 
+		// the whole batch is passed to the thread at once
+#define THE_MACRO(method) \
+		void InvokeAsyncBatch(std::vector<Method::method>& v, const Handler::Ptr& pHandler) override;
+
+		KEY_KEEPER_BATCH_METHODS(THE_MACRO)
+#undef THE_MACRO
+
 	};
 
 }
@@ -206,7 +206,18 @@ namespace beam::wallet
                     SendInvitation(builder, isSender);
                     SetState(State::Invitation);
                 }
-                UpdateOnNextTip();
+
+                // the peer's response wakes us up, otherwise there is nothing to do until expiration
+                Height maxHeight = MaxHeight;
+                if (GetParameter(TxParameterID::MaxHeight, maxHeight)
+                    || GetParameter(TxParameterID::PeerResponseHeight, maxHeight))
+                {
+                    UpdateOnHeight(maxHeight + 1);
+                }
+                else
+                {
+                    UpdateOnNextTip();
+                }
                 return;
             }
 
@@ -293,14 +304,12 @@ namespace beam::wallet
                 return;
             }
 
-            // Construct transaction
-            auto transaction = builder.CreateTransaction();
+            // Construct and verify the final transaction. The verification (mostly rangeproofs) runs on a worker thread
+            if (builder.CreateAndVerifyTransaction())
+                return;
 
-            // Verify final transaction
-            TxBase::Context::Params pars;
-			TxBase::Context ctx(pars);
-			ctx.m_Height.m_Min = builder.GetMinHeight();
-			if (!transaction->IsValid(ctx))
+            auto transaction = builder.GetVerifiedTransaction();
+            if (!transaction)
             {
                 OnFailed(TxFailureReason::InvalidTransaction, true);
                 return;
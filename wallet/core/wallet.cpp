@@ -165,6 +165,14 @@ namespace beam::wallet
     Wallet::~Wallet()
     {
         CleanupNetwork();
+
+        if (m_pAsyncJobs)
+        {
+            // the jobs in progress complete on the executor, w/o the completions
+            std::unique_lock<std::mutex> scope(m_pAsyncJobs->m_Mutex);
+            m_pAsyncJobs->m_pEvt.reset();
+            m_pAsyncJobs->m_vDone.clear();
+        }
     }
 
     void Wallet::CleanupNetwork()
@@ -593,6 +601,78 @@ namespace beam::wallet
         }
     }
 
+    // Implementation of the INegotiatorGateway::UpdateOnHeight
+    void Wallet::UpdateOnHeight(const TxID& txID, Height h)
+    {
+        Block::SystemState::Full sTip;
+        if (!get_tip(sTip) || sTip.m_Height >= h)
+        {
+            UpdateOnNextTip(txID);
+            return;
+        }
+
+        if (m_ActiveTransactions.find(txID) != m_ActiveTransactions.end())
+        {
+            m_HeightTransactionToUpdate.emplace(h, txID);
+        }
+    }
+
+    bool Wallet::DoAsync(std::function<void()>&& job, std::function<void()>&& done)
+    {
+        struct MyTask
+            :public Executor::TaskAsync
+        {
+            std::shared_ptr<AsyncJobs> m_pJobs;
+            std::function<void()> m_Job;
+            std::function<void()> m_Done;
+
+            virtual void Exec(Executor::Context&) override
+            {
+                m_Job();
+
+                std::unique_lock<std::mutex> scope(m_pJobs->m_Mutex);
+                if (!m_pJobs->m_pEvt)
+                    return; // the wallet is destroyed
+
+                m_pJobs->m_vDone.push_back(std::move(m_Done));
+                m_pJobs->m_pEvt->post();
+            }
+        };
+
+        if (!m_pAsyncJobs)
+        {
+            m_pAsyncJobs = std::make_shared<AsyncJobs>();
+            m_pAsyncJobs->m_pEvt = io::AsyncEvent::create(io::Reactor::get_Current(), [this]() { OnAsyncJobsDone(); });
+        }
+
+        std::unique_ptr<MyTask> pTask = std::make_unique<MyTask>();
+        pTask->m_pJobs = m_pAsyncJobs;
+        pTask->m_Job = std::move(job);
+        pTask->m_Done = std::move(done);
+
+        get_Executor().Push(std::move(pTask));
+        return true;
+    }
+
+    Executor& Wallet::get_Executor()
+    {
+        if (!m_pExecutor)
+            m_pExecutor = GetSharedExecutor();
+        return *m_pExecutor;
+    }
+
+    void Wallet::OnAsyncJobsDone()
+    {
+        std::vector<std::function<void()> > vDone;
+        {
+            std::unique_lock<std::mutex> scope(m_pAsyncJobs->m_Mutex);
+            vDone.swap(m_pAsyncJobs->m_vDone);
+        }
+
+        for (auto& f : vDone)
+            f();
+    }
+
     Wallet::VoucherManager::Request* Wallet::VoucherManager::CreateIfNew(const WalletID& trg)
     {
         Request::Target key;
@@ -849,6 +929,7 @@ namespace beam::wallet
         if (bSynced)
         {
             AsyncContextHolder holder(*this);
+            m_TxUpdatesPerTip++;
             tx->Update();
         }
         else
@@ -1036,6 +1117,9 @@ namespace beam::wallet
             DeleteReq(*m_PendingEvents.begin());
         }
 
+        if (!m_EventsProgress.m_Start_ms)
+            m_EventsProgress.m_Start_ms = GetTime_ms();
+
         MyRequestEvents::Ptr pReq(new MyRequestEvents);
         pReq->m_Msg.m_HeightMin = h;
         PostReqUnique(*pReq);
@@ -1053,6 +1137,7 @@ namespace beam::wallet
             :public proto::Event::IGroupParser
         {
             Wallet& m_This;
+            std::vector<UtxoEvent> m_vUtxo;
             MyParser(Wallet& x) :m_This(x) {}
 
             virtual void OnEvent(proto::Event::Base& evt_) override
@@ -1075,13 +1160,13 @@ namespace beam::wallet
                     {
                         proto::Event::Utxo& evt = Cast::Up<proto::Event::Utxo>(evt_);
 
-                        // filter-out false positives
-
-                        if (!m_This.m_WalletDB->IsRecoveredMatch(evt.m_Cid, evt.m_Commitment))
-                            return;
-
-                        bool bAdd = 0 != (proto::Event::Flags::Add & evt.m_Flags);
-                        m_This.ProcessEventUtxo(evt.m_Cid, m_Height, evt.m_Maturity, bAdd);
+                        // false positives are filtered-out once the whole page is parsed
+                        UtxoEvent& x = m_vUtxo.emplace_back();
+                        x.m_Cid = evt.m_Cid;
+                        x.m_Commitment = evt.m_Commitment;
+                        x.m_Height = m_Height;
+                        x.m_Maturity = evt.m_Maturity;
+                        x.m_Add = 0 != (proto::Event::Flags::Add & evt.m_Flags);
                         return;
                     }
                     default:
@@ -1092,17 +1177,135 @@ namespace beam::wallet
         
         uint32_t nCount = p.Proceed(r.m_Res.m_Events);
 
+        Block::SystemState::Full sTip;
+        m_WalletDB->get_History().get_Tip(sTip);
+
+        Height hDone = sTip.m_Height;
         if (nCount < r.m_Max)
+            SetEventsHeight(hDone);
+        else
         {
-            Block::SystemState::Full sTip;
-            m_WalletDB->get_History().get_Tip(sTip);
+            hDone = p.m_Height;
+            SetEventsHeight(hDone);
+            RequestEvents(); // maybe more events pending. The next page is on its way while this one is recognized
+        }
 
-            SetEventsHeight(sTip.m_Height);
+        RecognizeUtxoEvents(p.m_vUtxo);
+
+        for (const auto& x : p.m_vUtxo)
+        {
+            if (x.m_Recognized)
+                ProcessEventUtxo(x.m_Cid, x.m_Height, x.m_Maturity, x.m_Add);
+        }
+
+        ReportEventsProgress(nCount, hDone, sTip.m_Height);
+    }
+
+    void Wallet::RecognizeUtxoEvents(std::vector<UtxoEvent>& v)
+    {
+        Key::IPKdf::Ptr pOwner = m_WalletDB->get_OwnerKdf();
+        assert(pOwner); // must always be available
+
+        ExecutorOnPool exec(get_Executor()); // the caller thread takes part as well
+
+        if (v.size() < exec.get_Threads() * 4)
+        {
+            // not worth waking the threads
+            for (auto& x : v)
+                RecognizeUtxoEvent(x, *pOwner);
         }
         else
         {
-            SetEventsHeight(p.m_Height);
-            RequestEvents(); // maybe more events pending
+            struct MyTask
+                :public Executor::TaskSync
+            {
+                std::vector<UtxoEvent>* m_pV;
+                Key::IPKdf* m_pOwner;
+
+                virtual void Exec(Executor::Context& ctx) override
+                {
+                    uint32_t i0, nCount;
+                    ctx.get_Portion(i0, nCount, static_cast<uint32_t>(m_pV->size()));
+
+                    for (uint32_t i = 0; i < nCount; i++)
+                        RecognizeUtxoEvent(m_pV->at(i0 + i), *m_pOwner);
+                }
+            };
+
+            MyTask t;
+            t.m_pV = &v;
+            t.m_pOwner = pOwner.get();
+            exec.ExecAll(t);
+        }
+
+        for (auto& x : v)
+        {
+            if (x.m_Deferred)
+                x.m_Recognized = m_WalletDB->IsRecoveredMatch(x.m_Cid, x.m_Commitment);
+        }
+    }
+
+    void Wallet::RecognizeUtxoEvent(UtxoEvent& x, Key::IPKdf& ownerKdf)
+    {
+        // Same as IWalletDB::IsRecoveredMatch, but w/o the key keeper, which is not thread-safe.
+        Key::Index idx;
+        if (x.m_Cid.get_ChildKdfIndex(idx))
+        {
+            x.m_Deferred = true; // child kdf is required
+            return;
+        }
+
+        ECC::Point::Native comm;
+        CoinID::Worker(x.m_Cid).Recover(comm, ownerKdf);
+        if (x.m_Commitment == ECC::Point(comm))
+        {
+            x.m_Recognized = true;
+            return;
+        }
+
+        if (!x.m_Cid.IsBb21Possible())
+            return;
+
+        CoinID cid = x.m_Cid;
+        cid.set_WorkaroundBb21();
+
+        CoinID::Worker(cid).Recover(comm, ownerKdf);
+        if (x.m_Commitment == ECC::Point(comm))
+        {
+            x.m_Cid = cid;
+            x.m_Recognized = true;
+        }
+    }
+
+    void Wallet::ReportEventsProgress(uint32_t nCount, Height h, Height hTip)
+    {
+        m_EventsProgress.m_Count += nCount;
+
+        uint64_t dt_ms = GetTime_ms() - m_EventsProgress.m_Start_ms;
+        uint32_t nRate = static_cast<uint32_t>(m_EventsProgress.m_Count * 1000 / std::max<uint64_t>(dt_ms, 1));
+
+        if (h < hTip)
+        {
+            LOG_INFO() << "Events processed up to " << h << " of " << hTip << ", " << nRate << " events/sec";
+        }
+        else
+        {
+            if (m_EventsProgress.m_Count > nCount)
+                LOG_INFO() << "Events synced: " << m_EventsProgress.m_Count << " events in " << dt_ms << " ms";
+            m_EventsProgress = EventsProgress();
+        }
+
+        for (const auto sub : m_subscribers)
+        {
+            sub->onEventsSyncProgress(h, hTip, nRate);
+        }
+    }
+
+    void Wallet::on_tx_build_progress(const TxID& txID, uint32_t nDone, uint32_t nTotal)
+    {
+        for (const auto sub : m_subscribers)
+        {
+            sub->onTxBuildProgress(txID, nDone, nTotal);
         }
     }
 
@@ -1301,6 +1504,9 @@ namespace beam::wallet
         sTip.get_ID(id);
         LOG_INFO() << "Sync up to " << id;
 
+        LOG_DEBUG() << "Transactions updated since previous tip: " << m_TxUpdatesPerTip << ", active: " << m_ActiveTransactions.size();
+        m_TxUpdatesPerTip = 0;
+
         RequestEvents();
         RequestStateSummary();
 
@@ -1310,6 +1516,21 @@ namespace beam::wallet
         }
         m_NextTipTransactionToUpdate.clear();
 
+        // wake only those waiting for the reached height, the rest keep sleeping
+        while (!m_HeightTransactionToUpdate.empty())
+        {
+            auto it = m_HeightTransactionToUpdate.begin();
+            if (it->first > sTip.m_Height)
+                break;
+
+            auto itTx = m_ActiveTransactions.find(it->second);
+            if (itTx != m_ActiveTransactions.end())
+            {
+                UpdateOnSynced(itTx->second);
+            }
+            m_HeightTransactionToUpdate.erase(it);
+        }
+
         CheckSyncDone();
 
         ProcessStoredMessages();
@@ -1393,7 +1614,10 @@ namespace beam::wallet
             {
                 BaseTransaction::Ptr pTx = *it;
                 if (m_ActiveTransactions.find(pTx->GetTxID()) != m_ActiveTransactions.end())
+                {
+                    m_TxUpdatesPerTip++;
                     pTx->Update();
+                }
             }
         }
     }
@@ -18,6 +18,8 @@
 #include "common.h"
 #include "base_transaction.h"
 #include "core/fly_client.h"
+#include "utility/executor.h"
+#include "utility/io/asyncevent.h"
 
 namespace beam::wallet
 {
@@ -87,6 +89,18 @@ namespace beam::wallet
         // @param id - connected node peer id
         // @param connected - true if node has connected otherwise false
         virtual void onOwnedNode(const PeerID& id, bool connected) = 0;
+
+        // Callback for events sync progress while the wallet catches up with the node
+        // @param done - height up to which the events are processed
+        // @param total - current tip height
+        // @param eventsPerSec - processing rate since the catch-up started
+        virtual void onEventsSyncProgress(Height done, Height total, uint32_t eventsPerSec) {}
+
+        // Callback for the progress of the transaction building (the outputs are created by the key keeper)
+        // @param txID - transaction being built
+        // @param done - number of created items
+        // @param total - number of items in the batch
+        virtual void onTxBuildProgress(const TxID& txID, uint32_t done, uint32_t total) {}
     };
     
     // Interface for wallet message consumer
@@ -179,7 +193,10 @@ namespace beam::wallet
         void get_proof_shielded_output(const TxID& txId, const ECC::Point& serialPublic, ProofShildedOutputCallback&& callback) override;
         void register_tx(const TxID& txId, Transaction::Ptr, SubTxID subTxID) override;
         void UpdateOnNextTip(const TxID&) override;
+        void UpdateOnHeight(const TxID&, Height) override;
         void get_UniqueVoucher(const WalletID& peerID, const TxID& txID, boost::optional<ShieldedTxo::Voucher>&) override;
+        bool DoAsync(std::function<void()>&& job, std::function<void()>&& done) override;
+        void on_tx_build_progress(const TxID&, uint32_t nDone, uint32_t nTotal) override;
 
         // IWalletMessageConsumer
         void OnWalletMessage(const WalletID& peerID, const SetTxParameter&) override;
@@ -214,6 +231,21 @@ namespace beam::wallet
         void RequestEvents();
         void AbortEvents();
         void ProcessEventUtxo(const CoinID&, Height h, Height hMaturity, bool bAdd);
+
+        struct UtxoEvent
+        {
+            CoinID m_Cid;
+            ECC::Point m_Commitment;
+            Height m_Height;
+            Height m_Maturity;
+            bool m_Add;
+            bool m_Recognized = false;
+            bool m_Deferred = false; // needs the key keeper, checked on the wallet thread
+        };
+
+        void RecognizeUtxoEvents(std::vector<UtxoEvent>&);
+        static void RecognizeUtxoEvent(UtxoEvent&, Key::IPKdf& ownerKdf);
+        void ReportEventsProgress(uint32_t nCount, Height h, Height hTip);
         void ProcessEventAsset(const proto::Event::AssetCtl& assetCtl, Height h);
         void SetEventsHeight(Height);
         Height GetEventsHeightNext();
@@ -383,12 +415,41 @@ namespace beam::wallet
         // List of transactions that are waiting for the next tip (new block) to arrive
         std::unordered_set<BaseTransaction::Ptr> m_NextTipTransactionToUpdate;
 
+        // Transactions that wait for the tip to reach some height, ordered by that height
+        std::set<std::pair<Height, TxID>> m_HeightTransactionToUpdate;
+
+        // Number of transaction updates performed since the last tip, reported on each new tip
+        uint32_t m_TxUpdatesPerTip = 0;
+
         // Functor for callback when transaction completed
         TxCompletedAction m_TxCompletedAction;
 
         // Functor for callback on completion of all async updates
         UpdateCompletedAction m_UpdateCompleted;
 
+        // Completions of the jobs done on the shared executor, to be invoked on the wallet thread.
+        // Shared with the jobs, the completions are dropped once the wallet is destroyed
+        struct AsyncJobs
+        {
+            std::mutex m_Mutex;
+            std::vector<std::function<void()> > m_vDone;
+            io::AsyncEvent::Ptr m_pEvt; // reset on the wallet destruction
+        };
+
+        std::shared_ptr<AsyncJobs> m_pAsyncJobs;
+        void OnAsyncJobsDone();
+
+        // Re-derives commitments of the incoming UTXO events across the cores, runs the heavy parts of tx building
+        std::shared_ptr<Executor> m_pExecutor;
+        Executor& get_Executor();
+
+        // Events catch-up statistics, reset once the wallet reaches the tip
+        struct EventsProgress
+        {
+            uint64_t m_Start_ms = 0;
+            uint64_t m_Count = 0;
+        } m_EventsProgress;
+
         // Number of tasks running during sync with Node
         uint32_t m_LastSyncTotal;
         uint32_t m_OwnedNodesOnline;
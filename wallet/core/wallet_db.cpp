@@ -16,6 +16,7 @@
 
 #include "utility/logger.h"
 #include "utility/helpers.h"
+#include "utility/executor.h"
 #include "sqlite/sqlite3.h"
 #include "core/block_rw.h"
 #include "wallet/core/common.h"
@@ -84,6 +85,7 @@
 #define NOTIFICATIONS_NAME "notifications"
 #define EXCHANGE_RATES_NAME "exchangeRates"
 #define VOUCHERS_NAME "vouchers"
+#define TX_SUMMARY_NAME "txsummary"
 #define COIN_CONFIRMATIONS_COUNT "confirmations_count"
 
 #define ENUM_VARIABLES_FIELDS(each, sep, obj) \
@@ -111,6 +113,17 @@
 
 #define TX_PARAMS_FIELDS ENUM_TX_PARAMS_FIELDS(LIST, COMMA, )
 
+// Indexed copy of the tx parameters used for filtering and ordering of the tx history
+#define ENUM_TX_SUMMARY_FIELDS(each, sep, obj) \
+    each(txID,           txID,           BLOB NOT NULL PRIMARY KEY, obj) sep \
+    each(txType,         txType,         INTEGER NOT NULL, obj) sep \
+    each(status,         status,         INTEGER NOT NULL, obj) sep \
+    each(assetID,        assetID,        INTEGER NOT NULL, obj) sep \
+    each(proofHeight,    proofHeight,    INTEGER NOT NULL, obj) sep \
+    each(minHeight,      minHeight,      INTEGER NOT NULL, obj)
+
+#define TX_SUMMARY_FIELDS ENUM_TX_SUMMARY_FIELDS(LIST, COMMA, )
+
 #define ENUM_WALLET_MESSAGE_FIELDS(each, sep, obj) \
     each(ID,  ID,  INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, obj) sep \
     each(PeerID, PeerID,   BLOB, obj) sep \
@@ -884,7 +897,8 @@ namespace beam::wallet
         const char* SystemStateIDName = "SystemStateID";
         const char* LastUpdateTimeName = "LastUpdateTime";
         const int BusyTimeoutMs = 5000;
-        const int DbVersion   = 23;
+        const int DbVersion   = 24;
+        const int DbVersion23 = 23;
         const int DbVersion22 = 22;
         const int DbVersion21 = 21;
         const int DbVersion20 = 20;
@@ -1104,6 +1118,16 @@ namespace beam::wallet
             throwIfError(ret, db);
         }
 
+        void CreateTxSummaryTable(sqlite3* db)
+        {
+            const char* req = "CREATE TABLE " TX_SUMMARY_NAME " (" ENUM_TX_SUMMARY_FIELDS(LIST_WITH_TYPES, COMMA, ) ") WITHOUT ROWID;"
+                              "CREATE INDEX TxSummaryHeightIndex ON " TX_SUMMARY_NAME "(minHeight, txID);"
+                              "CREATE INDEX TxSummaryStatusIndex ON " TX_SUMMARY_NAME "(status, minHeight, txID);"
+                              "CREATE INDEX TxSummaryProofHeightIndex ON " TX_SUMMARY_NAME "(proofHeight);";
+            int ret = sqlite3_exec(db, req, nullptr, nullptr, nullptr);
+            throwIfError(ret, db);
+        }
+
         void CreateStatesTable(sqlite3* db)
         {
             const char* req = "CREATE TABLE [" TblStates "] ("
@@ -1333,6 +1357,7 @@ namespace beam::wallet
         CreateVariablesTable(db);
         CreateAddressesTable(db);
         CreateTxParamsTable(db);
+        CreateTxSummaryTable(db);
         CreateStatesTable(db);
         CreateLaserTables(db);
         CreateAssetsTable(db);
@@ -1391,6 +1416,11 @@ namespace beam::wallet
     {
         using LocalPrivateKeyKeeperStd::LocalPrivateKeyKeeperStd;
 
+        ~LocalKeyKeeper()
+        {
+            StopParallel();
+        }
+
         struct UsedSlots
         {
             static const char s_szDbName[];
@@ -1468,6 +1498,9 @@ namespace beam::wallet
         {
             m_pKeyKeeper = std::make_shared<LocalKeyKeeper>(m_pKdfMaster);
             m_pLocalKeyKeeper = &Cast::Up<LocalKeyKeeper>(*m_pKeyKeeper);
+#ifndef EMSCRIPTEN
+            m_pLocalKeyKeeper->EnableParallel(GetSharedExecutor());
+#endif // EMSCRIPTEN
         }
 
         UpdateLocalSlots();
@@ -1807,6 +1840,12 @@ namespace beam::wallet
 
                 case DbVersion22:
                     CreateShieldedCoinsTableIndex(db);
+                    // no break
+
+                case DbVersion23:
+                    LOG_INFO() << "Converting DB from format 23...";
+                    CreateTxSummaryTable(walletDB->_db);
+                    walletDB->fillTxSummary();
 
                     storage::setVar(*walletDB, Version, DbVersion);
                     // no break
@@ -1969,6 +2008,7 @@ namespace beam::wallet
             {
                 try
                 {
+                    saveTxParameters();
                     m_DbTransaction->commit();
                 }
                 catch (const runtime_error& ex)
@@ -2217,6 +2257,10 @@ namespace beam::wallet
         MyParser p(*this, prog);
         p.Init(get_OwnerKdf());
 
+        // shielded outputs are recognized in parallel
+        ExecutorMT exec;
+        Executor::Scope scope(exec);
+
         return p.Proceed(path.c_str());
 	}
 
@@ -2802,6 +2846,49 @@ namespace beam::wallet
         }
     }
 
+    vector<Coin> WalletDB::getCoinsPage(const boost::optional<Asset::ID>& assetId, const boost::optional<Coin::ID>& after, size_t skip, int count) const
+    {
+        std::string req = "SELECT " STORAGE_FIELDS " FROM " STORAGE_NAME " WHERE 1";
+        if (after)
+        {
+            // unknown coin gives NULL, i.e. an empty page
+            req += " AND ROWID > (SELECT ROWID FROM " STORAGE_NAME STORAGE_WHERE_ID ")";
+        }
+        if (assetId)
+        {
+            req += " AND assetId = ?";
+        }
+        req += " ORDER BY ROWID LIMIT ? OFFSET ?;";
+
+        sqlite::Statement stm(this, req.c_str());
+        int colIdx = 0;
+        if (after)
+        {
+            Coin coin;
+            coin.m_ID = *after;
+            STORAGE_BIND_ID(coin);
+        }
+        if (assetId)
+        {
+            stm.bind(++colIdx, *assetId);
+        }
+        stm.bind(++colIdx, count);
+        stm.bind(++colIdx, static_cast<uint64_t>(skip));
+
+        vector<Coin> res;
+        Height h = getCurrentHeight();
+        while (stm.step())
+        {
+            Coin& coin = res.emplace_back();
+
+            colIdx = 0;
+            ENUM_ALL_STORAGE_FIELDS(STM_GET_LIST, NOSEP, coin);
+
+            storage::DeduceStatus(*this, coin, h);
+        }
+        return res;
+    }
+
     void WalletDB::setVarRaw(const char* name, const void* data, size_t size)
     {
         const char* req = "INSERT or REPLACE INTO " VARIABLES_NAME " (" VARIABLES_FIELDS ") VALUES(?1, ?2);";
@@ -3111,6 +3198,8 @@ namespace beam::wallet
     vector<TxDescription> WalletDB::getTxHistory(wallet::TxType txType, uint64_t start, int count) const
     {
         // TODO this is temporary solution
+        saveTxParameters();
+
         int txCount = 0;
         {
             std::string req = "SELECT COUNT(DISTINCT txID) FROM " TX_PARAMS_NAME " WHERE paramID = ?1";
@@ -3170,30 +3259,118 @@ namespace beam::wallet
 
         return res;
     }
-    
+
+    vector<TxDescription> WalletDB::getTxHistoryPage(const TxHistoryFilter& filter, const boost::optional<TxID>& after, size_t skip, int count) const
+    {
+        std::string req = "SELECT txID FROM " TX_SUMMARY_NAME " WHERE 1";
+        if (after)
+        {
+            // keyset condition, unknown transaction gives NULL, i.e. an empty page
+            req += " AND (minHeight < (SELECT minHeight FROM " TX_SUMMARY_NAME " WHERE txID = ?1)"
+                   " OR (minHeight = (SELECT minHeight FROM " TX_SUMMARY_NAME " WHERE txID = ?1) AND txID < ?1))";
+        }
+        if (!filter.m_txTypes.empty())
+        {
+            req += " AND txType IN (?";
+            for (size_t i = 1; i < filter.m_txTypes.size(); ++i)
+            {
+                req += ", ?";
+            }
+            req += ")";
+        }
+        if (filter.m_status)
+        {
+            req += " AND status = ?";
+        }
+        if (filter.m_assetId)
+        {
+            req += " AND assetID = ?";
+        }
+        if (filter.m_proofHeight)
+        {
+            req += " AND proofHeight = ?";
+        }
+        req += " ORDER BY minHeight DESC, txID DESC LIMIT ? OFFSET ?;";
+
+        sqlite::Statement stm(this, req.c_str());
+        int colIdx = 0;
+        if (after)
+        {
+            stm.bind(++colIdx, *after);
+        }
+        for (auto txType : filter.m_txTypes)
+        {
+            stm.bind(++colIdx, txType);
+        }
+        if (filter.m_status)
+        {
+            stm.bind(++colIdx, *filter.m_status);
+        }
+        if (filter.m_assetId)
+        {
+            stm.bind(++colIdx, *filter.m_assetId);
+        }
+        if (filter.m_proofHeight)
+        {
+            stm.bind(++colIdx, *filter.m_proofHeight);
+        }
+        stm.bind(++colIdx, count);
+        stm.bind(++colIdx, static_cast<uint64_t>(skip));
+
+        vector<TxDescription> res;
+        while (stm.step())
+        {
+            TxID txID;
+            stm.get(0, txID);
+            auto t = getTx(txID);
+            if (t.is_initialized())
+            {
+                res.emplace_back(*t);
+            }
+        }
+        return res;
+    }
+
     boost::optional<TxDescription> WalletDB::getTx(const TxID& txId) const
     {
         // load only simple TX that supported by TxDescription
-        const char* req = "SELECT * FROM " TX_PARAMS_NAME " WHERE txID=?1;";
-        sqlite::Statement stm(this, req);
-        stm.bind(1, txId);
-
         TxDescription txDescription(txId);
         std::set<TxParameterID> gottenParams;
 
-        while (stm.step())
+        auto addParameter = [&](TxParameterID parameterID, const ByteBuffer& value, SubTxID subTxID)
         {
-            TxParameter parameter = {};
-            int colIdx = 0;
-            ENUM_TX_PARAMS_FIELDS(STM_GET_LIST, NOSEP, parameter);
-            auto parameterID = static_cast<TxParameterID>(parameter.m_paramID);
-
-            txDescription.SetParameter(parameterID, parameter.m_value, static_cast<SubTxID>(parameter.m_subTxID));
+            txDescription.SetParameter(parameterID, value, subTxID);
 
-            if (parameter.m_subTxID == kDefaultSubTxID)
+            if (subTxID == kDefaultSubTxID)
             {
                 gottenParams.emplace(parameterID);
             }
+        };
+
+        // the cached txs can have unsaved parameters, the rest are read without caching
+        if (auto txIter = m_TxParametersCache.find(txId); txIter != m_TxParametersCache.end())
+        {
+            for (const auto& [subTxID, params] : txIter->second)
+            {
+                for (const auto& [parameterID, value] : params)
+                {
+                    addParameter(parameterID, value, subTxID);
+                }
+            }
+        }
+        else
+        {
+            const char* req = "SELECT * FROM " TX_PARAMS_NAME " WHERE txID=?1;";
+            sqlite::Statement stm(this, req);
+            stm.bind(1, txId);
+
+            while (stm.step())
+            {
+                TxParameter parameter = {};
+                int colIdx = 0;
+                ENUM_TX_PARAMS_FIELDS(STM_GET_LIST, NOSEP, parameter);
+                addParameter(static_cast<TxParameterID>(parameter.m_paramID), parameter.m_value, static_cast<SubTxID>(parameter.m_subTxID));
+            }
         }
 
         txDescription.fillFromTxParameters(txDescription);
@@ -3239,6 +3416,8 @@ namespace beam::wallet
         auto tx = getTx(txId);
         if (tx.is_initialized())
         {
+            saveTxParameters();
+
             // we left one record about tx type in order to avoid re-launching of deleted transaction
             const char* req = "DELETE FROM " TX_PARAMS_NAME " WHERE txID=?1 AND paramID!=?2;";
             sqlite::Statement stm(this, req);
@@ -3248,6 +3427,7 @@ namespace beam::wallet
 
             stm.step();
             deleteParametersFromCache(txId);
+            deleteTxSummary(txId);
             notifyTransactionChanged(ChangeAction::Removed, { *tx });
         }
     }
@@ -3954,65 +4134,37 @@ namespace beam::wallet
 
     bool WalletDB::setTxParameter(const TxID& txID, SubTxID subTxID, TxParameterID paramID, const ByteBuffer& blob, bool shouldNotifyAboutChanges)
     {
-        if (auto txIter = m_TxParametersCache.find(txID); txIter != m_TxParametersCache.end())
+        bool hasTx = hasTransaction(txID);
+
+        auto& params = loadTxParameters(txID)[subTxID];
+        auto pit = params.find(paramID);
+        if (pit != params.end())
         {
-            if (auto subTxIter = txIter->second.find(subTxID); subTxIter != txIter->second.end())
+            if (blob == pit->second)
             {
-                if (auto pit = subTxIter->second.find(paramID); pit != subTxIter->second.end())
-                {
-                    if (pit->second && blob == *(pit->second))
-                    {
-                        return false;
-                    }
-                }
+                return false;
             }
-        }
 
-        bool hasTx = hasTransaction(txID);
-        {
-            sqlite::Statement stm(this, "SELECT * FROM " TX_PARAMS_NAME " WHERE txID=?1 AND subTxID=?2 AND paramID=?3;");
+            // already set
+            if (paramID < TxParameterID::PrivateFirstParam)
+            {
+                return false;
+            }
 
-            stm.bind(1, txID);
-            stm.bind(2, subTxID);
-            stm.bind(3, paramID);
+            pit->second = blob;
+        }
+        else
+        {
+            params.emplace(paramID, blob);
+        }
 
-            if (stm.step())
-            {
-                // already set
-                if (paramID < TxParameterID::PrivateFirstParam)
-                {
-                    return false;
-                }
+        // written on flush, together with the rest of the batch
+        onPrepareToModify();
+        m_DirtyTxParameters.emplace(txID, subTxID, paramID);
+        onModified();
 
-                sqlite::Statement stm2(this, "UPDATE " TX_PARAMS_NAME  " SET value = ?4 WHERE txID = ?1 AND subTxID=?2 AND paramID = ?3;");
-                stm2.bind(1, txID);
-                stm2.bind(2, subTxID);
-                stm2.bind(3, paramID);
-                stm2.bind(4, blob);
-                stm2.step();
+        updateTxSummary(txID, subTxID, paramID);
 
-                if (shouldNotifyAboutChanges)
-                {
-                    auto tx = getTx(txID);
-                    if (tx.is_initialized())
-                    {
-                        notifyTransactionChanged(ChangeAction::Updated, { *tx });
-                    }
-                }
-                insertParameterToCache(txID, subTxID, paramID, blob);
-                return true;
-            }
-        }
-        
-        sqlite::Statement stm(this, "INSERT INTO " TX_PARAMS_NAME " (" ENUM_TX_PARAMS_FIELDS(LIST, COMMA, ) ") VALUES(" ENUM_TX_PARAMS_FIELDS(BIND_LIST, COMMA, ) ");");
-        TxParameter parameter;
-        parameter.m_txID = txID;
-        parameter.m_subTxID = subTxID;
-        parameter.m_paramID = static_cast<int>(paramID);
-        parameter.m_value = blob;
-        int colIdx = 0;
-        ENUM_TX_PARAMS_FIELDS(STM_BIND_LIST, NOSEP, parameter);
-        stm.step();
         if (shouldNotifyAboutChanges)
         {
             auto tx = getTx(txID);
@@ -4021,49 +4173,98 @@ namespace beam::wallet
                 notifyTransactionChanged(hasTx ? ChangeAction::Updated : ChangeAction::Added, { *tx });
             }
         }
-        insertParameterToCache(txID, subTxID, paramID, blob);
         return true;
     }
 
-    bool WalletDB::getTxParameter(const TxID& txID, SubTxID subTxID, TxParameterID paramID, ByteBuffer& blob) const
+    void WalletDB::updateTxSummary(const TxID& txID, SubTxID subTxID, TxParameterID paramID)
     {
-        if (auto txIter = m_TxParametersCache.find(txID); txIter != m_TxParametersCache.end())
+        if (subTxID != kDefaultSubTxID)
         {
-            if (auto subTxIter = txIter->second.find(subTxID); subTxIter != txIter->second.end())
+            return;
+        }
+
+        switch (paramID)
+        {
+        case TxParameterID::Status:
+        case TxParameterID::AssetID:
+        case TxParameterID::MinHeight:
+        case TxParameterID::KernelProofHeight:
+        case TxParameterID::AssetConfirmedHeight:
+            break;
+
+        default:
+            // the tx appears in the history once all the mandatory parameters are set
+            if (m_mandatoryTxParams.find(paramID) == m_mandatoryTxParams.end())
             {
-                if (auto pit = subTxIter->second.find(paramID); pit != subTxIter->second.end())
-                {
-                    if (pit->second)
-                    {
-                        blob = *(pit->second);
-                        return true;
-                    }
-                    return false;
-                }
+                return;
             }
         }
 
-        sqlite::Statement stm(this, "SELECT * FROM " TX_PARAMS_NAME " WHERE txID=?1 AND subTxID=?2 AND paramID=?3;");
+        saveTxSummary(txID);
+    }
 
+    void WalletDB::saveTxSummary(const TxID& txID)
+    {
+        auto tx = getTx(txID);
+        if (!tx)
+        {
+            return;
+        }
+
+        sqlite::Statement stm(this, "INSERT OR REPLACE INTO " TX_SUMMARY_NAME " (" TX_SUMMARY_FIELDS ") VALUES(" ENUM_TX_SUMMARY_FIELDS(BIND_LIST, COMMA, ) ");");
         stm.bind(1, txID);
-        stm.bind(2, subTxID);
-        stm.bind(3, paramID);
+        stm.bind(2, tx->m_txType);
+        stm.bind(3, tx->m_status);
+        stm.bind(4, tx->m_assetId);
+        stm.bind(5, storage::DeduceTxProofHeight(*this, *tx));
+        stm.bind(6, tx->m_minHeight);
+        stm.step();
+    }
 
-        if (stm.step())
+    void WalletDB::deleteTxSummary(const TxID& txID)
+    {
+        sqlite::Statement stm(this, "DELETE FROM " TX_SUMMARY_NAME " WHERE txID=?1;");
+        stm.bind(1, txID);
+        stm.step();
+    }
+
+    void WalletDB::fillTxSummary()
+    {
+        saveTxParameters();
+
+        std::vector<TxID> txIDs;
         {
-            TxParameter parameter = {};
-            int colIdx = 0;
-            ENUM_TX_PARAMS_FIELDS(STM_GET_LIST, NOSEP, parameter);
-            blob = move(parameter.m_value);
-            insertParameterToCache(txID, subTxID, paramID, blob);
-            return true;
+            sqlite::Statement stm(this, "SELECT DISTINCT txID FROM " TX_PARAMS_NAME ";");
+            while (stm.step())
+            {
+                stm.get(0, txIDs.emplace_back());
+            }
+        }
+
+        for (const auto& txID : txIDs)
+        {
+            saveTxSummary(txID);
+        }
+    }
+
+    bool WalletDB::getTxParameter(const TxID& txID, SubTxID subTxID, TxParameterID paramID, ByteBuffer& blob) const
+    {
+        const auto& params = loadTxParameters(txID);
+        if (auto subTxIter = params.find(subTxID); subTxIter != params.end())
+        {
+            if (auto pit = subTxIter->second.find(paramID); pit != subTxIter->second.end())
+            {
+                blob = pit->second;
+                return true;
+            }
         }
-        insertParameterToCache(txID, subTxID, paramID, boost::optional<ByteBuffer>());
         return false;
     }
 
     std::vector<TxParameter> WalletDB::getAllTxParameters() const
     {
+        saveTxParameters();
+
         sqlite::Statement stm(this, "SELECT * FROM " TX_PARAMS_NAME ";");
         std::vector<TxParameter> res;
         while (stm.step())
@@ -4071,18 +4272,82 @@ namespace beam::wallet
             auto& p = res.emplace_back();
             int colIdx = 0;
             ENUM_TX_PARAMS_FIELDS(STM_GET_LIST, NOSEP, p);
-            insertParameterToCache(
-				p.m_txID,
-				static_cast<SubTxID>(p.m_subTxID),
-				static_cast<TxParameterID>(p.m_paramID),
-				p.m_value);
         }
         return res;
     }
 
-    void WalletDB::insertParameterToCache(const TxID& txID, SubTxID subTxID, TxParameterID paramID, const boost::optional<ByteBuffer>& blob) const
+    WalletDB::TxParameterMap& WalletDB::loadTxParameters(const TxID& txID) const
     {
-        m_TxParametersCache[txID][subTxID][paramID] = blob;
+        if (auto txIter = m_TxParametersCache.find(txID); txIter != m_TxParametersCache.end())
+        {
+            return txIter->second;
+        }
+
+        auto& params = m_TxParametersCache[txID];
+
+        sqlite::Statement stm(this, "SELECT * FROM " TX_PARAMS_NAME " WHERE txID=?1;");
+        stm.bind(1, txID);
+
+        while (stm.step())
+        {
+            TxParameter parameter = {};
+            int colIdx = 0;
+            ENUM_TX_PARAMS_FIELDS(STM_GET_LIST, NOSEP, parameter);
+            params[static_cast<SubTxID>(parameter.m_subTxID)][static_cast<TxParameterID>(parameter.m_paramID)] = std::move(parameter.m_value);
+        }
+        return params;
+    }
+
+    void WalletDB::saveTxParameters() const
+    {
+        if (m_DirtyTxParameters.empty())
+        {
+            return;
+        }
+
+        // m_DbTransaction is open while there are dirty parameters
+        assert(m_DbTransaction);
+
+        sqlite::Statement stm(this, "INSERT OR REPLACE INTO " TX_PARAMS_NAME " (" ENUM_TX_PARAMS_FIELDS(LIST, COMMA, ) ") VALUES(" ENUM_TX_PARAMS_FIELDS(BIND_LIST, COMMA, ) ");");
+        for (const auto& [txID, subTxID, paramID] : m_DirtyTxParameters)
+        {
+            stm.Reset();
+            stm.bind(1, txID);
+            stm.bind(2, subTxID);
+            stm.bind(3, paramID);
+            stm.bind(4, m_TxParametersCache.at(txID).at(subTxID).at(paramID));
+            stm.step();
+        }
+        m_DirtyTxParameters.clear();
+    }
+
+    void WalletDB::evictFinishedTxParameters() const
+    {
+        // everything is saved, the finished txs are not going to be modified, hence loaded again only if read
+        assert(m_DirtyTxParameters.empty());
+
+        for (auto it = m_TxParametersCache.begin(); it != m_TxParametersCache.end(); )
+        {
+            TxStatus status = TxStatus::Pending;
+            auto itSub = it->second.find(kDefaultSubTxID);
+            if (itSub != it->second.end())
+            {
+                auto itParam = itSub->second.find(TxParameterID::Status);
+                if (itParam != itSub->second.end())
+                {
+                    fromByteBuffer(itParam->second, status);
+                }
+            }
+
+            if (TxStatus::Completed == status || TxStatus::Failed == status || TxStatus::Canceled == status)
+            {
+                it = m_TxParametersCache.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
     }
 
     void WalletDB::deleteParametersFromCache(const TxID& txID)
@@ -4125,6 +4390,10 @@ namespace beam::wallet
                 m_DbTransaction->rollback();
                 m_DbTransaction.reset();
             }
+
+            // the cache may have the rolled back values
+            m_DirtyTxParameters.clear();
+            m_TxParametersCache.clear();
         }
     }
 
@@ -4147,6 +4416,8 @@ namespace beam::wallet
 
     void WalletDB::onFlushTimer()
     {
+        saveTxParameters();
+        evictFinishedTxParameters();
         m_IsFlushPending = false;
         if (m_DbTransaction)
         {
@@ -347,6 +347,15 @@ namespace beam::wallet
         virtual void onShieldedCoinsChanged(ChangeAction action, const std::vector<ShieldedCoin>& items) {};
     };
 
+    // Conditions of the paged tx history, unset conditions match any tx
+    struct TxHistoryFilter
+    {
+        std::vector<wallet::TxType> m_txTypes;
+        boost::optional<wallet::TxStatus> m_status;
+        boost::optional<Asset::ID> m_assetId;
+        boost::optional<Height> m_proofHeight;
+    };
+
     struct IWalletDB : IVariablesDB
     {
         using Ptr = std::shared_ptr<IWalletDB>;
@@ -423,6 +432,9 @@ namespace beam::wallet
         virtual void visitShieldedCoins(std::function<bool(const ShieldedCoin& info)> func) = 0;
         virtual void visitShieldedCoinsUnspent(const std::function<bool(const ShieldedCoin& info)>& func) = 0;
 
+        // Coins in the order of visitCoins. If 'after' is specified the page starts right after this coin
+        virtual std::vector<Coin> getCoinsPage(const boost::optional<Asset::ID>& assetId, const boost::optional<Coin::ID>& after, size_t skip = 0, int count = std::numeric_limits<int>::max()) const = 0;
+
         // Used in split API for session management
         virtual bool lockCoins(const CoinIDList& list, uint64_t session) = 0;
         virtual bool unlockCoins(uint64_t session) = 0;
@@ -450,6 +462,9 @@ namespace beam::wallet
         // /////////////////////////////////////////////
         // Transaction management
         virtual std::vector<TxDescription> getTxHistory(wallet::TxType txType = wallet::TxType::Simple, uint64_t start = 0, int count = std::numeric_limits<int>::max()) const = 0;
+        // Transactions ordered by MinHeight descending, then by TxID. If 'after' is specified the page starts right after this tx,
+        // so the pages stay consistent while new transactions arrive
+        virtual std::vector<TxDescription> getTxHistoryPage(const TxHistoryFilter& filter, const boost::optional<TxID>& after, size_t skip = 0, int count = std::numeric_limits<int>::max()) const = 0;
         virtual boost::optional<TxDescription> getTx(const TxID& txId) const = 0;
         virtual void saveTx(const TxDescription& p) = 0;
         virtual void deleteTx(const TxID& txId) = 0;
@@ -488,7 +503,8 @@ namespace beam::wallet
 
         virtual void changePassword(const SecString& password) = 0;
 
-        // Block History management, used in FlyClient
+        // Block History management, used in FlyClient.
+        // Persistent: the headers are kept in the States table, keyed by height, so a reconnecting wallet resumes from its stored tip
         virtual Block::SystemState::IHistory& get_History() = 0;
         virtual void ShrinkHistory() = 0;
 
@@ -583,6 +599,7 @@ namespace beam::wallet
         void visitAssets(std::function<bool(const WalletAsset& info)> func) override;
         void visitShieldedCoins(std::function<bool(const ShieldedCoin& info)> func) override;
         void visitShieldedCoinsUnspent(const std::function<bool(const ShieldedCoin& info)>& func) override;
+        std::vector<Coin> getCoinsPage(const boost::optional<Asset::ID>& assetId, const boost::optional<Coin::ID>& after, size_t skip, int count) const override;
 
         void setVarRaw(const char* name, const void* data, size_t size) override;
         bool getVarRaw(const char* name, void* data, int size) const override;
@@ -606,6 +623,7 @@ namespace beam::wallet
         void rollbackConfirmedShieldedUtxo(Height minHeight) override;
 
         std::vector<TxDescription> getTxHistory(wallet::TxType txType, uint64_t start, int count) const override;
+        std::vector<TxDescription> getTxHistoryPage(const TxHistoryFilter& filter, const boost::optional<TxID>& after, size_t skip, int count) const override;
         boost::optional<TxDescription> getTx(const TxID& txId) const override;
         void saveTx(const TxDescription& p) override;
         void deleteTx(const TxID& txId) override;
@@ -701,11 +719,20 @@ namespace beam::wallet
 
         // ////////////////////////////////////////
         // Cache for optimized access for database fields
-        using ParameterCache = std::map<TxID, std::map<SubTxID, std::map<TxParameterID, boost::optional<ByteBuffer>>>>;
-
-        void insertParameterToCache(const TxID& txID, SubTxID subTxID, TxParameterID paramID, const boost::optional<ByteBuffer>& blob) const;
+        // Parameters of a tx are loaded all at once, on the first access. Changes are written back on flush
+        using TxParameterMap = std::map<SubTxID, std::map<TxParameterID, ByteBuffer>>;
+        using ParameterCache = std::map<TxID, TxParameterMap>;
+        using ParameterKey = std::tuple<TxID, SubTxID, TxParameterID>;
+
+        TxParameterMap& loadTxParameters(const TxID& txID) const;
+        void saveTxParameters() const;
+        void evictFinishedTxParameters() const;
         void deleteParametersFromCache(const TxID& txID);
         bool hasTransaction(const TxID& txID) const;
+        void updateTxSummary(const TxID& txID, SubTxID subTxID, TxParameterID paramID);
+        void saveTxSummary(const TxID& txID);
+        void deleteTxSummary(const TxID& txID);
+        void fillTxSummary();
         void insertAddressToCache(const WalletID& id, const boost::optional<WalletAddress>& address) const;
         void deleteAddressFromCache(const WalletID& id);
         void flushDB();
@@ -743,6 +770,7 @@ namespace beam::wallet
         } m_History;
         
         mutable ParameterCache m_TxParametersCache;
+        mutable std::set<ParameterKey> m_DirtyTxParameters; // not written yet, within m_DbTransaction
         mutable std::map<WalletID, boost::optional<WalletAddress>> m_AddressesCache;
 
         struct LocalKeyKeeper;
@@ -57,53 +57,94 @@ namespace beam::wallet {
             DeleteAddr(m_Addresses.begin()->get_ParentObj());
     }
 
-    void BaseMessageEndpoint::ProcessMessage(BbsChannel channel, const ByteBuffer& msg)
+    bool BaseMessageEndpoint::ProcessMessage(BbsChannel channel, const ByteBuffer& msg, Timestamp timePosted)
     {
-        Addr::Channel key;
-        key.m_Value = channel;
+        BbsDecryptor::KeyListPtr pKeys = get_ChannelKeys(channel);
+        if (pKeys && !m_pKdfSbbs)
+        {
+            // read-only wallet
+            m_WalletDB->saveIncomingWalletMessage(channel, msg);
+            OnIncomingMessage();
+        }
 
-        for (ChannelSet::iterator it = m_Channels.lower_bound(key); ; ++it)
+        if (!pKeys || !m_pKdfSbbs || msg.empty())
         {
-            if (m_Channels.end() == it)
-                break;
-            if (it->m_Value != channel)
-                break; // as well
+            OnMessageHandled(channel, timePosted);
+            return true;
+        }
+
+        // decrypted and parsed on the decryptor threads, the results come back in the arrival order
+        BbsDecryptor::Task::Ptr pTask = std::make_shared<BbsDecryptor::Task>();
+        pTask->m_Msg = msg;
+        pTask->m_pKeys = std::move(pKeys);
+        pTask->m_Channel = channel;
+        pTask->m_TimePosted = timePosted;
 
+        if (!m_Decryptor.IsStarted())
+            m_Decryptor.Start([this]() { OnDecrypted(); });
 
-            if (!m_pKdfSbbs)
+        if (!m_Decryptor.Push(std::move(pTask)))
+        {
+            m_DecryptorOverloaded = true;
+            return false;
+        }
+
+        return true;
+    }
+
+    void BaseMessageEndpoint::OnDecrypted()
+    {
+        while (true)
+        {
+            BbsDecryptor::Task::Ptr pTask = m_Decryptor.Pop();
+            if (!pTask)
+                break;
+
+            if (pTask->m_Valid)
             {
-                // read-only wallet
-                m_WalletDB->saveIncomingWalletMessage(channel, msg);
-                OnIncomingMessage();
-                return;
+                // the address could be deleted meanwhile
+                Addr::Wid key;
+                key.m_Value = pTask->m_Wid;
+                if (m_Addresses.end() != m_Addresses.find(key))
+                    m_Wallet.OnWalletMessage(pTask->m_Wid, pTask->m_Parameters);
             }
 
-            ByteBuffer buf = msg; // duplicate
-            uint8_t* pMsg = &buf.front();
-            uint32_t nSize = static_cast<uint32_t>(buf.size());
+            OnMessageHandled(pTask->m_Channel, pTask->m_TimePosted);
+        }
 
-            if (!proto::Bbs::Decrypt(pMsg, nSize, it->get_ParentObj().m_sk))
-                continue;
+        // resume once half of the room is free, not to flip on every message
+        if (m_DecryptorOverloaded && (m_Decryptor.get_InProgress() <= BbsDecryptor::s_MaxInProgress / 2))
+        {
+            m_DecryptorOverloaded = false;
+            OnDecryptorVacant();
+        }
+    }
 
-            SetTxParameter msgWallet;
-            bool bValid = false;
+    BbsDecryptor::KeyListPtr BaseMessageEndpoint::get_ChannelKeys(BbsChannel channel)
+    {
+        auto itKeys = m_ChannelKeys.find(channel);
+        if (m_ChannelKeys.end() != itKeys)
+            return itKeys->second;
 
-            try {
-                Deserializer der;
-                der.reset(pMsg, nSize);
-                der& msgWallet;
-                bValid = true;
-            }
-            catch (const std::exception&) {
-                LOG_WARNING() << "BBS deserialization failed";
-            }
+        Addr::Channel key;
+        key.m_Value = channel;
 
-            if (bValid)
-            {
-                m_Wallet.OnWalletMessage(it->get_ParentObj().m_Wid.m_Value, msgWallet);
-                break;
-            }
+        ChannelSet::iterator it = m_Channels.lower_bound(key);
+        if ((m_Channels.end() == it) || (it->m_Value != channel))
+            return BbsDecryptor::KeyListPtr();
+
+        auto pKeys = std::make_shared<BbsDecryptor::KeyList>();
+        for ( ; (m_Channels.end() != it) && (it->m_Value == channel); ++it)
+        {
+            const Addr& addr = it->get_ParentObj();
+
+            BbsDecryptor::Key& k = pKeys->emplace_back();
+            k.m_Wid = addr.m_Wid.m_Value;
+            k.m_sk = addr.m_sk;
         }
+
+        m_ChannelKeys[channel] = pKeys;
+        return pKeys;
     }
 
     BaseMessageEndpoint::Addr* BaseMessageEndpoint::CreateOwnAddr(const WalletID& wid)
@@ -114,6 +155,7 @@ namespace beam::wallet {
 
         m_Addresses.insert(pAddr->m_Wid);
         m_Channels.insert(pAddr->m_Channel);
+        m_ChannelKeys.erase(pAddr->m_Channel.m_Value);
 
         if (IsSingleChannelUser(pAddr->m_Channel))
             OnChannelAdded(pAddr->m_Channel.m_Value);
@@ -166,6 +208,7 @@ namespace beam::wallet {
 
         m_Addresses.erase(WidSet::s_iterator_to(v.m_Wid));
         m_Channels.erase(ChannelSet::s_iterator_to(v.m_Channel));
+        m_ChannelKeys.erase(v.m_Channel.m_Value);
         delete& v;
     }
 
@@ -403,23 +446,99 @@ namespace beam::wallet {
 		if (msg.m_Message.empty())
 			return;
 
-		auto itBbs = m_BbsTimestamps.find(msg.m_Channel);
-		if (m_BbsTimestamps.end() != itBbs)
-        {
-			std::setmax(itBbs->second, msg.m_TimePosted);
-        }
+		auto it = m_BbsChannels.find(msg.m_Channel);
+		if (m_BbsChannels.end() == it)
+			return;
+
+		BbsChannelState& c = it->second;
+		bool bAccepted = false;
+
+		if (!c.m_Suspended)
+		{
+			auto itT = c.m_InProgress.insert(msg.m_TimePosted); // before it's possibly handled right away
+			bAccepted = ProcessMessage(msg.m_Channel, msg.m_Message, msg.m_TimePosted);
+
+			if (!bAccepted)
+				c.m_InProgress.erase(itT);
+		}
+
+		if (bAccepted)
+		{
+			if (c.m_Held && (msg.m_TimePosted >= c.m_Held))
+				c.m_Held = 0; // received again after the resume
+		}
 		else
-        {
-			m_BbsTimestamps[msg.m_Channel] = msg.m_TimePosted;
-        }
+		{
+			// keep the channel from the rejected message, and stop receiving until the decryptor has room
+			if (!c.m_Held || (msg.m_TimePosted < c.m_Held))
+				c.m_Held = msg.m_TimePosted;
+
+			if (!c.m_Suspended)
+			{
+				c.m_Suspended = true;
+				m_NodeEndpoint->BbsSubscribe(msg.m_Channel, 0, nullptr);
+				LOG_WARNING() << "BBS channel " << msg.m_Channel << " suspended, the decryptor is overloaded";
+			}
+		}
+
+		UpdateBbsTimestamp(msg.m_Channel, c);
+	}
+
+	void WalletNetworkViaBbs::OnMessageHandled(BbsChannel channel, Timestamp timePosted)
+	{
+		auto it = m_BbsChannels.find(channel);
+		if (m_BbsChannels.end() == it)
+			return; // deleted meanwhile
+
+		BbsChannelState& c = it->second;
+
+		auto itT = c.m_InProgress.find(timePosted);
+		if (c.m_InProgress.end() != itT)
+			c.m_InProgress.erase(itT);
+
+		std::setmax(c.m_Handled, timePosted);
+
+		UpdateBbsTimestamp(channel, c);
+	}
+
+	void WalletNetworkViaBbs::OnDecryptorVacant()
+	{
+		for (auto& x : m_BbsChannels)
+		{
+			BbsChannelState& c = x.second;
+			if (!c.m_Suspended)
+				continue;
+
+			c.m_Suspended = false;
+			m_NodeEndpoint->BbsSubscribe(x.first, c.get_ResumeTime(), get_BbsReceiver());
+			LOG_INFO() << "BBS channel " << x.first << " resumed";
+		}
+	}
+
+	Timestamp WalletNetworkViaBbs::BbsChannelState::get_ResumeTime() const
+	{
+		Timestamp ts = m_Handled;
+		if (!m_InProgress.empty())
+			std::setmin(ts, *m_InProgress.begin());
+		if (m_Held)
+			std::setmin(ts, m_Held);
+		return ts;
+	}
+
+	void WalletNetworkViaBbs::UpdateBbsTimestamp(BbsChannel channel, const BbsChannelState& c)
+	{
+		Timestamp ts = c.get_ResumeTime();
+		m_BbsTimestamps[channel] = ts;
+
+		// the network resumes from the last received message otherwise
+		if (!c.m_Suspended)
+			m_NodeEndpoint->BbsSubscribe(channel, ts, get_BbsReceiver());
 
 		if (!m_pTimerBbsTmSave)
 		{
 			m_pTimerBbsTmSave = io::Timer::create(io::Reactor::get_Current());
 			m_pTimerBbsTmSave->start(60*1000, false, [this]() { OnTimerBbsTmSave(); });
 		}
-
-        ProcessMessage(msg.m_Channel, msg.m_Message);
 	}
 
     void WalletNetworkViaBbs::SendRawMessage(const WalletID& peerID, const ByteBuffer& msg)
@@ -436,11 +555,13 @@ namespace beam::wallet {
         if (m_BbsTimestamps.end() != it)
             ts = it->second;
 
+        m_BbsChannels[channel].m_Handled = ts;
         m_NodeEndpoint->BbsSubscribe(channel, ts, get_BbsReceiver());
 	}
 
     void WalletNetworkViaBbs::OnChannelDeleted(BbsChannel channel)
     {
+        m_BbsChannels.erase(channel);
         m_NodeEndpoint->BbsSubscribe(channel, 0, nullptr);
 	}
 
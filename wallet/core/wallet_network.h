@@ -18,8 +18,10 @@
 #include "core/proto.h"
 #include "utility/io/timer.h"
 #include "bbs_miner.h"
+#include "bbs_decryptor.h"
 #include <boost/intrusive/set.hpp>
 #include <boost/intrusive/list.hpp>
+#include <set>
 #include "wallet_request_bbs_msg.h"
 #include "wallet.h"
 
@@ -58,16 +60,20 @@ namespace beam::wallet
         void AddOwnAddress(const WalletAddress& address);
         void DeleteOwnAddress(const WalletID&);
     protected:
-        void ProcessMessage(BbsChannel channel, const ByteBuffer& msg);
+        bool ProcessMessage(BbsChannel channel, const ByteBuffer& msg, Timestamp timePosted); // false if the decryptor is overloaded, the message must be fetched again
         void Subscribe();
         void Unsubscribe();
         virtual void OnChannelAdded(BbsChannel channel) {};
         virtual void OnChannelDeleted(BbsChannel channel) {};
         virtual void OnIncomingMessage() {};
+        virtual void OnMessageHandled(BbsChannel channel, Timestamp timePosted) {}; // for each accepted message, valid or not
+        virtual void OnDecryptorVacant() {}; // the rejected messages can be fetched again
     private:
         void DeleteAddr(const Addr&);
         bool IsSingleChannelUser(const Addr::Channel&);
         Addr* CreateOwnAddr(const WalletID&);
+        BbsDecryptor::KeyListPtr get_ChannelKeys(BbsChannel);
+        void OnDecrypted();
 
         // IWalletMessageEndpoint
         void Send(const WalletID& peerID, const SetTxParameter& msg) override;
@@ -86,6 +92,11 @@ namespace beam::wallet
         IWalletDB::Ptr m_WalletDB;
         Key::IKdf::Ptr m_pKdfSbbs;
         io::Timer::Ptr m_AddressExpirationTimer;
+
+        // snapshots of the channel addresses for the decryptor, dropped on the address changes
+        std::map<BbsChannel, BbsDecryptor::KeyListPtr> m_ChannelKeys;
+        BbsDecryptor m_Decryptor;
+        bool m_DecryptorOverloaded = false;
     };
 
     class BbsSender
@@ -134,12 +145,28 @@ namespace beam::wallet
         io::Timer::Ptr m_pTimerBbsTmSave;
         void OnTimerBbsTmSave();
         void SaveBbsTimestamps();
+
+        // the channel is resumed from the earliest message not handled yet, the later ones may be received again
+        struct BbsChannelState
+        {
+            std::multiset<Timestamp> m_InProgress;
+            Timestamp m_Handled = 0; // the latest handled
+            Timestamp m_Held = 0; // the earliest rejected, 0 if none
+            bool m_Suspended = false; // unsubscribed while the decryptor is overloaded
+
+            Timestamp get_ResumeTime() const;
+        };
+
+        std::map<BbsChannel, BbsChannelState> m_BbsChannels;
+        void UpdateBbsTimestamp(BbsChannel, const BbsChannelState&);
     public:
         WalletNetworkViaBbs(IWalletMessageConsumer&, proto::FlyClient::INetwork::Ptr, const IWalletDB::Ptr&);
         virtual ~WalletNetworkViaBbs();
     private:
         void OnChannelAdded(BbsChannel channel) override;
         void OnChannelDeleted(BbsChannel channel) override;
+        void OnMessageHandled(BbsChannel channel, Timestamp timePosted) override;
+        void OnDecryptorVacant() override;
         void OnMessageSent(uint64_t messageID) override;
         // IWalletMessageEndpoint
         void SendRawMessage(const WalletID& peerID, const ByteBuffer& msg) override;
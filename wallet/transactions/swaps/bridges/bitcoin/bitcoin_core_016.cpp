@@ -38,6 +38,9 @@ namespace beam::bitcoin
         };
         const char kInvalidGenesisBlockHashMsg[] = "Invalid genesis block hash";
 
+        // a stalled batch (until the response timeout) doesn't hold the others
+        const size_t kMaxPollBatchesInFlight = 2;
+
         class ScopedHttpRequest
         {
         public:
@@ -57,6 +60,14 @@ namespace beam::bitcoin
             {
                 m_request.connectTimeoutMsec(connectTimeoutMsec);
             }
+            void setKeepAlive(bool keepAlive)
+            {
+                m_request.keepAlive(keepAlive);
+            }
+            void setIdempotent(bool idempotent)
+            {
+                m_request.idempotent(idempotent);
+            }
             void setPathAndQuery(const std::string& pathAndQuery)
             {
                 m_pathAndQuery = pathAndQuery;
@@ -101,11 +112,42 @@ namespace beam::bitcoin
             HttpClient::Request m_request;
         };
 
-        std::pair<json, IBridge::Error> parseHttpResponse(const HttpMsgReader::Message& msg)
-        {
+        std::pair<json, IBridge::Error> parseReply(json& reply)
+        {
             IBridge::Error error{ IBridge::ErrorType::None, "" };
             json result;
 
+            try
+            {
+                if (!reply["error"].empty())
+                {
+                    error.m_type = IBridge::BitcoinError;
+                    error.m_message = reply["error"]["message"].get<std::string>();
+                }
+                else if (reply["result"].empty())
+                {
+                    error.m_type = IBridge::EmptyResult;
+                    error.m_message = "JSON has no \"result\" value";
+                }
+                else
+                {
+                    result = reply["result"];
+                }
+            }
+            catch (const std::exception & ex)
+            {
+                error.m_type = IBridge::InvalidResultFormat;
+                error.m_message = ex.what();
+            }
+            return { result, error };
+        }
+
+        // Returns the whole reply, a single object or an array for the batch
+        std::pair<json, IBridge::Error> parseHttpBody(const HttpMsgReader::Message& msg)
+        {
+            IBridge::Error error{ IBridge::ErrorType::None, "" };
+            json reply;
+
             if (msg.what == HttpMsgReader::http_message)
             {
                 int httpStatus = msg.msg->get_status();
@@ -129,22 +171,7 @@ namespace beam::bitcoin
 
                         try
                         {
-                            json reply = json::parse(strResponse);
-
-                            if (!reply["error"].empty())
-                            {
-                                error.m_type = IBridge::BitcoinError;
-                                error.m_message = reply["error"]["message"].get<std::string>();
-                            }
-                            else if (reply["result"].empty())
-                            {
-                                error.m_type = IBridge::EmptyResult;
-                                error.m_message = "JSON has no \"result\" value";
-                            }
-                            else
-                            {
-                                result = reply["result"];
-                            }
+                            reply = json::parse(strResponse);
                         }
                         catch (const std::exception & ex)
                         {
@@ -163,10 +190,20 @@ namespace beam::bitcoin
             {
                 error.m_type = IBridge::ErrorType::IOError;
                 error.m_message = msg.error_str();
-            }
-            return { result, error };
-        }
-    }
+            }
+            return { reply, error };
+        }
+
+        std::pair<json, IBridge::Error> parseHttpResponse(const HttpMsgReader::Message& msg)
+        {
+            auto [reply, error] = parseHttpBody(msg);
+            if (error.m_type != IBridge::None)
+            {
+                return { json(), error };
+            }
+            return parseReply(reply);
+        }
+    }
 
     BitcoinCore016::BitcoinCore016(io::Reactor& reactor, ISettingsProvider& settingsProvider)
         : m_httpClient(reactor)
@@ -322,7 +359,7 @@ namespace beam::bitcoin
     {
         LOG_DEBUG() << "Send getTxOut command";
 
-        sendRequest("gettxout", "\"" + txid + "\"" + "," + std::to_string(outputIndex), [callback](IBridge::Error error, const json& result) {
+        sendPollRequest("gettxout", "\"" + txid + "\"" + "," + std::to_string(outputIndex), [callback](IBridge::Error error, const json& result) {
             Amount value = 0;
             uint16_t confirmations = 0;
             std::string scriptHex;
@@ -357,7 +394,7 @@ namespace beam::bitcoin
     {
         LOG_DEBUG() << "Send getBlockCount command";
 
-        sendRequest("getblockcount", "", [callback](IBridge::Error error, const json& result) {
+        sendPollRequest("getblockcount", "", [callback](IBridge::Error error, const json& result) {
             uint64_t blockCount = 0;
 
             if (error.m_type == IBridge::EmptyResult)
@@ -385,7 +422,7 @@ namespace beam::bitcoin
     void BitcoinCore016::getBalance(uint32_t confirmations, std::function<void(const Error&, Amount)> callback)
     {
         LOG_DEBUG() << "Send getBalance command";
-        sendRequest("getbalance", "\"*\"," + std::to_string(confirmations), [callback](IBridge::Error error, const json& result) {
+        sendPollRequest("getbalance", "\"*\"," + std::to_string(confirmations), [callback](IBridge::Error error, const json& result) {
             Amount balance = 0;
 
             if (error.m_type == IBridge::None)
@@ -408,7 +445,7 @@ namespace beam::bitcoin
     void BitcoinCore016::getDetailedBalance(std::function<void(const Error&, Amount, Amount, Amount)> callback)
     {
         //LOG_DEBUG() << "Send getWalletInfo command";
-        sendRequest("getwalletinfo", "", [callback](IBridge::Error error, const json& result) {
+        sendPollRequest("getwalletinfo", "", [callback](IBridge::Error error, const json& result) {
             Amount confirmed = 0;
             Amount unconfirmed = 0;
             Amount immature = 0;
@@ -434,7 +471,7 @@ namespace beam::bitcoin
 
     void BitcoinCore016::getGenesisBlockHash(std::function<void(const Error&, const std::string&)> callback)
     {
-        sendRequest("getblockhash", "0", [callback](IBridge::Error error, const json& result)
+        sendPollRequest("getblockhash", "0", [callback](IBridge::Error error, const json& result)
         {
             std::string genesisBlockHash;
 
@@ -456,7 +493,7 @@ namespace beam::bitcoin
 
     void BitcoinCore016::estimateFee(int blockAmount, std::function<void(const Error&, Amount)> callback)
     {
-        sendRequest("estimatesmartfee", std::to_string(blockAmount), [callback](IBridge::Error error, const json& result)
+        sendPollRequest("estimatesmartfee", std::to_string(blockAmount), [callback](IBridge::Error error, const json& result)
         {
             Amount feeRate = 0;
 
@@ -492,6 +529,153 @@ namespace beam::bitcoin
     void BitcoinCore016::sendRequest(const std::string& method, const std::string& params, std::function<void(const Error&, const json&)> callback)
     {
         const std::string content = R"({"method":")" + method + R"(","params":[)" + params + "]}";
+
+        sendHttpRequest(content, [callback](const HttpMsgReader::Message& msg)
+        {
+            const auto [result, error] = parseHttpResponse(msg);
+            callback(error, result);
+        },
+        [callback](const Error& error)
+        {
+            callback(error, json());
+        });
+    }
+
+    void BitcoinCore016::sendPollRequest(const std::string& method, const std::string& params, std::function<void(const Error&, const json&)> callback)
+    {
+        const std::string call = R"("method":")" + method + R"(","params":[)" + params + "]";
+
+        for (auto& batch : m_pollsInFlight)
+        {
+            auto it = batch.find(call);
+            if (it != batch.end())
+            {
+                it->second.push_back(callback);
+                return;
+            }
+        }
+
+        m_pollsQueued[call].push_back(callback);
+        if (m_pollsInFlight.size() < kMaxPollBatchesInFlight)
+        {
+            sendPollBatch();
+        }
+    }
+
+    void BitcoinCore016::sendPollBatch()
+    {
+        if (m_pollsQueued.empty())
+        {
+            return;
+        }
+
+        auto itBatch = m_pollsInFlight.insert(m_pollsInFlight.end(), PollBatch());
+        itBatch->swap(m_pollsQueued);
+
+        // the position in the batch is the id of the call
+        std::vector<std::string> calls;
+        for (const auto& p : *itBatch)
+        {
+            calls.push_back(p.first);
+        }
+
+        std::string content;
+        if (calls.size() == 1)
+        {
+            content = "{" + calls[0] + "}";
+        }
+        else
+        {
+            for (size_t i = 0; i < calls.size(); ++i)
+            {
+                content += (i ? ",{" : "[{") + calls[i] + R"(,"id":)" + std::to_string(i) + "}";
+            }
+            content += "]";
+        }
+
+        LOG_DEBUG() << getCoinName() << ": sending " << calls.size() << " polls";
+
+        // the queued polls go on before the callbacks issue the new ones
+        auto takePolls = [this, itBatch]()
+        {
+            PollBatch polls;
+            polls.swap(*itBatch);
+            m_pollsInFlight.erase(itBatch);
+            sendPollBatch();
+            return polls;
+        };
+
+        sendHttpRequest(content, [calls, takePolls](const HttpMsgReader::Message& msg)
+        {
+            auto polls = takePolls();
+
+            if (calls.size() == 1)
+            {
+                const auto [result, error] = parseHttpResponse(msg);
+                for (const auto& callback : polls[calls[0]])
+                {
+                    callback(error, result);
+                }
+                return;
+            }
+
+            auto [reply, error] = parseHttpBody(msg);
+            if (error.m_type == None && !reply.is_array())
+            {
+                error.m_type = InvalidResultFormat;
+                error.m_message = "JSON-RPC batch response expected";
+            }
+
+            std::vector<json*> replies(calls.size(), nullptr);
+            if (error.m_type == None)
+            {
+                for (auto& r : reply)
+                {
+                    auto id = r.find("id");
+                    if (id != r.end() && id->is_number_unsigned() && id->get<size_t>() < calls.size())
+                    {
+                        replies[id->get<size_t>()] = &r;
+                    }
+                }
+            }
+
+            for (size_t i = 0; i < calls.size(); ++i)
+            {
+                json result;
+                Error callError = error;
+                if (error.m_type == None)
+                {
+                    if (replies[i])
+                    {
+                        std::tie(result, callError) = parseReply(*replies[i]);
+                    }
+                    else
+                    {
+                        callError = { InvalidResultFormat, "No response in the JSON-RPC batch" };
+                    }
+                }
+
+                for (const auto& callback : polls[calls[i]])
+                {
+                    callback(callError, result);
+                }
+            }
+        },
+        [takePolls](const Error& error)
+        {
+            for (const auto& p : takePolls())
+            {
+                for (const auto& callback : p.second)
+                {
+                    callback(error, json());
+                }
+            }
+        },
+        true); // polls are read-only, safe to resend
+    }
+
+    void BitcoinCore016::sendHttpRequest(const std::string& content, std::function<void(const HttpMsgReader::Message&)> onResponse, std::function<void(const Error&)> onError, bool idempotent)
+    {
         auto settings = m_settingsProvider.GetSettings();
         auto connectionSettings = settings.GetConnectionOptions();
         const std::string authorization = connectionSettings.generateAuthorization();
@@ -499,14 +683,15 @@ namespace beam::bitcoin
 
         request->setAddress(connectionSettings.m_address);
         request->setConnectTimeoutMsec(2000);
+        request->setKeepAlive(true);
+        request->setIdempotent(idempotent);
         request->setPathAndQuery("/");
         request->addHeader("Authorization", authorization);
         request->setMethod("POST");
         request->setBody(content);
 
-        request->setCallback([coinName = getCoinName(), callback](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
-            const auto [result, error] = parseHttpResponse(msg);
-            callback(error, result);
+        request->setCallback([onResponse](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
+            onResponse(msg);
             return false;
         });
 
@@ -518,32 +703,32 @@ namespace beam::bitcoin
             if (!iter->second)
             {
                 // error
-                Error error{ InvalidGenesisBlock, kInvalidGenesisBlockHashMsg };
-                json result;
-                callback(error, result);
+                onError(Error{ InvalidGenesisBlock, kInvalidGenesisBlockHashMsg });
                 return;
             }
             // node already verified
-            m_httpClient.send_request(request->request());
+            submitRequest(request->request(), onError);
         }
         else
         {
             // Node have not validated yet
             HttpClient::Request verificationRequest;
             const std::string verificationContent = R"({"method":"getblockhash","params":[0], "id": "verify"})";
-            const HeaderPair headers[] = {
-                {"Authorization", authorization.c_str()}
+            const HeaderPair headers[] = {
+                {"Authorization", authorization.c_str()}
             };
 
             verificationRequest.address(connectionSettings.m_address)
                 .connectTimeoutMsec(2000)
+                .keepAlive(true)
+                .idempotent(true)
                 .pathAndQuery("/")
                 .headers(headers)
                 .numHeaders(1)
                 .method("POST")
                 .body(verificationContent.c_str(), verificationContent.size());
 
-            verificationRequest.callback([coinName = getCoinName(), callback, request, this, settings](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
+            verificationRequest.callback([coinName = getCoinName(), onError, request, this, settings](uint64_t id, const HttpMsgReader::Message& msg) -> bool {
                 auto [result, error] = parseHttpResponse(msg);
 
                 if (error.m_type == None)
@@ -557,7 +742,7 @@ namespace beam::bitcoin
                         if (std::find(genesisBlockHashes.begin(), genesisBlockHashes.end(), genesisBlockHash) != genesisBlockHashes.end())
                         {
                             m_verifiedAddresses.emplace(currentNodeAddress, true);
-                            m_httpClient.send_request(request->request());
+                            submitRequest(request->request(), onError);
                             return false;
                         }
                         else
@@ -574,10 +759,21 @@ namespace beam::bitcoin
                         error.m_message = ex.what();
                     }
                 }
-                callback(error, result);
+                onError(error);
                 return false;
             });
-            m_httpClient.send_request(verificationRequest);
+            if (auto res = m_httpClient.send_request(verificationRequest); !res)
+            {
+                onError(Error{ IOError, io::error_str(res.error()) });
+            }
+        }
+    }
+
+    void BitcoinCore016::submitRequest(const HttpClient::Request& request, std::function<void(const Error&)> onError)
+    {
+        if (auto res = m_httpClient.send_request(request); !res)
+        {
+            onError(Error{ IOError, io::error_str(res.error()) });
         }
     }
 } // namespace beam::bitcoin
\ No newline at end of file
@@ -18,6 +18,8 @@
 #include "http/http_client.h"
 #include "settings_provider.h"
 
+#include <list>
+
 namespace beam::bitcoin
 {
     class BitcoinCore016: public IBridge
@@ -49,9 +51,24 @@ namespace beam::bitcoin
         virtual std::string getCoinName() const;
         virtual std::string getAddressType() const;
 
+        /// Read-only call: the identical calls share the response. Up to 2 batches are in flight, the calls
+        /// issued meanwhile are sent after them in one JSON-RPC batch
+        void sendPollRequest(const std::string& method, const std::string& params, std::function<void(const Error&, const nlohmann::json&)> callback);
+
     private:
+        using PollCallbacks = std::vector<std::function<void(const Error&, const nlohmann::json&)>>;
+
+        void sendPollBatch();
+        void sendHttpRequest(const std::string& content, std::function<void(const HttpMsgReader::Message&)> onResponse, std::function<void(const Error&)> onError, bool idempotent = false);
+        void submitRequest(const HttpClient::Request& request, std::function<void(const Error&)> onError);
+
         HttpClient m_httpClient;
         ISettingsProvider& m_settingsProvider;
         std::map<beam::io::Address, bool> m_verifiedAddresses;
+
+        /// Polls by the call ("method":...,"params":[...]), a batch each
+        using PollBatch = std::map<std::string, PollCallbacks>;
+        std::list<PollBatch> m_pollsInFlight;
+        PollBatch m_pollsQueued;
     };
 } // namespace beam::bitcoin
\ No newline at end of file
@@ -569,8 +569,9 @@ namespace beam::wallet
                     Height lockTime = 0;
                     if (!GetParameter(TxParameterID::AtomicSwapExternalLockTime, lockTime))
                     {
-                        //we doesn't have an answer from other participant
-                        UpdateOnNextTip();
+                        //we doesn't have an answer from other participant, the answer itself wakes us up
+                        Height responseHeight = GetMandatoryParameter<Height>(TxParameterID::PeerResponseHeight);
+                        UpdateOnHeight(responseHeight + 1);
                         break;
                     }
 
@@ -795,7 +796,11 @@ namespace beam::wallet
                 assert(isBeamOwner);
                 if (!IsBeamLockTimeExpired())
                 {
-                    UpdateOnNextTip();
+                    Height refundMinHeight = MaxHeight;
+                    if (GetParameter(TxParameterID::MinHeight, refundMinHeight, SubTxIndex::BEAM_REFUND_TX))
+                        UpdateOnHeight(refundMinHeight + 1);
+                    else
+                        UpdateOnNextTip();
                     break;
                 }
 
@@ -126,6 +126,12 @@ private:
 
     bool onRequest(uint64_t peerId, const HttpMsgReader::Message& msg)
     {
+        if (msg.what != HttpMsgReader::http_message)
+        {
+            m_connections.erase(peerId);
+            return false;
+        }
+
         const char* message = "OK";
         static const HeaderPair headers[] =
         {
@@ -168,6 +174,10 @@ private:
         {
             serialized.push_back(body);
             m_connections[peerId]->write_msg(serialized);
+            if (msg.msg->keep_alive())
+            {
+                return true;
+            }
             m_connections[peerId]->shutdown();
         }
         else
@@ -184,6 +194,19 @@ private:
     std::string generateResponse(const std::string& msg)
     {
         json j = json::parse(msg);
+        if (j.is_array())
+        {
+            // JSON-RPC batch
+            json batch = json::array();
+            for (const auto& call : j)
+            {
+                json reply = json::parse(generateResponse(call.dump()));
+                reply["id"] = call["id"];
+                batch.push_back(reply);
+            }
+            return batch.dump();
+        }
+
         if (j["method"] == "getbalance")
             return getBalance();
         else if (j["method"] == "fundrawtransaction")
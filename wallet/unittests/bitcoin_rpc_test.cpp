@@ -70,6 +70,19 @@ namespace
     private:
         bitcoin::Settings m_settings;
     };
+
+    class BitcoinHttpServerCounting : public BitcoinHttpServer
+    {
+    public:
+        unsigned m_blockCountCalls = 0;
+
+    private:
+        std::string getBlockCount() override
+        {
+            ++m_blockCountCalls;
+            return BitcoinHttpServer::getBlockCount();
+        }
+    };
 }
 
 void testSuccessResponse()
@@ -297,6 +310,63 @@ void testConnectionRefused()
     WALLET_CHECK(counter == 1);
 }
 
+// The identical polls share one call, the ones issued while it is in flight go in one JSON-RPC batch
+void testPollBatch()
+{
+    io::Reactor::Ptr reactor = io::Reactor::create();
+    io::Timer::Ptr timer(io::Timer::create(*reactor));
+    io::Reactor::Scope scope(*reactor);
+    unsigned counter = 0;
+
+    timer->start(TEST_PERIOD, false, [&reactor]() {
+        reactor->stop();
+    });
+
+    BitcoinHttpServerCounting httpServer;
+
+    io::Address addr(io::Address::localhost(), PORT);
+    auto settingsProvider = std::make_shared<BitcoindSettingsProvider>(btcUserName, btcPass, addr);
+    bitcoin::BitcoinCore016 bridge = bitcoin::BitcoinCore016(*reactor, *settingsProvider);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        bridge.getBlockCount([&counter](const bitcoin::IBridge::Error& error, uint64_t blocks)
+        {
+            WALLET_CHECK(error.m_type == bitcoin::IBridge::None);
+            WALLET_CHECK(blocks == 2);
+            ++counter;
+        });
+    }
+
+    bridge.getBalance(2, [&counter](const bitcoin::IBridge::Error& error, Amount balance)
+    {
+        WALLET_CHECK(error.m_type == bitcoin::IBridge::None);
+        WALLET_CHECK(balance > 0);
+        ++counter;
+    });
+
+    bridge.getTxOut("", 2, [&counter](const bitcoin::IBridge::Error& error, const std::string& script, Amount value, uint32_t confirmations)
+    {
+        WALLET_CHECK(error.m_type == bitcoin::IBridge::None);
+        WALLET_CHECK(!script.empty());
+        WALLET_CHECK(confirmations > 0);
+        ++counter;
+    });
+
+    // not a poll, goes separately
+    bridge.sendRawTransaction("", [&counter](const bitcoin::IBridge::Error& error, const std::string& txID)
+    {
+        WALLET_CHECK(error.m_type == bitcoin::IBridge::None);
+        WALLET_CHECK(!txID.empty());
+        ++counter;
+    });
+
+    reactor->run();
+
+    WALLET_CHECK(counter == 6);
+    WALLET_CHECK(httpServer.m_blockCountCalls == 1);
+}
+
 int main()
 {
     int logLevel = LOG_LEVEL_DEBUG;
@@ -310,6 +380,7 @@ int main()
     testEmptyResult();
     testEmptyResponse();
     testConnectionRefused();
+    testPollBatch();
 
     assert(g_failureCount == 0);
     return WALLET_CHECK_RESULT;
@@ -86,6 +86,12 @@ private:
 
     bool onRequest(uint64_t peerId, const HttpMsgReader::Message& msg)
     {
+        if (msg.what != HttpMsgReader::http_message)
+        {
+            m_connections.erase(peerId);
+            return false;
+        }
+
         const char* message = "OK";
         static const HeaderPair headers[] =
         {
@@ -100,6 +106,10 @@ private:
         {
             serialized.push_back(body);
             m_connections[peerId]->write_msg(serialized);
+            if (msg.msg->keep_alive())
+            {
+                return true;
+            }
             m_connections[peerId]->shutdown();
         }
         else
@@ -126,114 +136,134 @@ private:
         std::string result;
         if (sz > 0 && rawReq)
         {
-            std::string req(static_cast<const char*>(rawReq), sz);
-            json j = json::parse(req);
-            if (j["method"] == "fundrawtransaction")
-            {
-                std::string hexTx = j["params"][0];
-                libbitcoin::data_chunk tx_data;
-                libbitcoin::decode_base16(tx_data, hexTx);
-                libbitcoin::chain::transaction tx;
-                tx.from_data_without_inputs(tx_data);
+            result = generateResult(std::string(static_cast<const char*>(rawReq), sz));
+        }
+        else
+        {
+            LOG_ERROR() << "Request is wrong";
+            //g_stopEvent();
+        }
 
-                libbitcoin::chain::input input;
+        io::SharedBuffer body;
 
-                tx.inputs().push_back(input);
+        body.assign(result.data(), result.size());
+        return body;
+    }
 
-                std::string hexNewTx = libbitcoin::encode_base16(tx.to_data());
+    // Handles JSON-RPC batches as well
+    std::string generateResult(const std::string& req)
+    {
+        json j = json::parse(req);
+        std::string result;
 
-                result = R"({"result":{"hex":")" + hexNewTx + R"(", "fee": 0, "changepos": 0},"error":null,"id":null})";
-            }
-            else if (j["method"] == "dumpprivkey")
-            {
-                result = R"({"result":")" + m_options.m_privateKey + R"(","error":null,"id":null})";
-            }
-            else if (j["method"] == "signrawtransactionwithwallet")
+        if (j.is_array())
+        {
+            json batch = json::array();
+            for (const auto& call : j)
             {
-                std::string hexTx = j["params"][0];
-                result = R"({"result": {"hex": ")" + hexTx + R"(", "complete": true},"error":null,"id":null})";
+                json reply = json::parse(generateResult(call.dump()));
+                reply["id"] = call["id"];
+                batch.push_back(reply);
             }
-            else if (j["method"] == "decoderawtransaction")
-            {
-                std::string hexTx = j["params"][0];
+            return batch.dump();
+        }
 
-                libbitcoin::data_chunk tx_data;
-                libbitcoin::decode_base16(tx_data, hexTx);
-                libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
+        if (j["method"] == "fundrawtransaction")
+        {
+            std::string hexTx = j["params"][0];
+            libbitcoin::data_chunk tx_data;
+            libbitcoin::decode_base16(tx_data, hexTx);
+            libbitcoin::chain::transaction tx;
+            tx.from_data_without_inputs(tx_data);
 
-                std::string txId = libbitcoin::encode_hash(tx.hash());
-                result = R"({"result": {"txid": ")" + txId + R"("},"error":null,"id":null})";
-            }
-            else if (j["method"] == "createrawtransaction")
-            {
-                result = R"({"result": ")" + m_options.m_refundTx + R"(","error":null,"id":null})";
-            }
-            else if (j["method"] == "getrawchangeaddress")
-            {
-                result = R"( {"result":")" + m_options.m_rawAddress + R"(","error":null,"id":null})";
-            }
-            else if (j["method"] == "sendrawtransaction")
-            {
-                std::string hexTx = j["params"][0];
+            libbitcoin::chain::input input;
 
-                libbitcoin::data_chunk tx_data;
-                libbitcoin::decode_base16(tx_data, hexTx);
-                libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
+            tx.inputs().push_back(input);
 
-                std::string txId = libbitcoin::encode_hash(tx.hash());
+            std::string hexNewTx = libbitcoin::encode_base16(tx.to_data());
 
-                if (m_transactions.find(txId) == m_transactions.end())
-                {
-                    m_transactions[txId] = make_pair(hexTx, 0);
-                    sendRawTransaction(req);
-                }
+            result = R"({"result":{"hex":")" + hexNewTx + R"(", "fee": 0, "changepos": 0},"error":null,"id":null})";
+        }
+        else if (j["method"] == "dumpprivkey")
+        {
+            result = R"({"result":")" + m_options.m_privateKey + R"(","error":null,"id":null})";
+        }
+        else if (j["method"] == "signrawtransactionwithwallet")
+        {
+            std::string hexTx = j["params"][0];
+            result = R"({"result": {"hex": ")" + hexTx + R"(", "complete": true},"error":null,"id":null})";
+        }
+        else if (j["method"] == "decoderawtransaction")
+        {
+            std::string hexTx = j["params"][0];
 
-                result = R"( {"result":")" + txId + R"(","error":null,"id":null})";
-            }
-            else if (j["method"] == "gettxout")
-            {
-                std::string txId = j["params"][0];
-                std::string lockScript = "";
-                int confirmations = 0;
+            libbitcoin::data_chunk tx_data;
+            libbitcoin::decode_base16(tx_data, hexTx);
+            libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
 
-                auto idx = m_transactions.find(txId);
-                if (idx != m_transactions.end())
-                {
-                    confirmations = ++idx->second.second;
-                    libbitcoin::data_chunk tx_data;
-                    libbitcoin::decode_base16(tx_data, idx->second.first);
-                    libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
+            std::string txId = libbitcoin::encode_hash(tx.hash());
+            result = R"({"result": {"txid": ")" + txId + R"("},"error":null,"id":null})";
+        }
+        else if (j["method"] == "createrawtransaction")
+        {
+            result = R"({"result": ")" + m_options.m_refundTx + R"(","error":null,"id":null})";
+        }
+        else if (j["method"] == "getrawchangeaddress")
+        {
+            result = R"( {"result":")" + m_options.m_rawAddress + R"(","error":null,"id":null})";
+        }
+        else if (j["method"] == "sendrawtransaction")
+        {
+            std::string hexTx = j["params"][0];
 
-                    auto script = tx.outputs()[0].script();
+            libbitcoin::data_chunk tx_data;
+            libbitcoin::decode_base16(tx_data, hexTx);
+            libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
 
-                    lockScript = libbitcoin::encode_base16(script.to_data(false));
-                }
+            std::string txId = libbitcoin::encode_hash(tx.hash());
 
-                result = R"( {"result":{"confirmations":)" + std::to_string(confirmations) + R"(,"value":)" + std::to_string(double(m_options.m_amount) / libbitcoin::satoshi_per_bitcoin) + R"(,"scriptPubKey":{"hex":")" + lockScript + R"("}},"error":null,"id":null})";
-            }
-            else if (j["method"] == "getblockcount")
+            if (m_transactions.find(txId) == m_transactions.end())
             {
-                result = R"( {"result":)" + std::to_string(m_blockCount++) + R"(,"error":null,"id":null})";
+                m_transactions[txId] = make_pair(hexTx, 0);
+                sendRawTransaction(req);
             }
-            else if (j["method"] == "getblockhash")
+
+            result = R"( {"result":")" + txId + R"(","error":null,"id":null})";
+        }
+        else if (j["method"] == "gettxout")
+        {
+            std::string txId = j["params"][0];
+            std::string lockScript = "";
+            int confirmations = 0;
+
+            auto idx = m_transactions.find(txId);
+            if (idx != m_transactions.end())
             {
-#if defined(BEAM_MAINNET) || defined(SWAP_MAINNET)
-                result = R"( {"result":"000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f","error":null,"id":"verify"})";
-#else
-                result = R"( {"result":"0f9188f13cb7b2c71f2a335e3a4fc328bf5beb436012afca590b1a11466e2206","error":null,"id":"verify"})";
-#endif
+                confirmations = ++idx->second.second;
+                libbitcoin::data_chunk tx_data;
+                libbitcoin::decode_base16(tx_data, idx->second.first);
+                libbitcoin::chain::transaction tx = libbitcoin::chain::transaction::factory_from_data(tx_data);
+
+                auto script = tx.outputs()[0].script();
+
+                lockScript = libbitcoin::encode_base16(script.to_data(false));
             }
+
+            result = R"( {"result":{"confirmations":)" + std::to_string(confirmations) + R"(,"value":)" + std::to_string(double(m_options.m_amount) / libbitcoin::satoshi_per_bitcoin) + R"(,"scriptPubKey":{"hex":")" + lockScript + R"("}},"error":null,"id":null})";
         }
-        else
+        else if (j["method"] == "getblockcount")
         {
-            LOG_ERROR() << "Request is wrong";
-            //g_stopEvent();
+            result = R"( {"result":)" + std::to_string(m_blockCount++) + R"(,"error":null,"id":null})";
         }
-
-        io::SharedBuffer body;
-
-        body.assign(result.data(), result.size());
-        return body;
+        else if (j["method"] == "getblockhash")
+        {
+#if defined(BEAM_MAINNET) || defined(SWAP_MAINNET)
+            result = R"( {"result":"000000000019d6689c085ae165831e934ff763ae46a2a6c172b3f1b60a8ce26f","error":null,"id":"verify"})";
+#else
+            result = R"( {"result":"0f9188f13cb7b2c71f2a335e3a4fc328bf5beb436012afca590b1a11466e2206","error":null,"id":"verify"})";
+#endif
+        }
+        return result;
     }
 
     void sendRawTransaction(const string& msg)
@@ -13,11 +13,15 @@
 // limitations under the License.
 
 #include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <core/block_crypt.h>
 
 #include "test_helpers.h"
 
 #include "wallet/api/api.h"
+#include "wallet/api/wallet_router.h"
 #include "utility/logger.h"
 #include "nlohmann/json.hpp"
 
@@ -610,6 +614,7 @@ namespace
 
                 WALLET_CHECK(data.skip == 10);
                 WALLET_CHECK(data.count == 10);
+                WALLET_CHECK(data.after && to_hex(data.after->data(), data.after->size()) == "a36671ceb9d844e2baa44798ee1e915a");
             }
         };
 
@@ -1360,6 +1365,174 @@ void TestAssetsAPI()
     Rules::get().UpdateChecksum();
 }
 
+namespace
+{
+    // Wallets of the router, record the threads they are used on
+    struct RouterLog
+    {
+        std::mutex _mutex;
+        std::map<std::string, std::set<std::thread::id>> _threads;
+        std::map<std::string, std::set<uint64_t>> _closed;
+
+        void onThread(const std::string& name)
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _threads[name].insert(std::this_thread::get_id());
+        }
+    };
+
+    class RoutedWallet : public WalletRouter::IWallet
+    {
+    public:
+        RoutedWallet(WalletRouter& router, RouterLog& log, const std::string& name)
+            : _router(router)
+            , _log(log)
+            , _name(name)
+        {
+            _log.onThread(_name);
+        }
+
+        void onRequest(uint64_t connectionId, const std::string& request) override
+        {
+            _log.onThread(_name);
+
+            json msg = json::parse(request);
+            _router.sendMsg(connectionId, json
+                {
+                    {"jsonrpc", "2.0"},
+                    {"id", msg["id"]},
+                    {"result", _name}
+                });
+        }
+
+        void onConnectionClosed(uint64_t connectionId) override
+        {
+            _log.onThread(_name);
+
+            std::unique_lock<std::mutex> lock(_log._mutex);
+            _log._closed[_name].insert(connectionId);
+        }
+
+    private:
+        WalletRouter& _router;
+        RouterLog& _log;
+        std::string _name;
+    };
+}
+
+void testWalletRouter()
+{
+    cout << "\nWalletRouter test\n";
+
+    io::Reactor::Ptr reactor = io::Reactor::create();
+    io::Reactor::Scope scope(*reactor);
+
+    const auto ownerThread = std::this_thread::get_id();
+    std::vector<std::pair<uint64_t, json>> replies;
+    size_t expected = 0;
+
+    RouterLog log;
+
+    {
+        WalletRouter router(2, [&](uint64_t connectionId, const json& msg)
+            {
+                WALLET_CHECK(std::this_thread::get_id() == ownerThread);
+                replies.emplace_back(connectionId, msg);
+                if (replies.size() == expected)
+                {
+                    reactor->stop();
+                }
+            });
+
+        auto addWallet = [&](const std::string& name)
+        {
+            router.addWallet(name, [&router, &log, name](uint32_t iThread)
+                {
+                    return std::make_unique<RoutedWallet>(router, log, name);
+                });
+        };
+
+        addWallet("a");
+        addWallet("b");
+        router.addWallet("c", [](uint32_t iThread) -> WalletRouter::IWallet::Ptr
+            {
+                throw std::runtime_error("no such wallet");
+            });
+
+        auto route = [&](uint64_t connectionId, const std::string& request)
+        {
+            return router.route(connectionId, request.data(), request.size());
+        };
+
+        // rejected on the owner thread
+        WALLET_CHECK(!route(1, "{\"jsonrpc\":\"2.0\",\"id\":1,"));
+        WALLET_CHECK(!route(1, "[1, 2]"));
+        WALLET_CHECK(route(1, JSON_CODE({"jsonrpc": "2.0", "id": 2, "method": "wallet_status"})));
+        WALLET_CHECK(route(1, JSON_CODE({"jsonrpc": "2.0", "id": 3, "method": "wallet_status", "wallet_id": "x"})));
+        WALLET_CHECK(replies.size() == 4);
+
+        WALLET_CHECK(replies[0].second["error"]["code"] == ApiError::InvalidJsonRpc);
+        WALLET_CHECK(replies[1].second["error"]["code"] == ApiError::InvalidJsonRpc);
+        WALLET_CHECK(replies[2].second["error"]["code"] == ApiError::InvalidParamsJsonRpc);
+        WALLET_CHECK(replies[2].second["id"] == 2);
+        WALLET_CHECK(replies[3].second["error"]["code"] == ApiError::InvalidParamsJsonRpc);
+        WALLET_CHECK(replies[3].second["id"] == 3);
+
+        // routed to the wallet threads
+        WALLET_CHECK(route(1, JSON_CODE({"jsonrpc": "2.0", "id": 4, "method": "wallet_status", "wallet_id": "a"})));
+        WALLET_CHECK(route(1, JSON_CODE({"jsonrpc": "2.0", "id": 5, "method": "wallet_status", "wallet_id": "b"})));
+        WALLET_CHECK(route(2, JSON_CODE({"jsonrpc": "2.0", "id": 6, "method": "wallet_status", "wallet_id": "a"})));
+        WALLET_CHECK(route(2, JSON_CODE({"jsonrpc": "2.0", "id": 7, "method": "wallet_status", "wallet_id": "c"})));
+
+        expected = 8;
+        reactor->run();
+        WALLET_CHECK(replies.size() == expected);
+
+        std::map<int, std::pair<uint64_t, json>> routed;
+        for (size_t i = 4; i < replies.size(); i++)
+        {
+            routed[replies[i].second["id"].get<int>()] = replies[i];
+        }
+
+        WALLET_CHECK(routed.size() == 4);
+        WALLET_CHECK(routed[4].first == 1 && routed[4].second["result"] == "a");
+        WALLET_CHECK(routed[5].first == 1 && routed[5].second["result"] == "b");
+        WALLET_CHECK(routed[6].first == 2 && routed[6].second["result"] == "a");
+        WALLET_CHECK(routed[7].first == 2 && routed[7].second["error"]["code"] == ApiError::NotOpenedError);
+
+        // the closed connection reaches the wallets it used, the tasks of a thread are executed in order
+        router.onConnectionClosed(1);
+        for (uint32_t i = 0; i < router.getThreads(); i++)
+        {
+            router.post(i, [&router]() { router.sendMsg(0, json()); });
+        }
+
+        expected += router.getThreads();
+        reactor->run();
+        WALLET_CHECK(replies.size() == expected);
+
+        {
+            std::unique_lock<std::mutex> lock(log._mutex);
+            WALLET_CHECK(log._closed["a"] == std::set<uint64_t>{ 1 });
+            WALLET_CHECK(log._closed["b"] == std::set<uint64_t>{ 1 });
+        }
+
+        router.closeWallets();
+        WALLET_CHECK(route(2, JSON_CODE({"jsonrpc": "2.0", "id": 8, "method": "wallet_status", "wallet_id": "a"})));
+        WALLET_CHECK(replies.back().second["error"]["code"] == ApiError::InvalidParamsJsonRpc);
+    }
+
+    // each wallet stays on one thread, not the owner one
+    WALLET_CHECK(log._threads.size() == 2);
+    for (const auto& [name, threads] : log._threads)
+    {
+        WALLET_CHECK(threads.size() == 1);
+        WALLET_CHECK(!threads.count(ownerThread));
+    }
+
+    WALLET_CHECK(*log._threads["a"].begin() != *log._threads["b"].begin());
+}
+
 int main()
 {
     auto logger = beam::Logger::create();
@@ -1594,7 +1767,8 @@ int main()
         "params" :
         {
             "skip" : 10,
-            "count" : 10
+            "count" : 10,
+            "after" : "a36671ceb9d844e2baa44798ee1e915a"
         }
     }));
 
@@ -1752,5 +1926,7 @@ int main()
 
     TestAssetsAPI();
 
+    testWalletRouter();
+
     return WALLET_CHECK_RESULT;
 }
@@ -364,6 +364,126 @@ void TestStoreTxRecord()
     WALLET_CHECK(t.size() == 0);
 }
 
+void TestTxHistoryPage()
+{
+    cout << "\nWallet database paged tx history test\n";
+    auto walletDB = createSqliteWalletDB();
+
+    TxDescription tr(TxID{});
+    tr.m_amount = 34;
+    tr.m_myId.m_Pk = unsigned(42);
+    tr.m_createTime = 123456;
+    tr.m_sender = true;
+
+    for (uint8_t i = 0; i < 100; ++i)
+    {
+        tr.m_txId[0] = i;
+        tr.m_minHeight = 1000 + i / 2; // two txs per height
+        tr.m_status = (i % 3) ? TxStatus::Completed : TxStatus::Failed;
+        tr.m_assetId = (i % 10) ? Asset::s_InvalidID : 1;
+        WALLET_CHECK_NO_THROW(walletDB->saveTx(tr));
+    }
+
+    TxHistoryFilter filter;
+    auto t = walletDB->getTxHistoryPage(filter, boost::none);
+    WALLET_CHECK(t.size() == 100);
+    WALLET_CHECK(t[0].m_txId[0] == 99 && t[1].m_txId[0] == 98 && t[99].m_txId[0] == 0);
+
+    // walk the pages while new txs arrive at the top
+    std::vector<TxDescription> all;
+    boost::optional<TxID> after;
+    tr.m_status = TxStatus::Completed;
+    tr.m_assetId = Asset::s_InvalidID;
+    for (uint8_t i = 100; ; ++i)
+    {
+        t = walletDB->getTxHistoryPage(filter, after, 0, 7);
+        if (t.empty())
+            break;
+
+        all.insert(all.end(), t.begin(), t.end());
+        after = t.back().m_txId;
+
+        tr.m_txId[0] = i;
+        tr.m_minHeight = 2000 + i;
+        WALLET_CHECK_NO_THROW(walletDB->saveTx(tr));
+    }
+    WALLET_CHECK(all.size() == 100);
+    for (size_t i = 0; i < all.size(); ++i)
+    {
+        WALLET_CHECK(all[i].m_txId[0] == 99 - i);
+    }
+
+    t = walletDB->getTxHistoryPage(filter, all[49].m_txId, 10, 5);
+    WALLET_CHECK(t.size() == 5 && t[0].m_txId[0] == 39);
+
+    filter.m_status = TxStatus::Failed;
+    t = walletDB->getTxHistoryPage(filter, boost::none);
+    WALLET_CHECK(t.size() == 34);
+
+    filter.m_assetId = 1;
+    t = walletDB->getTxHistoryPage(filter, boost::none);
+    WALLET_CHECK(t.size() == 4); // 0, 30, 60, 90
+
+    // status change moves the tx between the filters
+    storage::setTxParameter(*walletDB, t[0].m_txId, TxParameterID::Status, TxStatus::Completed, false);
+    t = walletDB->getTxHistoryPage(filter, boost::none);
+    WALLET_CHECK(t.size() == 3);
+
+    filter.m_status.reset();
+    filter.m_assetId.reset();
+    filter.m_proofHeight = 500;
+    WALLET_CHECK(walletDB->getTxHistoryPage(filter, boost::none).empty());
+    tr.m_txId[0] = 5;
+    storage::setTxParameter(*walletDB, tr.m_txId, TxParameterID::KernelProofHeight, Height(500), false);
+    t = walletDB->getTxHistoryPage(filter, boost::none);
+    WALLET_CHECK(t.size() == 1 && t[0].m_txId == tr.m_txId);
+
+    filter.m_proofHeight.reset();
+    filter.m_txTypes = { TxType::AssetIssue };
+    WALLET_CHECK(walletDB->getTxHistoryPage(filter, boost::none).empty());
+
+    filter.m_txTypes.clear();
+    walletDB->deleteTx(tr.m_txId);
+    WALLET_CHECK(walletDB->getTxHistoryPage(filter, boost::none).size() == walletDB->getTxHistory().size());
+    WALLET_CHECK(walletDB->getTxHistoryPage(filter, tr.m_txId).empty());
+}
+
+void TestCoinsPage()
+{
+    cout << "\nWallet database paged coins test\n";
+    auto walletDB = createSqliteWalletDB();
+
+    for (int i = 0; i < 20; ++i)
+    {
+        Coin coin = CreateAvailCoin(i + 1);
+        coin.m_ID.m_AssetID = (i % 4) ? Asset::s_InvalidID : 2;
+        walletDB->storeCoin(coin);
+    }
+
+    auto coins = walletDB->getCoinsPage(boost::none, boost::none);
+    WALLET_CHECK(coins.size() == 20);
+
+    std::vector<Coin> all;
+    boost::optional<Coin::ID> after;
+    while (true)
+    {
+        auto page = walletDB->getCoinsPage(boost::none, after, 0, 3);
+        if (page.empty())
+            break;
+
+        all.insert(all.end(), page.begin(), page.end());
+        after = page.back().m_ID;
+    }
+    WALLET_CHECK(all.size() == coins.size());
+    WALLET_CHECK(equal(all.begin(), all.end(), coins.begin()));
+
+    WALLET_CHECK(walletDB->getCoinsPage(Asset::ID(2), boost::none).size() == 5);
+    WALLET_CHECK(walletDB->getCoinsPage(Asset::s_InvalidID, boost::none).size() == 15);
+
+    auto page = walletDB->getCoinsPage(Asset::s_InvalidID, coins[1].m_ID, 1, 100);
+    WALLET_CHECK(page.size() == 13 && page[0].m_ID.m_Value == coins[3].m_ID.m_Value);
+}
+
 void TestUTXORollback()
 {
     cout << "\nWallet database rollback test\n";
@@ -1082,6 +1202,68 @@ void TestTxParameters()
     WALLET_CHECK(p == pt2);
 }
 
+void TestTxParametersWriteBehind()
+{
+    cout << "\nWallet database transaction parameters write-behind test\n";
+    TxID txID = { {2, 4, 6} };
+    {
+        auto db = createSqliteWalletDB();
+        WALLET_CHECK(storage::setTxParameter(*db, txID, TxParameterID::Amount, Amount(8765), false));
+        WALLET_CHECK(storage::setTxParameter(*db, txID, TxParameterID::Status, TxStatus::InProgress, false));
+
+        // not flushed yet, but visible to the queries
+        auto params = db->getAllTxParameters();
+        WALLET_CHECK(params.size() == 2);
+
+        WALLET_CHECK(storage::setTxParameter(*db, txID, TxParameterID::Status, TxStatus::Completed, false));
+        // written on close
+    }
+    {
+        auto db = WalletDB::open("wallet.db", string("pass123"));
+        Amount amount = 0;
+        WALLET_CHECK(storage::getTxParameter(*db, txID, TxParameterID::Amount, amount));
+        WALLET_CHECK(amount == 8765);
+
+        TxStatus status = TxStatus::Pending;
+        WALLET_CHECK(storage::getTxParameter(*db, txID, TxParameterID::Status, status));
+        WALLET_CHECK(status == TxStatus::Completed);
+        WALLET_CHECK(!storage::getTxParameter(*db, txID, TxParameterID::Fee, amount));
+    }
+}
+
+void TestTxParametersEviction()
+{
+    cout << "\nWallet database transaction parameters cache eviction test\n";
+    TxID txDone = { {3, 5, 7} };
+    TxID txActive = { {4, 6, 8} };
+
+    auto db = createSqliteWalletDB();
+    WALLET_CHECK(storage::setTxParameter(*db, txDone, TxParameterID::Amount, Amount(11), false));
+    WALLET_CHECK(storage::setTxParameter(*db, txDone, TxParameterID::Status, TxStatus::Completed, false));
+    WALLET_CHECK(storage::setTxParameter(*db, txActive, TxParameterID::Amount, Amount(12), false));
+    WALLET_CHECK(storage::setTxParameter(*db, txActive, TxParameterID::Status, TxStatus::InProgress, false));
+
+    // let the write-behind flush happen
+    io::Timer::Ptr timer = io::Timer::create(io::Reactor::get_Current());
+    timer->start(200, false, []() { io::Reactor::get_Current().stop(); });
+    io::Reactor::get_Current().run();
+
+    // modify both txs behind the back of the cache
+    {
+        auto db2 = WalletDB::open("wallet.db", string("pass123"));
+        WALLET_CHECK(storage::setTxParameter(*db2, txDone, TxParameterID::Message, ByteBuffer(1, 'd'), false));
+        WALLET_CHECK(storage::setTxParameter(*db2, txActive, TxParameterID::Message, ByteBuffer(1, 'a'), false));
+    }
+
+    // the finished tx was evicted on flush, hence read again. The active one is still served from the cache
+    ByteBuffer msg;
+    WALLET_CHECK(storage::getTxParameter(*db, txDone, TxParameterID::Message, msg) && (msg == ByteBuffer(1, 'd')));
+    WALLET_CHECK(!storage::getTxParameter(*db, txActive, TxParameterID::Message, msg));
+
+    Amount amount = 0;
+    WALLET_CHECK(storage::getTxParameter(*db, txDone, TxParameterID::Amount, amount) && (amount == 11));
+}
+
 void TestSelect3()
 {
     cout << "\nWallet database coin selection 3 test\n";
@@ -1498,6 +1680,8 @@ int main()
     TestWalletDataBase();
     TestStoreCoins();
     TestStoreTxRecord();
+    TestTxHistoryPage();
+    TestCoinsPage();
     TestTxRollback();
     TestUTXORollback();
     TestSelect();
@@ -1510,6 +1694,8 @@ int main()
     TestAddresses();
     TestExportImportTx();
     TestTxParameters();
+    TestTxParametersWriteBehind();
+    TestTxParametersEviction();
     TestWalletMessages();
     TestNotifications();
     TestExchangeRates();
@@ -19,6 +19,7 @@
 #include "wallet/core/common.h"
 #include "wallet/core/wallet_network.h"
 #include "wallet/core/wallet.h"
+#include "wallet/core/base_tx_builder.h"
 #include "wallet/core/secstring.h"
 #include "wallet/core/base58.h"
 #include "wallet/client/wallet_client.h"
@@ -638,6 +639,246 @@ namespace
         }
     }
 
+    void TestBbsDecryptor()
+    {
+        cout << "\nTesting bbs decryptor...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        constexpr size_t AddressNum = 10;
+        constexpr size_t MessageNum = 40;
+
+        ECC::Key::IKdf::Ptr kdf;
+        ECC::HKdf::Create(kdf, unsigned(123));
+
+        auto pKeys = std::make_shared<BbsDecryptor::KeyList>();
+        for (size_t i = 0; i < AddressNum; ++i)
+        {
+            ECC::Hash::Value v;
+            ECC::Hash::Processor() << i >> v;
+            BbsDecryptor::Key& k = pKeys->emplace_back();
+            kdf->DeriveKey(k.m_sk, v);
+            k.m_Wid = Zero;
+            k.m_Wid.m_Pk.FromSk(k.m_sk);
+        }
+
+        ECC::Scalar::Native skOther;
+        {
+            ECC::Hash::Value v;
+            ECC::Hash::Processor() << unsigned(2) << unsigned(63) >> v;
+            kdf->DeriveKey(skOther, v);
+        }
+        PeerID pkOther;
+        pkOther.FromSk(skOther);
+
+        auto createTask = [&](uint32_t i, const PeerID& pk)
+        {
+            SetTxParameter msg;
+            msg.AddParameter(TxParameterID::MyAddressID, i);
+            Serializer ser;
+            ser & msg;
+
+            ECC::NoLeak<ECC::Hash::Value> hvRandom;
+            ECC::GenRandom(hvRandom.V);
+
+            ECC::Scalar::Native nonce;
+            kdf->DeriveKey(nonce, hvRandom.V);
+
+            auto pTask = std::make_shared<BbsDecryptor::Task>();
+            pTask->m_pKeys = pKeys;
+            WALLET_CHECK(proto::Bbs::Encrypt(pTask->m_Msg, pk, nonce, ser.buffer().first, static_cast<uint32_t>(ser.buffer().second)));
+            return pTask;
+        };
+
+        BbsDecryptor decryptor;
+        std::vector<uint32_t> received;
+        size_t nProcessed = 0;
+        size_t nExpected = MessageNum;
+        decryptor.Start([&]()
+        {
+            for (BbsDecryptor::Task::Ptr pTask; (pTask = decryptor.Pop()); )
+            {
+                nProcessed++;
+                if (!pTask->m_Valid)
+                    continue;
+
+                uint32_t n = 0;
+                WALLET_CHECK(pTask->m_Parameters.GetParameter(TxParameterID::MyAddressID, n));
+                WALLET_CHECK(pTask->m_Wid == (*pKeys)[n % AddressNum].m_Wid);
+                received.push_back(n);
+            }
+
+            if (nProcessed == nExpected)
+                mainReactor->stop();
+        });
+
+        for (uint32_t i = 0; i < MessageNum; ++i)
+        {
+            // odd messages are ours, the last one completes the queue
+            const PeerID& pk = (i & 1) ? (*pKeys)[i % AddressNum].m_Wid.m_Pk : pkOther;
+            WALLET_CHECK(decryptor.Push(createTask(i, pk)));
+        }
+
+        io::Timer::Ptr timer = io::Timer::create(*mainReactor);
+        timer->start(10000, false, [&]() { mainReactor->stop(); });
+
+        mainReactor->run();
+
+        // all are returned, only ours are valid, in the arrival order
+        WALLET_CHECK(nProcessed == MessageNum);
+        WALLET_CHECK(received.size() == MessageNum / 2);
+        for (uint32_t i = 0; i < received.size(); ++i)
+            WALLET_CHECK(received[i] == i * 2 + 1);
+
+        // the processed messages are not taken while the reactor is not running, the newer are rejected beyond the limit
+        received.clear();
+        nProcessed = 0;
+        nExpected = BbsDecryptor::s_MaxInProgress;
+
+        uint32_t nAccepted = 0;
+        for (uint32_t i = 0; i < BbsDecryptor::s_MaxInProgress * 2; ++i)
+            if (decryptor.Push(createTask(i, (*pKeys)[i % AddressNum].m_Wid.m_Pk)))
+                nAccepted++;
+
+        WALLET_CHECK(nAccepted == BbsDecryptor::s_MaxInProgress);
+        WALLET_CHECK(decryptor.get_Rejected() == BbsDecryptor::s_MaxInProgress);
+        WALLET_CHECK(decryptor.get_InProgress() == BbsDecryptor::s_MaxInProgress);
+
+        timer->start(30000, false, [&]() { mainReactor->stop(); });
+        mainReactor->run();
+
+        WALLET_CHECK(received.size() == BbsDecryptor::s_MaxInProgress);
+        for (uint32_t i = 0; i < received.size(); ++i)
+            WALLET_CHECK(received[i] == i);
+        WALLET_CHECK(!decryptor.get_InProgress());
+
+        // stopped with the tasks in progress, they complete on the pool and are discarded
+        for (uint32_t i = 0; i < MessageNum; ++i)
+            decryptor.Push(createTask(i, (*pKeys)[i % AddressNum].m_Wid.m_Pk));
+
+        decryptor.Stop();
+        WALLET_CHECK(!decryptor.Pop());
+    }
+
+    void TestBbsTimestamps()
+    {
+        cout << "\nTesting bbs timestamps...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        struct MyNetwork
+            :public proto::FlyClient::INetwork
+        {
+            std::map<BbsChannel, std::pair<proto::FlyClient::IBbsReceiver*, Timestamp> > m_Subs;
+            uint32_t m_Unsubscribed = 0;
+
+            void Connect() override {}
+            void Disconnect() override {}
+            void PostRequestInternal(proto::FlyClient::Request&) override {}
+
+            void BbsSubscribe(BbsChannel ch, Timestamp ts, proto::FlyClient::IBbsReceiver* p) override
+            {
+                if (p)
+                    m_Subs[ch] = std::make_pair(p, ts);
+                else
+                {
+                    m_Subs.erase(ch);
+                    m_Unsubscribed++;
+                }
+            }
+        };
+
+        struct MyConsumer
+            :public IWalletMessageConsumer
+        {
+            uint32_t m_Received = 0;
+            uint32_t m_Expected = 0;
+
+            void OnWalletMessage(const WalletID&, const SetTxParameter&) override
+            {
+                if (++m_Received == m_Expected)
+                    io::Reactor::get_Current().stop();
+            }
+        };
+
+        auto db = createSqliteWalletDB(SenderWalletDB, false, false);
+        WalletAddress wa;
+        db->createAddress(wa);
+        db->saveAddress(wa);
+        BbsChannel ch = wa.m_walletID.get_Channel();
+
+        auto pNet = std::make_shared<MyNetwork>();
+        MyConsumer consumer;
+        WalletNetworkViaBbs endpoint(consumer, pNet, db);
+        WALLET_CHECK(pNet->m_Subs.find(ch) != pNet->m_Subs.end());
+        proto::FlyClient::IBbsReceiver* pReceiver = pNet->m_Subs[ch].first;
+
+        ECC::Key::IKdf::Ptr kdf;
+        ECC::HKdf::Create(kdf, unsigned(321));
+
+        auto deliver = [&](Timestamp ts)
+        {
+            SetTxParameter msg;
+            msg.m_TxID = wallet::GenerateTxID();
+            Serializer ser;
+            ser & msg;
+
+            ECC::NoLeak<ECC::Hash::Value> hvRandom;
+            ECC::GenRandom(hvRandom.V);
+
+            ECC::Scalar::Native nonce;
+            kdf->DeriveKey(nonce, hvRandom.V);
+
+            proto::BbsMsg bbs;
+            bbs.m_Channel = ch;
+            bbs.m_TimePosted = ts;
+            WALLET_CHECK(proto::Bbs::Encrypt(bbs.m_Message, wa.m_walletID.m_Pk, nonce, ser.buffer().first, static_cast<uint32_t>(ser.buffer().second)));
+            pReceiver->OnMsg(std::move(bbs));
+        };
+
+        auto run = [&](uint32_t nExpected)
+        {
+            consumer.m_Expected = nExpected;
+            io::Timer::Ptr timer = io::Timer::create(*mainReactor);
+            timer->start(30000, false, [&]() { mainReactor->stop(); });
+            mainReactor->run();
+            WALLET_CHECK(consumer.m_Received == nExpected);
+        };
+
+        // the network resumes from the earliest message in progress, not the last received
+        deliver(100);
+        deliver(101);
+        deliver(102);
+        WALLET_CHECK(pNet->m_Subs[ch].second < 100);
+
+        run(3);
+        WALLET_CHECK(pNet->m_Subs[ch].second == 102);
+
+        // overloaded: the channel is suspended from the first rejected message, and resumed once there's room
+        const Timestamp t0 = 200;
+        const uint32_t nAccepted = BbsDecryptor::s_MaxInProgress;
+        for (uint32_t i = 0; i < nAccepted + 10; i++)
+            if (pNet->m_Subs.end() != pNet->m_Subs.find(ch))
+                deliver(t0 + i);
+
+        WALLET_CHECK(pNet->m_Subs.end() == pNet->m_Subs.find(ch));
+        WALLET_CHECK(1 == pNet->m_Unsubscribed);
+
+        run(3 + nAccepted);
+        WALLET_CHECK(pNet->m_Subs.end() != pNet->m_Subs.find(ch));
+        WALLET_CHECK(pNet->m_Subs[ch].second < t0 + nAccepted); // not beyond the rejected
+
+        // fetched again
+        for (uint32_t i = nAccepted; i < nAccepted + 10; i++)
+            deliver(t0 + i);
+
+        run(3 + nAccepted + 10);
+        WALLET_CHECK(pNet->m_Subs[ch].second == t0 + nAccepted + 9);
+        WALLET_CHECK(1 == pNet->m_Unsubscribed);
+    }
+
     void TestSplitTransaction()
     {
         cout << "\nTesting split Tx...\n";
@@ -982,6 +1223,465 @@ namespace
 
     }
 
+    void TestAsyncJobs()
+    {
+        cout << "\nTesting wallet async jobs...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        const std::thread::id idMain = std::this_thread::get_id();
+        const uint32_t nJobs = 20;
+
+        std::atomic<uint32_t> nExecuted(0);
+        std::atomic<bool> bThreadsValid(true);
+        uint32_t nDone = 0;
+        bool bDroppedCalled = false;
+        std::atomic<bool> bStarted(false);
+
+        {
+            Wallet w(createSenderWalletDB(), true);
+            INegotiatorGateway& gateway = w;
+
+            // jobs on the worker threads, completions on the wallet thread
+            for (uint32_t i = 0; i < nJobs; i++)
+            {
+                WALLET_CHECK(gateway.DoAsync(
+                    [&]()
+                    {
+                        if (std::this_thread::get_id() == idMain)
+                            bThreadsValid = false;
+                        nExecuted++;
+                    },
+                    [&]()
+                    {
+                        if (std::this_thread::get_id() != idMain)
+                            bThreadsValid = false;
+                        if (++nDone == nJobs)
+                            mainReactor->stop();
+                    }));
+            }
+
+            io::Timer::Ptr timer = io::Timer::create(*mainReactor);
+            timer->start(10000, false, [&]() { mainReactor->stop(); });
+            mainReactor->run();
+
+            WALLET_CHECK(nExecuted == nJobs);
+            WALLET_CHECK(nDone == nJobs);
+            WALLET_CHECK(bThreadsValid);
+
+            // the wallet is destroyed while the job is in progress, its completion is dropped
+            WALLET_CHECK(gateway.DoAsync(
+                [&]()
+                {
+                    bStarted = true;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                },
+                [&]() { bDroppedCalled = true; }));
+
+            while (!bStarted)
+                std::this_thread::yield();
+        }
+
+        io::Timer::Ptr timer = io::Timer::create(*mainReactor);
+        timer->start(100, false, [&]() { mainReactor->stop(); });
+        mainReactor->run();
+
+        WALLET_CHECK(!bDroppedCalled);
+    }
+
+    void TestAsyncTxVerification()
+    {
+        cout << "\nTesting async tx verification...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        // keeps the jobs, runs them on demand
+        struct MyGateway
+            :public EmptyTestGateway
+        {
+            bool m_Async = true;
+            std::vector<std::pair<std::function<void()>, std::function<void()> > > m_vJobs;
+
+            bool DoAsync(std::function<void()>&& job, std::function<void()>&& done) override
+            {
+                if (!m_Async)
+                    return false;
+                m_vJobs.emplace_back(std::move(job), std::move(done));
+                return true;
+            }
+
+            void RunJobs()
+            {
+                auto vJobs = std::move(m_vJobs);
+                for (auto& x : vJobs)
+                {
+                    std::thread(x.first).join();
+                    x.second();
+                }
+            }
+        } gateway;
+
+        struct MyBuilder
+            :public BaseTxBuilder
+        {
+            Transaction::Ptr m_pTx;
+
+            MyBuilder(BaseTransaction& tx, const Transaction::Ptr& pTx)
+                :BaseTxBuilder(tx, kDefaultSubTxID, { 1 }, 1)
+                , m_pTx(pTx)
+            {
+            }
+
+            Transaction::Ptr CreateTransaction() override { return m_pTx; }
+        };
+
+        auto createTx = [](bool bValid)
+        {
+            ECC::Scalar::Native sk;
+            sk.GenRandomNnz();
+
+            auto pKrn = std::make_unique<TxKernelStd>();
+            pKrn->Sign(sk);
+
+            auto pTx = std::make_shared<Transaction>();
+            pTx->m_vKernels.push_back(std::move(pKrn));
+
+            if (bValid)
+                sk = -sk; // balances the kernel excess
+            pTx->m_Offset = sk;
+            pTx->Normalize();
+            return pTx;
+        };
+
+        TestWalletRig sender(createSenderWalletDB());
+        SimpleTransaction::Creator simpleCreator(sender.m_WalletDB, true);
+        BaseTransaction::Creator& creator = simpleCreator;
+        auto tx = creator.Create(BaseTransaction::TxContext(gateway, sender.m_WalletDB, wallet::GenerateTxID()));
+        BaseTransaction& btx = static_cast<BaseTransaction&>(*tx);
+
+        for (bool bValid : { true, false })
+        {
+            // inline, if the gateway doesn't support async jobs
+            gateway.m_Async = false;
+            auto pBld = std::make_shared<MyBuilder>(btx, createTx(bValid));
+            WALLET_CHECK(!pBld->CreateAndVerifyTransaction());
+            WALLET_CHECK(bValid == static_cast<bool>(pBld->GetVerifiedTransaction()));
+
+            // async
+            gateway.m_Async = true;
+            pBld = std::make_shared<MyBuilder>(btx, createTx(bValid));
+            WALLET_CHECK(pBld->CreateAndVerifyTransaction());
+            WALLET_CHECK(pBld->CreateAndVerifyTransaction()); // still in progress, not started again
+            WALLET_CHECK(gateway.m_vJobs.size() == 1);
+            WALLET_CHECK(!pBld->GetVerifiedTransaction());
+
+            gateway.RunJobs();
+            WALLET_CHECK(!pBld->CreateAndVerifyTransaction()); // done
+            WALLET_CHECK(gateway.m_vJobs.empty());
+            WALLET_CHECK(bValid == static_cast<bool>(pBld->GetVerifiedTransaction()));
+        }
+
+        // the builder is destroyed while the verification is in progress, the completion is ignored
+        {
+            auto pBld = std::make_shared<MyBuilder>(btx, createTx(true));
+            WALLET_CHECK(pBld->CreateAndVerifyTransaction());
+
+            std::weak_ptr<MyBuilder> pWeak = pBld;
+            pBld.reset();
+            WALLET_CHECK(pWeak.expired());
+
+            gateway.RunJobs();
+        }
+    }
+
+    void TestEventsSync()
+    {
+        cout << "\nTesting events sync...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        auto db = createSqliteWalletDB("events_wallet.db", false, true);
+
+        TestBlockchain bc;
+        while (bc.m_mcm.m_vStates.size() < 20)
+            bc.AddBlock();
+        for (const auto& s : bc.m_mcm.m_vStates)
+            db->get_History().AddStates(&s.m_Hdr, 1);
+
+        Block::SystemState::Full sTip;
+        db->get_History().get_Tip(sTip);
+
+        struct MyNetwork
+            :public proto::FlyClient::INetwork
+        {
+            IWalletDB::Ptr m_pDb;
+            CoinID m_Cid; // own coin of the 1st page
+            std::deque<proto::FlyClient::Request::Ptr> m_Reqs;
+            std::vector<bool> m_CoinKnownAtRequest;
+
+            void Connect() override {}
+            void Disconnect() override {}
+
+            void PostRequestInternal(proto::FlyClient::Request& r) override
+            {
+                if (proto::FlyClient::Request::Type::Events != r.get_Type())
+                    return;
+
+                Coin c;
+                c.m_ID = m_Cid;
+                m_CoinKnownAtRequest.push_back(m_pDb->findCoin(c));
+                m_Reqs.push_back(&r);
+            }
+        };
+
+        struct MyObserver
+            :public IWalletObserver
+        {
+            std::vector<std::pair<Height, Height> > m_vProgress;
+
+            void onSyncProgress(int, int) override {}
+            void onOwnedNode(const PeerID&, bool) override {}
+            void onEventsSyncProgress(Height done, Height total, uint32_t) override
+            {
+                m_vProgress.emplace_back(done, total);
+            }
+        } obs;
+
+        Serializer ser;
+        auto addUtxo = [&](Height h, const CoinID& cid, const CoinID& cidComm)
+        {
+            proto::Event::Utxo evt;
+            evt.m_Flags = proto::Event::Flags::Add;
+            evt.m_Cid = cid;
+            evt.m_Maturity = h;
+
+            Point::Native comm;
+            WALLET_CHECK(IPrivateKeyKeeper2::Status::Success == db->get_KeyKeeper()->get_Commitment(comm, cidComm));
+            evt.m_Commitment = comm;
+
+            ser & h;
+            ser & proto::Event::Utxo::s_Type;
+            ser & evt;
+        };
+
+        auto complete = [&](proto::FlyClient::Request& r)
+        {
+            proto::FlyClient::RequestEvents& re = static_cast<proto::FlyClient::RequestEvents&>(r);
+            ser.swap_buf(re.m_Res.m_Events);
+            ser.reset();
+            r.m_pTrg->OnComplete(r);
+        };
+
+        const CoinID cidOwn(100, 1001, Key::Type::Regular);
+        const CoinID cidChild(300, 1003, Key::Type::Regular, 5);
+        const CoinID cidForeign(200, 1002, Key::Type::Regular);
+        const CoinID cidChildForeign(400, 1004, Key::Type::Regular, 6);
+
+        auto pNet = std::make_shared<MyNetwork>();
+        pNet->m_pDb = db;
+        pNet->m_Cid = cidOwn;
+
+        {
+            Wallet w(db, true);
+            w.SetNodeEndpoint(pNet);
+            w.Subscribe(&obs);
+
+            proto::FlyClient& fc = w;
+            fc.OnOwnedNode(Zero, true);
+
+            WALLET_CHECK(pNet->m_Reqs.size() == 1);
+            proto::FlyClient::Request::Ptr pReq = pNet->m_Reqs.front();
+            pNet->m_Reqs.pop_front();
+
+            // full page: own coin, own child kdf coin (checked through the key keeper), and false positives for both
+            addUtxo(5, cidOwn, cidOwn);
+            addUtxo(6, cidChild, cidChild);
+            addUtxo(7, cidForeign, cidOwn);
+            addUtxo(8, cidChildForeign, cidChild);
+            static_cast<proto::FlyClient::RequestEvents&>(*pReq).m_Max = 4;
+            complete(*pReq);
+
+            // the next page was requested before this one was recognized
+            WALLET_CHECK(pNet->m_Reqs.size() == 1);
+            WALLET_CHECK(pNet->m_CoinKnownAtRequest.size() == 2);
+            WALLET_CHECK(!pNet->m_CoinKnownAtRequest[1]);
+            pReq = pNet->m_Reqs.front();
+            pNet->m_Reqs.pop_front();
+            WALLET_CHECK(static_cast<proto::FlyClient::RequestEvents&>(*pReq).m_Msg.m_HeightMin == 9);
+
+            WALLET_CHECK(obs.m_vProgress.size() == 1);
+            WALLET_CHECK(obs.m_vProgress[0] == std::make_pair(Height(8), sTip.m_Height));
+
+            // the last page, large enough to be recognized on the worker threads
+            const uint32_t nLast = 100;
+            for (uint32_t i = 0; i < nLast; i++)
+            {
+                CoinID cid(10 + i, 2000 + i, Key::Type::Regular);
+                addUtxo(12, cid, (i % 3) ? cid : cidOwn);
+            }
+            complete(*pReq);
+
+            WALLET_CHECK(pNet->m_Reqs.empty()); // synced
+            WALLET_CHECK(obs.m_vProgress.size() == 2);
+            WALLET_CHECK(obs.m_vProgress[1] == std::make_pair(sTip.m_Height, sTip.m_Height));
+
+            for (uint32_t i = 0; i < nLast; i++)
+            {
+                Coin c;
+                c.m_ID = CoinID(10 + i, 2000 + i, Key::Type::Regular);
+                WALLET_CHECK(db->findCoin(c) == !!(i % 3));
+            }
+
+            w.Unsubscribe(&obs);
+        }
+
+        Coin c;
+        c.m_ID = cidOwn;
+        WALLET_CHECK(db->findCoin(c));
+        WALLET_CHECK(c.m_confirmHeight == 5);
+        c.m_ID = cidChild;
+        WALLET_CHECK(db->findCoin(c));
+        c.m_ID = cidForeign;
+        WALLET_CHECK(!db->findCoin(c));
+        c.m_ID = cidChildForeign;
+        WALLET_CHECK(!db->findCoin(c));
+    }
+
+    void TestHeightWakeUp()
+    {
+        cout << "\nTesting transactions wake-up by height...\n";
+
+        io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+        io::Reactor::Scope scope(*mainReactor);
+
+        auto db = createSenderWalletDB();
+
+        // waits for the specified height, optionally for the next tip as well
+        struct MyTx
+            :public BaseTransaction
+        {
+            Height m_hWait = 0;
+            bool m_NextTip = false;
+            bool m_Complete = false;
+            uint32_t m_Updates = 0;
+
+            MyTx(const TxContext& ctx) :BaseTransaction(ctx) {}
+
+            TxType GetType() const override { return TxType::Simple; }
+            bool IsInSafety() const override { return true; }
+
+            void UpdateImpl() override
+            {
+                m_Updates++;
+                if (m_Complete)
+                {
+                    CompleteTx();
+                    return;
+                }
+
+                if (m_hWait)
+                    UpdateOnHeight(m_hWait);
+                if (m_NextTip)
+                    UpdateOnNextTip();
+            }
+        };
+
+        struct MyCreator
+            :public BaseTransaction::Creator
+        {
+            Height m_hWait = 0;
+            bool m_NextTip = false;
+            std::shared_ptr<MyTx> m_pLast;
+
+            BaseTransaction::Ptr Create(const BaseTransaction::TxContext& ctx) override
+            {
+                m_pLast = std::make_shared<MyTx>(ctx);
+                m_pLast->m_hWait = m_hWait;
+                m_pLast->m_NextTip = m_NextTip;
+                return m_pLast;
+            }
+        };
+
+        Wallet w(db, true);
+        auto pCreator = std::make_shared<MyCreator>();
+        w.RegisterTransactionType(TxType::Simple, pCreator);
+        proto::FlyClient& fc = w;
+
+        std::vector<Block::SystemState::Full> vStates;
+        auto addTip = [&]()
+        {
+            Block::SystemState::Full s;
+            ZeroObject(s);
+            if (!vStates.empty())
+            {
+                s = vStates.back();
+                s.get_Hash(s.m_Prev);
+            }
+            s.m_Height++;
+            s.m_TimeStamp = getTimestamp();
+
+            vStates.push_back(s);
+            db->get_History().AddStates(&s, 1);
+            fc.OnNewTip();
+        };
+
+        auto rollbackTo = [&](Height h)
+        {
+            vStates.resize(h);
+            db->get_History().DeleteFrom(h + 1);
+            fc.OnRolledBack();
+        };
+
+        while (vStates.size() < 10)
+            addTip();
+
+        // updated once at start, then sleeps until the height is reached
+        pCreator->m_hWait = 13;
+        w.StartTransaction(CreateTransactionParameters(TxType::Simple));
+        auto pTx = pCreator->m_pLast;
+        WALLET_CHECK(pTx->m_Updates == 1);
+
+        addTip();
+        addTip();
+        WALLET_CHECK(pTx->m_Updates == 1);
+
+        // the rollback doesn't wake it, the height must be reached again
+        rollbackTo(9);
+        WALLET_CHECK(pTx->m_Updates == 1);
+
+        while (vStates.size() < 12)
+            addTip();
+        WALLET_CHECK(pTx->m_Updates == 1);
+
+        pTx->m_hWait = 0;
+        addTip(); // 13
+        WALLET_CHECK(pTx->m_Updates == 2);
+
+        addTip(); // woken once only
+        WALLET_CHECK(pTx->m_Updates == 2);
+
+        // completes before the height is reached, the stale entry is dropped
+        pCreator->m_hWait = 16;
+        pCreator->m_NextTip = true;
+        TxID txID2 = w.StartTransaction(CreateTransactionParameters(TxType::Simple));
+        auto pTx2 = pCreator->m_pLast;
+        WALLET_CHECK(pTx2->m_Updates == 1);
+
+        pTx2->m_Complete = true;
+        addTip(); // 15
+        WALLET_CHECK(pTx2->m_Updates == 2);
+
+        wallet::TxStatus status = wallet::TxStatus::Pending;
+        WALLET_CHECK(storage::getTxParameter(*db, txID2, kDefaultSubTxID, TxParameterID::Status, status));
+        WALLET_CHECK(wallet::TxStatus::Completed == status);
+
+        addTip(); // 16
+        WALLET_CHECK(pTx2->m_Updates == 2);
+    }
+
     void TestTxExceptionHandling()
     {
         cout << "\nTesting exception processing by transaction ...\n";
@@ -2398,6 +3098,161 @@ void TestKeyKeeper(IPrivateKeyKeeper2::Ptr externalKeyKeeper = {}, size_t index
     WALLET_CHECK(tx.IsValid(ctx));
 }
 
+void TestKeyKeeperBatch()
+{
+    cout << "\nTesting key keeper batch methods...\n";
+
+    io::Reactor::Ptr mainReactor{ io::Reactor::create() };
+    io::Reactor::Scope scope(*mainReactor);
+
+    Key::IKdf::Ptr pKdf;
+    HKdf::Create(pKdf, 5323U);
+
+    auto pPool = std::make_shared<ExecutorMT>();
+    pPool->set_Threads(3);
+
+    auto pKk = std::make_shared<LocalPrivateKeyKeeperStd>(pKdf);
+    pKk->EnableParallel(pPool);
+
+    // payout: many outputs, their keys are aggregated in parallel
+    const uint32_t nOuts = 80;
+
+    IPrivateKeyKeeper2::Method::SignSplit mS;
+    auto initSplit = [&](IPrivateKeyKeeper2::Method::SignSplit& m)
+    {
+        m.m_pKernel.reset(new TxKernelStd);
+        m.m_pKernel->m_Fee = 100;
+        m.m_pKernel->m_Height.m_Min = Rules::get().pForks[1].m_Height + 19;
+        m.m_pKernel->m_Height.m_Max = m.m_pKernel->m_Height.m_Min + 700;
+        m.m_vInputs.push_back(CoinID(nOuts * 7 + 40, 11, Key::Type::Regular));
+        m.m_vInputs.push_back(CoinID(60, 12, Key::Type::Regular, 3));
+
+        for (uint32_t i = 0; i < nOuts; i++)
+            m.m_vOutputs.push_back(CoinID(7, 100 + i, Key::Type::Regular));
+    };
+
+    initSplit(mS);
+    WALLET_CHECK(IPrivateKeyKeeper2::Status::Success == pKk->InvokeSync(mS));
+
+    TxKernelStd::Ptr pKrn = std::move(mS.m_pKernel);
+    Height hScheme = pKrn->m_Height.m_Min;
+
+    // all the outputs in a single request
+    struct MyHandler
+        :public IPrivateKeyKeeper2::Handler
+    {
+        std::vector<IPrivateKeyKeeper2::Method::CreateOutput> m_vCalls;
+        IPrivateKeyKeeper2::Status::Type m_Status = IPrivateKeyKeeper2::Status::InProgress;
+        uint32_t m_Notifications = 0;
+        uint32_t m_ProgressDone = 0;
+        uint32_t m_ProgressCount = 0;
+        bool m_ProgressValid = true;
+
+        void OnDone(IPrivateKeyKeeper2::Status::Type n) override
+        {
+            m_Status = n;
+            m_Notifications++;
+            io::Reactor::get_Current().stop();
+        }
+
+        void OnProgress(uint32_t nDone, uint32_t nTotal) override
+        {
+            // increasing, before the completion
+            if (m_Notifications || (nDone <= m_ProgressDone) || (nDone >= nTotal) || (nTotal != m_vCalls.size()))
+                m_ProgressValid = false;
+
+            m_ProgressDone = nDone;
+            m_ProgressCount++;
+        }
+    };
+
+    auto pHandler = std::make_shared<MyHandler>();
+    pHandler->m_vCalls.resize(nOuts);
+    for (uint32_t i = 0; i < nOuts; i++)
+    {
+        pHandler->m_vCalls[i].m_hScheme = hScheme;
+        pHandler->m_vCalls[i].m_Cid = mS.m_vOutputs[i];
+    }
+
+    pKk->InvokeAsyncBatch(pHandler->m_vCalls, pHandler);
+    mainReactor->run();
+
+    WALLET_CHECK(IPrivateKeyKeeper2::Status::Success == pHandler->m_Status);
+    WALLET_CHECK(1 == pHandler->m_Notifications);
+    WALLET_CHECK(pHandler->m_ProgressValid);
+    WALLET_CHECK(pHandler->m_ProgressCount > 0);
+
+    {
+        // another keeper on the same pool, destroyed while its outputs are in progress.
+        // The queued jobs are aborted, the d'tor waits for the running ones, the handler is released without being invoked
+        auto pKk2 = std::make_shared<LocalPrivateKeyKeeperStd>(pKdf);
+        pKk2->EnableParallel(pPool);
+
+        auto pHandler2 = std::make_shared<MyHandler>();
+        pHandler2->m_vCalls.resize(nOuts);
+        for (uint32_t i = 0; i < nOuts; i++)
+        {
+            pHandler2->m_vCalls[i].m_hScheme = hScheme;
+            pHandler2->m_vCalls[i].m_Cid = mS.m_vOutputs[i];
+        }
+
+        pKk2->InvokeAsyncBatch(pHandler2->m_vCalls, pHandler2);
+
+        std::weak_ptr<MyHandler> pWeak = pHandler2;
+        pHandler2.reset();
+        pKk2.reset();
+
+        WALLET_CHECK(pWeak.expired());
+    }
+
+    Transaction tx;
+    for (const auto& cid : mS.m_vInputs)
+    {
+        Point::Native comm;
+        WALLET_CHECK(IPrivateKeyKeeper2::Status::Success == pKk->get_Commitment(comm, cid));
+
+        tx.m_vInputs.emplace_back();
+        tx.m_vInputs.back().reset(new Input);
+        tx.m_vInputs.back()->m_Commitment = comm;
+    }
+
+    for (auto& m : pHandler->m_vCalls)
+    {
+        WALLET_CHECK(m.m_pResult);
+        tx.m_vOutputs.push_back(std::move(m.m_pResult));
+    }
+
+    tx.m_vKernels.push_back(std::move(pKrn));
+    tx.m_Offset = mS.m_kOffset;
+    tx.Normalize();
+
+    Transaction::Context::Params pars;
+    Transaction::Context ctx(pars);
+    ctx.m_Height.m_Min = hScheme;
+    WALLET_CHECK(tx.IsValid(ctx));
+
+    // the same keys aggregated without the keeper pool: on the executor of the caller thread, and serially if there's none
+    for (uint32_t iPass = 0; iPass < 2; iPass++)
+    {
+        auto pKk2 = std::make_shared<LocalPrivateKeyKeeperStd>(pKdf);
+
+        std::unique_ptr<Executor::Scope> pScope;
+        if (!iPass)
+            pScope = std::make_unique<Executor::Scope>(*pPool);
+
+        IPrivateKeyKeeper2::Method::SignSplit mS2;
+        initSplit(mS2);
+        WALLET_CHECK(IPrivateKeyKeeper2::Status::Success == pKk2->InvokeSync(mS2));
+
+        tx.m_vKernels.front() = std::move(mS2.m_pKernel);
+        tx.m_Offset = mS2.m_kOffset;
+
+        Transaction::Context ctx2(pars);
+        ctx2.m_Height.m_Min = hScheme;
+        WALLET_CHECK(tx.IsValid(ctx2));
+    }
+}
+
 void TestVouchers()
 {
     cout << "\nTesting wallets vouchers exchange...\n";
@@ -2702,11 +3557,14 @@ int main()
     storage::HookErrors();
 
     TestKeyKeeper();
+    TestKeyKeeperBatch();
 
     TestVouchers();
 
 
     //TestBbsDecrypt();
+    TestBbsDecryptor();
+    TestBbsTimestamps();
 
     TestConvertions();
     TestTxParameters();
@@ -2738,6 +3596,10 @@ int main()
     TestExpiredTransaction();
     
     TestTransactionUpdate();
+    TestAsyncJobs();
+    TestAsyncTxVerification();
+    TestEventsSync();
+    TestHeightWakeUp();
     //TestTxPerformance();
     //TestTxNonces();
     
@@ -105,6 +105,7 @@ public:
     void removeCoins(const std::vector<Coin::ID>&) override {}
     void removeCoin(const Coin::ID&) override {}
     void visitCoins(std::function<bool(const Coin& coin)>) override {}
+    std::vector<Coin> getCoinsPage(const boost::optional<Asset::ID>&, const boost::optional<Coin::ID>&, size_t, int) const override { return {}; }
     void setVarRaw(const char*, const void*, size_t) override {}
     bool getVarRaw(const char*, void*, int) const override { return false; }
     bool getBlob(const char* name, ByteBuffer& var) const override { return false; }
@@ -116,6 +117,7 @@ public:
     void Unsubscribe(IWalletDbObserver* observer) override {}
 
     std::vector<TxDescription> getTxHistory(wallet::TxType, uint64_t, int) const override { return {}; };
+    std::vector<TxDescription> getTxHistoryPage(const TxHistoryFilter&, const boost::optional<TxID>&, size_t, int) const override { return {}; };
     boost::optional<TxDescription> getTx(const TxID&) const override { return boost::optional<TxDescription>{}; };
     void saveTx(const TxDescription& p) override
     {